@@ -1051,6 +1051,43 @@ enum node_states {
 #define SHOW_FEDERATION SLURM_BIT(6) /* Show federated state information.
 				      * Shows local info if not in federation */
 #define SHOW_FUTURE SLURM_BIT(7) /* Show future nodes */
+#define SHOW_DELTA SLURM_BIT(8) /* Show only jobs changed since update_time,
+				 * see slurm_merge_job_info_msg() */
+
+/*
+ * Used as fields for slurm_load_jobs_page(). Only the members of
+ * slurm_job_info_t listed with the set flags are loaded, job_id and step_id
+ * are always loaded. Values can be ORed, 0 loads all members.
+ */
+#define JOB_FIELD_STEP_ID SLURM_BIT(0) /* job_id, step_id */
+#define JOB_FIELD_ACCOUNT SLURM_BIT(1) /* account */
+#define JOB_FIELD_ARRAY SLURM_BIT(2) /* array_job_id, array_task_id,
+				      * array_max_tasks, array_task_str */
+#define JOB_FIELD_CLUSTER SLURM_BIT(3) /* cluster */
+#define JOB_FIELD_COMMENT SLURM_BIT(4) /* admin_comment, comment,
+					* system_comment */
+#define JOB_FIELD_CPUS SLURM_BIT(5) /* num_cpus, max_cpus */
+#define JOB_FIELD_EXIT_CODE SLURM_BIT(6) /* derived_ec, exit_code */
+#define JOB_FIELD_FLAGS SLURM_BIT(7) /* bitflags */
+#define JOB_FIELD_GROUP SLURM_BIT(8) /* group_id */
+#define JOB_FIELD_HET SLURM_BIT(9) /* het_job_id, het_job_id_set,
+				    * het_job_offset */
+#define JOB_FIELD_NAME SLURM_BIT(10) /* name */
+#define JOB_FIELD_NODES SLURM_BIT(11) /* nodes, sched_nodes, num_nodes,
+				       * max_nodes */
+#define JOB_FIELD_PARTITION SLURM_BIT(12) /* partition */
+#define JOB_FIELD_PRIORITY SLURM_BIT(13) /* priority */
+#define JOB_FIELD_QOS SLURM_BIT(14) /* qos */
+#define JOB_FIELD_RESV SLURM_BIT(15) /* resv_name */
+#define JOB_FIELD_STATE SLURM_BIT(16) /* job_state, state_desc,
+				       * state_reason */
+#define JOB_FIELD_STDIO SLURM_BIT(17) /* std_err, std_in, std_out */
+#define JOB_FIELD_TIME SLURM_BIT(18) /* submit_time, eligible_time,
+				      * start_time, end_time, suspend_time,
+				      * time_limit */
+#define JOB_FIELD_TRES SLURM_BIT(19) /* tres_alloc_str, tres_req_str */
+#define JOB_FIELD_USER SLURM_BIT(20) /* user_id, user_name */
+#define JOB_FIELD_WORK_DIR SLURM_BIT(21) /* command, work_dir */
 
 /*
  * SELECT_CPU, SELECT_SOCKET and SELECT_CORE are mutually exclusive
@@ -2084,6 +2121,12 @@ typedef struct job_info_msg {
 	time_t last_update;	/* time of latest info */
 	uint32_t record_count;	/* number of records */
 	slurm_job_info_t *job_array;	/* the job records */
+	bool delta;		/* job_array only holds jobs changed since the
+				 * requested update_time, see SHOW_DELTA */
+	uint32_t purged_cnt;	/* number of purged_job_ids */
+	uint32_t *purged_job_ids; /* jobs purged since the requested
+				   * update_time, only set if delta */
+	uint64_t fields;	/* JOB_FIELD_* loaded in job_array, 0 if all */
 } job_info_msg_t;
 
 typedef struct listjobs_info {
@@ -3438,6 +3481,23 @@ typedef struct stats_info_response_msg {
 	time_t   bf_when_last_cycle;
 	uint32_t bf_active;
 
+	uint32_t job_state_save_counter;
+	uint32_t job_state_save_last;
+	uint32_t job_state_save_max;
+	uint32_t job_state_save_lock_last;
+	uint32_t job_state_save_lock_max;
+
+	uint32_t lock_type_size;	/* 0 unless lock_stats is configured */
+	char **lock_type_name;
+	uint64_t *lock_read_cnt;
+	uint64_t *lock_read_wait_cnt;
+	uint64_t *lock_read_wait_time;
+	uint64_t *lock_read_wait_max;
+	uint64_t *lock_write_cnt;
+	uint64_t *lock_write_wait_cnt;
+	uint64_t *lock_write_wait_time;
+	uint64_t *lock_write_wait_max;
+
 	uint32_t rpc_type_size;
 	uint16_t *rpc_type_id;
 	uint32_t *rpc_type_cnt;
@@ -4283,7 +4343,8 @@ extern int slurm_load_job_user(job_info_msg_t **job_info_msg_pptr,
  *	information if changed since update_time
  * IN update_time - time of current configuration data
  * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
- * IN show_flags - job filtering options
+ * IN show_flags - job filtering options, with SHOW_DELTA only jobs changed
+ *	since update_time may be returned
  * RET 0 or -1 on error
  * NOTE: free the response using slurm_free_job_info_msg
  */
@@ -4291,6 +4352,38 @@ extern int slurm_load_jobs(time_t update_time,
 			   job_info_msg_t **job_info_msg_pptr,
 			   uint16_t show_flags);
 
+/*
+ * slurm_load_jobs_page - issue RPC to get a page of slurm job information
+ *	if changed since update_time
+ * IN update_time - time of current configuration data
+ * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
+ * IN show_flags - job filtering options
+ * IN after_job_id - only load jobs with a greater job id, pass the job id of
+ *	the last record of the previous page to load the next page
+ * IN max_jobs - load at most this many jobs, 0 for no limit. With a limit,
+ *	records are sorted by job id and fewer records than max_jobs means
+ *	there are no more pages.
+ * IN fields - JOB_FIELD_* members to load, 0 loads all members
+ * RET 0 or -1 on error
+ * NOTE: paging and fields are ignored on federated clusters unless
+ *	SHOW_LOCAL is set, all local jobs are loaded with all members
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_jobs_page(time_t update_time,
+				job_info_msg_t **job_info_msg_pptr,
+				uint16_t show_flags, uint32_t after_job_id,
+				uint32_t max_jobs, uint64_t fields);
+
+/*
+ * slurm_merge_job_info_msg - apply job information loaded with SHOW_DELTA to
+ *	the job information it was requested against
+ * IN/OUT job_info_msg - job information, its last_update was passed to
+ *	slurm_load_jobs() as update_time
+ * IN delta_msg - response from slurm_load_jobs() with SHOW_DELTA, freed here
+ */
+extern void slurm_merge_job_info_msg(job_info_msg_t *job_info_msg,
+				     job_info_msg_t *delta_msg);
+
 /*
  * slurm_load_job_state - issue RPC to get state of requested jobs
  * IN job_id_count - number of jobs in job_ids pointer.
@@ -223,6 +223,9 @@ enum cluster_fed_states {
 						    */
 #define JOBCOND_FLAG_SCRIPT           SLURM_BIT(8) /* Get batch script only */
 #define JOBCOND_FLAG_ENV              SLURM_BIT(9) /* Get job's env only */
+#define JOBCOND_FLAG_STREAM           SLURM_BIT(10) /* Return jobs in batches
+						     * as they are packed
+						     * (set internally) */
 
 /* Archive / Purge time flags */
 #define SLURMDB_PURGE_BASE    0x0000ffff   /* Apply to get the number
@@ -1872,6 +1875,16 @@ extern list_t *slurmdb_job_modify(void *db_conn,
  */
 extern list_t *slurmdb_jobs_get(void *db_conn, slurmdb_job_cond_t *job_cond);
 
+/*
+ * get info from the storage one job at a time instead of as a whole list
+ * IN func - called for each slurmdb_job_rec_t as it is received. The job is
+ *	freed once func returns. Return a negative value to stop.
+ * NOTE: jobs are given in storage order and are not sorted across clusters
+ * RET: SLURM_SUCCESS on success or error code
+ */
+extern int slurmdb_jobs_foreach(void *db_conn, slurmdb_job_cond_t *job_cond,
+				ListForF func, void *arg);
+
 /*
  * Fix runaway jobs
  * IN: jobs, a list of all the runaway jobs
@@ -69,6 +69,16 @@ extern list_t *slurmdb_jobs_get(void *db_conn, slurmdb_job_cond_t *job_cond)
 	return jobacct_storage_g_get_jobs_cond(db_conn, db_api_uid, job_cond);
 }
 
+extern int slurmdb_jobs_foreach(void *db_conn, slurmdb_job_cond_t *job_cond,
+				ListForF func, void *arg)
+{
+	if (db_api_uid == -1)
+		db_api_uid = getuid();
+
+	return jobacct_storage_g_foreach_job(db_conn, db_api_uid, job_cond,
+					     func, arg);
+}
+
 /*
  * Fix runaway jobs
  * IN: jobs, a list of all the runaway jobs
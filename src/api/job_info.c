@@ -453,6 +453,27 @@ extern int (slurm_job_batch_script)(FILE *out, slurm_step_id_t step_id)
 extern int
 slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 		 uint16_t show_flags)
+{
+	return slurm_load_jobs_page(update_time, job_info_msg_pptr, show_flags,
+				    0, 0, 0);
+}
+
+/*
+ * slurm_load_jobs_page - issue RPC to get a page of job configuration
+ *	information if changed since update_time
+ * IN update_time - time of current configuration data
+ * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
+ * IN show_flags - job filtering options
+ * IN after_job_id - only load jobs with a greater job id
+ * IN max_jobs - load at most this many jobs sorted by job id, 0 for all
+ * IN fields - JOB_FIELD_* members to load, 0 for all
+ * RET 0 or -1 on error
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_jobs_page(time_t update_time,
+				job_info_msg_t **job_info_msg_pptr,
+				uint16_t show_flags, uint32_t after_job_id,
+				uint32_t max_jobs, uint64_t fields)
 {
 	slurm_msg_t req_msg;
 	job_info_request_msg_t req;
@@ -471,7 +492,10 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	    cluster_in_federation(ptr, cluster_name)) {
 		/* In federation. Need full info from all clusters */
 		update_time = (time_t) 0;
-		show_flags &= (~SHOW_LOCAL);
+		show_flags &= (~(SHOW_LOCAL | SHOW_DELTA));
+		after_job_id = 0;
+		max_jobs = 0;
+		fields = 0;
 	} else {
 		/* Report local cluster info only */
 		show_flags |= SHOW_LOCAL;
@@ -482,7 +506,11 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	memset(&req, 0, sizeof(req));
 	req.last_update  = update_time;
 	req.show_flags   = show_flags;
+	req.after_job_id = after_job_id;
+	req.max_jobs     = max_jobs;
+	req.fields       = fields;
 	req_msg.msg_type = REQUEST_JOB_INFO;
+	req_msg.flags   |= SLURM_COMPACT_ENCODING;
 	req_msg.data     = &req;
 
 	if (show_flags & SHOW_FEDERATION) {
@@ -500,6 +528,76 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	return rc;
 }
 
+/*
+ * slurm_merge_job_info_msg - apply job information loaded with SHOW_DELTA to
+ *	the job information it was requested against
+ * IN/OUT job_info_msg - job information, its last_update was passed to
+ *	slurm_load_jobs() as update_time
+ * IN delta_msg - response from slurm_load_jobs() with SHOW_DELTA, freed here
+ */
+extern void slurm_merge_job_info_msg(job_info_msg_t *job_info_msg,
+				     job_info_msg_t *delta_msg)
+{
+	slurm_job_info_t *job_array;
+	uint32_t *job_ids, job_id_cnt, rec_cnt = 0;
+
+	xassert(job_info_msg);
+	xassert(delta_msg);
+
+	if (!delta_msg->delta) {
+		/* Full job information, replaces everything */
+		for (int i = 0; i < job_info_msg->record_count; i++)
+			slurm_free_job_info_members(
+				&job_info_msg->job_array[i]);
+		xfree(job_info_msg->job_array);
+		xfree(job_info_msg->purged_job_ids);
+		*job_info_msg = *delta_msg;
+		xfree(delta_msg);
+		return;
+	}
+
+	/* Jobs in delta_msg replace older records, purged jobs are removed */
+	job_id_cnt = delta_msg->record_count + delta_msg->purged_cnt;
+	job_ids = xcalloc((job_id_cnt + 1), sizeof(*job_ids));
+	for (int i = 0; i < delta_msg->record_count; i++)
+		job_ids[i] = delta_msg->job_array[i].step_id.job_id;
+	if (delta_msg->purged_cnt)
+		memcpy(job_ids + delta_msg->record_count,
+		       delta_msg->purged_job_ids,
+		       (delta_msg->purged_cnt * sizeof(*job_ids)));
+	qsort(job_ids, job_id_cnt, sizeof(*job_ids),
+	      slurm_sort_uint32_list_asc);
+
+	job_array = xcalloc((job_info_msg->record_count +
+			     delta_msg->record_count + 1),
+			    sizeof(*job_array));
+	for (int i = 0; i < job_info_msg->record_count; i++) {
+		slurm_job_info_t *job_ptr = &job_info_msg->job_array[i];
+
+		if (bsearch(&job_ptr->step_id.job_id, job_ids, job_id_cnt,
+			    sizeof(*job_ids), slurm_sort_uint32_list_asc))
+			slurm_free_job_info_members(job_ptr);
+		else
+			job_array[rec_cnt++] = *job_ptr;
+	}
+	if (delta_msg->record_count)
+		memcpy(job_array + rec_cnt, delta_msg->job_array,
+		       (delta_msg->record_count * sizeof(*job_array)));
+	rec_cnt += delta_msg->record_count;
+	xfree(job_ids);
+
+	xfree(job_info_msg->job_array);
+	job_info_msg->job_array = job_array;
+	job_info_msg->record_count = rec_cnt;
+	job_info_msg->last_update = delta_msg->last_update;
+	job_info_msg->last_backfill = delta_msg->last_backfill;
+
+	/* The records now belong to job_info_msg */
+	xfree(delta_msg->job_array);
+	delta_msg->record_count = 0;
+	slurm_free_job_info_msg(delta_msg);
+}
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -756,6 +756,7 @@ extern int slurm_load_node(time_t update_time, node_info_msg_t **resp,
 	req.last_update  = update_time;
 	req.show_flags   = show_flags;
 	req_msg.msg_type = REQUEST_NODE_INFO;
+	req_msg.flags   |= SLURM_COMPACT_ENCODING;
 	req_msg.data     = &req;
 
 	if ((show_flags & SHOW_FEDERATION) && ptr) { /* "ptr" check for CLANG */
@@ -788,6 +789,7 @@ extern int slurm_load_node2(time_t update_time, node_info_msg_t **resp,
 	req.last_update  = update_time;
 	req.show_flags   = show_flags;
 	req_msg.msg_type = REQUEST_NODE_INFO;
+	req_msg.flags   |= SLURM_COMPACT_ENCODING;
 	req_msg.data     = &req;
 
 	return _load_cluster_nodes(&req_msg, resp, cluster, show_flags);
@@ -47,6 +47,7 @@
 #include "src/common/slurmdbd_pack.h"
 #include "src/common/state_save.h"
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/gres.h"
@@ -54,14 +55,20 @@
 
 #include "src/slurmdbd/read_config.h"
 
-#define ASSOC_HASH_SIZE 1000
-#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % ASSOC_HASH_SIZE)
+#define ASSOC_HASH_SIZE 1000 /* minimum size, grows with the assoc count */
+#define ASSOC_HASH_LOAD 1 /* max assocs per bucket before growing */
+#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % assoc_hash_size)
 
 typedef struct {
 	char *req;
 	list_t *ret_list;
 } find_coord_t;
 
+typedef struct {
+	char *name; /* lower case qos name */
+	slurmdb_qos_rec_t *qos;
+} qos_name_t;
+
 typedef struct {
 	bool locked;
 	bool relative;
@@ -93,6 +100,10 @@ static pthread_mutex_t assoc_lock_init = PTHREAD_MUTEX_INITIALIZER;
 static assoc_init_args_t init_setup;
 static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
+static uint32_t assoc_hash_size = 0;
+static uint32_t assoc_hash_cnt = 0;
+static xhash_t *qos_hash_id = NULL;
+static xhash_t *qos_hash_name = NULL;
 static int *assoc_mgr_tres_old_pos = NULL;
 
 static bool _running_cache(void)
@@ -117,47 +128,37 @@ static int _get_str_inx(char *name)
 	return index;
 }
 
-static int _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
+static uint32_t _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
 {
-	int index;
+	uint32_t index;
 
 	xassert(assoc);
 
-	/* Multiply each character by its numerical position in the
-	 * name string to add a bit of entropy.
+	/*
+	 * Hash user associations by uid alone so all the associations of a
+	 * user (every account and partition) share a chain, which
+	 * assoc_mgr_get_user_assocs() walks instead of the whole list.
+	 * Users without a uid are hashed by name and account associations by
+	 * account, which _find_assoc_rec() matches case insensitive.
 	 */
-
-	index = assoc->uid;
+	if (assoc->uid != NO_VAL)
+		index = assoc->uid;
+	else if (assoc->user)
+		index = _get_str_inx(assoc->user);
+	else
+		index = _get_str_inx(assoc->acct);
 
 	/* only set on the slurmdbd */
 	if (slurmdbd_conf && assoc->cluster)
 		index += _get_str_inx(assoc->cluster);
 
-	if (assoc->acct)
-		index += _get_str_inx(assoc->acct);
-
-	if (assoc->partition)
-		index += _get_str_inx(assoc->partition);
-
-	index %= ASSOC_HASH_SIZE;
-	if (index < 0)
-		index += ASSOC_HASH_SIZE;
-
-	return index;
-
+	return index % assoc_hash_size;
 }
 
-static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
+static void _link_assoc_hash(slurmdb_assoc_rec_t *assoc)
 {
 	int inx = ASSOC_HASH_ID_INX(assoc->id);
 
-	if (!assoc_hash_id)
-		assoc_hash_id = xcalloc(ASSOC_HASH_SIZE,
-					sizeof(slurmdb_assoc_rec_t *));
-	if (!assoc_hash)
-		assoc_hash = xcalloc(ASSOC_HASH_SIZE,
-				     sizeof(slurmdb_assoc_rec_t *));
-
 	assoc->assoc_next_id = assoc_hash_id[inx];
 	assoc_hash_id[inx] = assoc;
 
@@ -166,6 +167,59 @@ static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
 	assoc_hash[inx] = assoc;
 }
 
+/* Size both hash tables for at least cnt associations, rehashing if needed */
+static void _resize_assoc_hash(uint32_t cnt)
+{
+	slurmdb_assoc_rec_t **old_hash_id = assoc_hash_id;
+	uint32_t old_size = assoc_hash_size;
+	uint32_t new_size = MAX(assoc_hash_size, ASSOC_HASH_SIZE);
+
+	while (cnt > (new_size * ASSOC_HASH_LOAD))
+		new_size *= 2;
+
+	if (assoc_hash_id && (new_size == assoc_hash_size))
+		return;
+
+	assoc_hash_size = new_size;
+	assoc_hash_id = xcalloc(assoc_hash_size, sizeof(*assoc_hash_id));
+	xfree(assoc_hash);
+	assoc_hash = xcalloc(assoc_hash_size, sizeof(*assoc_hash));
+
+	if (!old_hash_id)
+		return;
+
+	/* Every assoc is in both tables so walk the id one to rehash */
+	for (int i = 0; i < old_size; i++) {
+		slurmdb_assoc_rec_t *assoc = old_hash_id[i];
+
+		while (assoc) {
+			slurmdb_assoc_rec_t *next = assoc->assoc_next_id;
+
+			_link_assoc_hash(assoc);
+			assoc = next;
+		}
+	}
+	xfree(old_hash_id);
+
+	debug2("%s: %u associations in %u buckets",
+	       __func__, assoc_hash_cnt, assoc_hash_size);
+}
+
+static void _free_assoc_hash(void)
+{
+	xfree(assoc_hash_id);
+	xfree(assoc_hash);
+	assoc_hash_size = 0;
+	assoc_hash_cnt = 0;
+}
+
+static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
+{
+	_resize_assoc_hash(assoc_hash_cnt + 1);
+	_link_assoc_hash(assoc);
+	assoc_hash_cnt++;
+}
+
 static slurmdb_assoc_rec_t *_find_assoc_rec_id(uint32_t assoc_id,
 					       char *cluster_name)
 {
@@ -189,6 +243,113 @@ static slurmdb_assoc_rec_t *_find_assoc_rec_id(uint32_t assoc_id,
 	return NULL;
 }
 
+static void _qos_hash_id_func(void *item, const char **key,
+			      uint32_t *key_len)
+{
+	slurmdb_qos_rec_t *qos = item;
+
+	*key = (const char *) &qos->id;
+	*key_len = sizeof(qos->id);
+}
+
+static void _qos_hash_name_func(void *item, const char **key,
+				uint32_t *key_len)
+{
+	qos_name_t *qos_name = item;
+
+	*key = qos_name->name;
+	*key_len = strlen(qos_name->name);
+}
+
+static void _qos_name_free(void *item)
+{
+	qos_name_t *qos_name = item;
+
+	xfree(qos_name->name);
+	xfree(qos_name);
+}
+
+static void _add_qos_hash(slurmdb_qos_rec_t *qos)
+{
+	qos_name_t *qos_name;
+
+	if (!qos_hash_id) {
+		qos_hash_id = xhash_init(_qos_hash_id_func, NULL);
+		qos_hash_name = xhash_init(_qos_hash_name_func, _qos_name_free);
+	}
+
+	xhash_add(qos_hash_id, qos);
+
+	if (!qos->name)
+		return;
+
+	/* QOS names are matched case insensitive */
+	qos_name = xmalloc(sizeof(*qos_name));
+	qos_name->name = xstrdup(qos->name);
+	xstrtolower(qos_name->name);
+	qos_name->qos = qos;
+	xhash_add(qos_hash_name, qos_name);
+}
+
+static void _delete_qos_hash(slurmdb_qos_rec_t *qos)
+{
+	char *name;
+
+	if (!qos_hash_id)
+		return;
+
+	xhash_pop(qos_hash_id, (const char *) &qos->id, sizeof(qos->id));
+
+	if (!qos->name)
+		return;
+
+	name = xstrdup(qos->name);
+	xstrtolower(name);
+	xhash_delete_str(qos_hash_name, name);
+	xfree(name);
+}
+
+static int _for_each_add_qos_hash(void *x, void *arg)
+{
+	_add_qos_hash(x);
+
+	return 0;
+}
+
+static void _build_qos_hash(list_t *qos_list)
+{
+	xhash_clear(qos_hash_id);
+	xhash_clear(qos_hash_name);
+	(void) list_for_each(qos_list, _for_each_add_qos_hash, NULL);
+}
+
+/*
+ * Find a QOS in assoc_mgr_qos_list by id, or by name if that fails.
+ * NOTE: QOS read lock needs to be locked before calling this.
+ */
+static slurmdb_qos_rec_t *_find_qos_rec(uint32_t id, char *name)
+{
+	slurmdb_qos_rec_t *qos;
+	qos_name_t *qos_name;
+	char *lower;
+
+	if (!qos_hash_id)
+		return NULL;
+
+	if ((qos = xhash_get(qos_hash_id, (const char *) &id, sizeof(id))))
+		return qos;
+
+	if (!name)
+		return NULL;
+
+	lower = xstrdup(name);
+	xstrtolower(lower);
+	qos_name = xhash_get_str(qos_hash_name, lower);
+	xfree(lower);
+
+	return qos_name ? qos_name->qos : NULL;
+}
+
 static int _find_acct_by_name(void *x, void *y)
 {
 	slurmdb_coord_rec_t *acct = (slurmdb_coord_rec_t*) x;
@@ -286,10 +447,15 @@ static slurmdb_assoc_rec_t *_find_assoc_rec(
 			goto next;
 		}
 
-		if (assoc->partition
-		    && (!assoc_ptr->partition
-			|| xstrcasecmp(assoc->partition,
-				       assoc_ptr->partition))) {
+		/*
+		 * A user's partition associations share a hash chain with
+		 * the non-partition ones so don't let a missing partition
+		 * match them.
+		 */
+		if (assoc->partition ?
+		    (!assoc_ptr->partition ||
+		     xstrcasecmp(assoc->partition, assoc_ptr->partition)) :
+		    (assoc_ptr->partition != NULL)) {
 			debug3("%s: not the right partition", __func__);
 			goto next;
 		}
@@ -345,6 +511,8 @@ static void _delete_assoc_hash(slurmdb_assoc_rec_t *assoc)
 		return;	/* Fix CLANG false positive error */
 	} else
 		*assoc_pptr = assoc_ptr->assoc_next;
+
+	assoc_hash_cnt--;
 }
 
 
@@ -1140,8 +1308,8 @@ static int _post_assoc_list(void)
 	if (!assoc_mgr_assoc_list)
 		return SLURM_ERROR;
 
-	xfree(assoc_hash_id);
-	xfree(assoc_hash);
+	_free_assoc_hash();
+	_resize_assoc_hash(list_count(assoc_mgr_assoc_list));
 
 	itr = list_iterator_create(assoc_mgr_assoc_list);
 
@@ -1278,6 +1446,8 @@ static int _post_qos_list(list_t *qos_list)
 	}
 	list_iterator_destroy(itr);
 
+	_build_qos_hash(qos_list);
+
 	return SLURM_SUCCESS;
 }
 
@@ -2217,8 +2387,9 @@ extern int assoc_mgr_fini(bool save_state)
 	if (_running_cache())
 		*init_setup.running_cache = RUNNING_CACHE_STATE_NOTRUNNING;
 
-	xfree(assoc_hash_id);
-	xfree(assoc_hash);
+	_free_assoc_hash();
+	xhash_free(qos_hash_id);
+	xhash_free(qos_hash_name);
 
 	assoc_mgr_unlock(&locks);
 
@@ -2505,6 +2676,25 @@ extern void assoc_mgr_unlock(assoc_mgr_lock_t *locks)
 		slurm_rwlock_unlock(&assoc_mgr_locks[ASSOC_LOCK]);
 }
 
+static int _add_user_assoc(slurmdb_assoc_rec_t *assoc,
+			   slurmdb_assoc_rec_t *found_assoc,
+			   list_t *assoc_list)
+{
+	if (assoc->uid != found_assoc->uid) {
+		debug4("not the right user %u != %u",
+		       assoc->uid, found_assoc->uid);
+		return 0;
+	}
+	if (assoc->acct && xstrcmp(assoc->acct, found_assoc->acct)) {
+		debug4("not the right acct %s != %s",
+		       assoc->acct, found_assoc->acct);
+		return 0;
+	}
+
+	list_append(assoc_list, found_assoc);
+	return 1;
+}
+
 /* Since the returned assoc_list is full of pointers from the
  * assoc_mgr_assoc_list assoc_mgr_lock_t READ_LOCK on
  * assocs must be set before calling this function and while
@@ -2533,23 +2723,18 @@ extern int assoc_mgr_get_user_assocs(void *db_conn,
 
 	xassert(assoc_mgr_assoc_list);
 
-	itr = list_iterator_create(assoc_mgr_assoc_list);
-	while ((found_assoc = list_next(itr))) {
-		if (assoc->uid != found_assoc->uid) {
-			debug4("not the right user %u != %u",
-			       assoc->uid, found_assoc->uid);
-			continue;
-		}
-		if (assoc->acct && xstrcmp(assoc->acct, found_assoc->acct)) {
-			debug4("not the right acct %s != %s",
-			       assoc->acct, found_assoc->acct);
-			continue;
-		}
-
-		list_append(assoc_list, found_assoc);
-		set = 1;
+	if (!slurmdbd_conf) {
+		/* All of a user's associations share a hash chain */
+		found_assoc = assoc_hash ?
+			assoc_hash[_assoc_hash_index(assoc)] : NULL;
+		for (; found_assoc; found_assoc = found_assoc->assoc_next)
+			set |= _add_user_assoc(assoc, found_assoc, assoc_list);
+	} else {
+		itr = list_iterator_create(assoc_mgr_assoc_list);
+		while ((found_assoc = list_next(itr)))
+			set |= _add_user_assoc(assoc, found_assoc, assoc_list);
+		list_iterator_destroy(itr);
 	}
-	list_iterator_destroy(itr);
 
 	if (!set) {
 		if (assoc->acct)
@@ -2955,7 +3140,6 @@ extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 				 int enforce,
 				 slurmdb_qos_rec_t **qos_pptr, bool locked)
 {
-	list_itr_t *itr = NULL;
 	slurmdb_qos_rec_t * found_qos = NULL;
 	assoc_mgr_lock_t locks = { .qos = READ_LOCK };
 
@@ -2990,14 +3174,7 @@ extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 		return SLURM_SUCCESS;
 	}
 
-	itr = list_iterator_create(assoc_mgr_qos_list);
-	while ((found_qos = list_next(itr))) {
-		if (qos->id == found_qos->id)
-			break;
-		else if (qos->name && !xstrcasecmp(qos->name, found_qos->name))
-			break;
-	}
-	list_iterator_destroy(itr);
+	found_qos = _find_qos_rec(qos->id, qos->name);
 
 	if (!found_qos) {
 		if (!locked)
@@ -3730,10 +3907,7 @@ no_assocs:
 	/* now filter out the qos */
 	if (qos_itr) {
 		while ((tmp_char = list_next(qos_itr)))
-			if ((qos_rec = list_find_first(
-				     assoc_mgr_qos_list,
-				     slurmdb_find_qos_in_list_by_name,
-				     tmp_char)))
+			if ((qos_rec = _find_qos_rec(0, tmp_char)))
 				list_append(ret_list, qos_rec);
 		tmp_list = ret_list;
 	} else
@@ -4851,6 +5025,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 				assoc_mgr_set_qos_tres_cnt(object);
 
 			list_append(assoc_mgr_qos_list, object);
+			_add_qos_hash(object);
 /* 			char *tmp = get_qos_complete_str_bitstr( */
 /* 				assoc_mgr_qos_list, */
 /* 				object->preempt_bitstr); */
@@ -5152,6 +5327,8 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 			if (rec->priority == g_qos_max_priority)
 				redo_priority = 2;
 
+			_delete_qos_hash(rec);
+
 			if (init_setup.remove_qos_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
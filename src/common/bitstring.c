@@ -118,6 +118,470 @@
 	xassert((bit) <= 0x40000000); 	\
 } while (0)
 
+#ifdef HAVE___BUILTIN_POPCOUNTLL
+#define hweight __builtin_popcountll
+#else
+/*
+ * Returns the hamming weight (i.e. the number of bits set) in a word.
+ * NOTE: This routine borrowed from Linux 4.9 <tools/lib/hweight.c>.
+ */
+static uint64_t
+hweight(uint64_t w)
+{
+        w -= (w >> 1) & 0x5555555555555555ul;
+        w =  (w & 0x3333333333333333ul) + ((w >> 2) & 0x3333333333333333ul);
+        w =  (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0ful;
+        return (w * 0x0101010101010101ul) >> 56;
+}
+#endif
+
+/*
+ * Word kernels
+ *
+ * The operations used the most by the schedulers on node and core bitmaps are
+ * done by kernels working on arrays of whole words, the partial last word of
+ * a bitstring being handled by the callers. On x86_64 with GNU ifunc
+ * support, AVX-512, AVX2 and POPCNT versions of the kernels are built and
+ * the best one for the CPU is bound once by the dynamic loader. Elsewhere
+ * the portable versions are called directly.
+ */
+static void _and_words_scalar(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+{
+	for (int64_t i = 0; i < words; i++)
+		b1[i] &= b2[i];
+}
+
+static void _and_not_words_scalar(bitstr_t *b1, const bitstr_t *b2,
+				  int64_t words)
+{
+	for (int64_t i = 0; i < words; i++)
+		b1[i] &= ~b2[i];
+}
+
+static void _or_words_scalar(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+{
+	for (int64_t i = 0; i < words; i++)
+		b1[i] |= b2[i];
+}
+
+static int64_t _count_words_scalar(const bitstr_t *b, int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += hweight(b[i]);
+
+	return count;
+}
+
+static int64_t _and_count_words_scalar(const bitstr_t *b1, const bitstr_t *b2,
+				       int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += hweight(b1[i] & b2[i]);
+
+	return count;
+}
+
+static int64_t _and_not_count_words_scalar(const bitstr_t *b1,
+					   const bitstr_t *b2, int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += hweight(b1[i] & ~b2[i]);
+
+	return count;
+}
+
+static bool _and_any_words_scalar(const bitstr_t *b1, const bitstr_t *b2,
+				  int64_t words)
+{
+	for (int64_t i = 0; i < words; i++)
+		if (b1[i] & b2[i])
+			return true;
+
+	return false;
+}
+
+static bool _and_not_any_words_scalar(const bitstr_t *b1, const bitstr_t *b2,
+				      int64_t words)
+{
+	for (int64_t i = 0; i < words; i++)
+		if (b1[i] & ~b2[i])
+			return true;
+
+	return false;
+}
+
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__GNUC__)
+#include <immintrin.h>
+
+#define BITSTR_TARGET(_isa) __attribute__((target(_isa)))
+
+#define _LOAD256(_p) _mm256_loadu_si256((const __m256i *) (_p))
+#define _STORE256(_p, _v) _mm256_storeu_si256((__m256i *) (_p), (_v))
+
+BITSTR_TARGET("avx2")
+static void _and_words_avx2(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+{
+	int64_t i = 0;
+
+	for (; (i + 4) <= words; i += 4)
+		_STORE256(&b1[i], _mm256_and_si256(_LOAD256(&b1[i]),
+						   _LOAD256(&b2[i])));
+	for (; i < words; i++)
+		b1[i] &= b2[i];
+}
+
+BITSTR_TARGET("avx2")
+static void _and_not_words_avx2(bitstr_t *b1, const bitstr_t *b2,
+				int64_t words)
+{
+	int64_t i = 0;
+
+	/* _mm256_andnot_si256(a, b) is ~a & b */
+	for (; (i + 4) <= words; i += 4)
+		_STORE256(&b1[i], _mm256_andnot_si256(_LOAD256(&b2[i]),
+						      _LOAD256(&b1[i])));
+	for (; i < words; i++)
+		b1[i] &= ~b2[i];
+}
+
+BITSTR_TARGET("avx2")
+static void _or_words_avx2(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+{
+	int64_t i = 0;
+
+	for (; (i + 4) <= words; i += 4)
+		_STORE256(&b1[i], _mm256_or_si256(_LOAD256(&b1[i]),
+						  _LOAD256(&b2[i])));
+	for (; i < words; i++)
+		b1[i] |= b2[i];
+}
+
+/*
+ * Count the bits set in each 64 bit lane with a nibble lookup table, as AVX2
+ * has no vector popcount (W. Mula, "Faster population counts using AVX2").
+ */
+BITSTR_TARGET("avx2")
+static inline __m256i _popcount256(__m256i v)
+{
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+						1, 2, 2, 3, 2, 3, 3, 4,
+						0, 1, 1, 2, 1, 2, 2, 3,
+						1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low_mask = _mm256_set1_epi8(0x0f);
+	__m256i lo = _mm256_and_si256(v, low_mask);
+	__m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+	__m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+				      _mm256_shuffle_epi8(lookup, hi));
+
+	return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+BITSTR_TARGET("avx2")
+static inline int64_t _sum256(__m256i v)
+{
+	return (_mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) +
+		_mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3));
+}
+
+BITSTR_TARGET("avx2,popcnt")
+static int64_t _count_words_avx2(const bitstr_t *b, int64_t words)
+{
+	__m256i sum = _mm256_setzero_si256();
+	int64_t i = 0, count;
+
+	for (; (i + 4) <= words; i += 4)
+		sum = _mm256_add_epi64(sum, _popcount256(_LOAD256(&b[i])));
+	for (count = _sum256(sum); i < words; i++)
+		count += __builtin_popcountll(b[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("avx2,popcnt")
+static int64_t _and_count_words_avx2(const bitstr_t *b1, const bitstr_t *b2,
+				     int64_t words)
+{
+	__m256i sum = _mm256_setzero_si256();
+	int64_t i = 0, count;
+
+	for (; (i + 4) <= words; i += 4)
+		sum = _mm256_add_epi64(sum, _popcount256(_mm256_and_si256(
+					       _LOAD256(&b1[i]),
+					       _LOAD256(&b2[i]))));
+	for (count = _sum256(sum); i < words; i++)
+		count += __builtin_popcountll(b1[i] & b2[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("avx2,popcnt")
+static int64_t _and_not_count_words_avx2(const bitstr_t *b1,
+					 const bitstr_t *b2, int64_t words)
+{
+	__m256i sum = _mm256_setzero_si256();
+	int64_t i = 0, count;
+
+	for (; (i + 4) <= words; i += 4)
+		sum = _mm256_add_epi64(sum, _popcount256(_mm256_andnot_si256(
+					       _LOAD256(&b2[i]),
+					       _LOAD256(&b1[i]))));
+	for (count = _sum256(sum); i < words; i++)
+		count += __builtin_popcountll(b1[i] & ~b2[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("avx2")
+static bool _and_any_words_avx2(const bitstr_t *b1, const bitstr_t *b2,
+				int64_t words)
+{
+	int64_t i = 0;
+
+	/* _mm256_testz_si256() is 1 if a & b is all zero */
+	for (; (i + 4) <= words; i += 4)
+		if (!_mm256_testz_si256(_LOAD256(&b1[i]), _LOAD256(&b2[i])))
+			return true;
+	for (; i < words; i++)
+		if (b1[i] & b2[i])
+			return true;
+
+	return false;
+}
+
+BITSTR_TARGET("avx2")
+static bool _and_not_any_words_avx2(const bitstr_t *b1, const bitstr_t *b2,
+				    int64_t words)
+{
+	int64_t i = 0;
+
+	/* _mm256_testc_si256() is 1 if ~a & b is all zero */
+	for (; (i + 4) <= words; i += 4)
+		if (!_mm256_testc_si256(_LOAD256(&b2[i]), _LOAD256(&b1[i])))
+			return true;
+	for (; i < words; i++)
+		if (b1[i] & ~b2[i])
+			return true;
+
+	return false;
+}
+
+#define _LOAD512(_p) _mm512_loadu_si512((const void *) (_p))
+
+BITSTR_TARGET("avx512f,avx512vpopcntdq,popcnt")
+static int64_t _count_words_avx512(const bitstr_t *b, int64_t words)
+{
+	__m512i sum = _mm512_setzero_si512();
+	int64_t i = 0, count;
+
+	for (; (i + 8) <= words; i += 8)
+		sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(
+					       _LOAD512(&b[i])));
+	for (count = _mm512_reduce_add_epi64(sum); i < words; i++)
+		count += __builtin_popcountll(b[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("avx512f,avx512vpopcntdq,popcnt")
+static int64_t _and_count_words_avx512(const bitstr_t *b1, const bitstr_t *b2,
+				       int64_t words)
+{
+	__m512i sum = _mm512_setzero_si512();
+	int64_t i = 0, count;
+
+	for (; (i + 8) <= words; i += 8)
+		sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(
+					       _mm512_and_si512(
+						       _LOAD512(&b1[i]),
+						       _LOAD512(&b2[i]))));
+	for (count = _mm512_reduce_add_epi64(sum); i < words; i++)
+		count += __builtin_popcountll(b1[i] & b2[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("avx512f,avx512vpopcntdq,popcnt")
+static int64_t _and_not_count_words_avx512(const bitstr_t *b1,
+					   const bitstr_t *b2, int64_t words)
+{
+	__m512i sum = _mm512_setzero_si512();
+	int64_t i = 0, count;
+
+	for (; (i + 8) <= words; i += 8)
+		sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(
+					       _mm512_andnot_si512(
+						       _LOAD512(&b2[i]),
+						       _LOAD512(&b1[i]))));
+	for (count = _mm512_reduce_add_epi64(sum); i < words; i++)
+		count += __builtin_popcountll(b1[i] & ~b2[i]);
+
+	return count;
+}
+
+/* SSE4.2 era CPUs: the portable loops with the POPCNT instruction */
+BITSTR_TARGET("popcnt")
+static int64_t _count_words_popcnt(const bitstr_t *b, int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += __builtin_popcountll(b[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("popcnt")
+static int64_t _and_count_words_popcnt(const bitstr_t *b1, const bitstr_t *b2,
+				       int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += __builtin_popcountll(b1[i] & b2[i]);
+
+	return count;
+}
+
+BITSTR_TARGET("popcnt")
+static int64_t _and_not_count_words_popcnt(const bitstr_t *b1,
+					   const bitstr_t *b2, int64_t words)
+{
+	int64_t count = 0;
+
+	for (int64_t i = 0; i < words; i++)
+		count += __builtin_popcountll(b1[i] & ~b2[i]);
+
+	return count;
+}
+
+/*
+ * ifunc resolvers run while libslurm is being relocated, before any
+ * constructor, so they must initialize the cpu model data themselves.
+ */
+static bool _have_avx2(void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+static bool _have_avx512(void)
+{
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("avx512f") &&
+		__builtin_cpu_supports("avx512vpopcntdq"));
+}
+
+static bool _have_popcnt(void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("popcnt");
+}
+
+typedef void (*words_op_t)(bitstr_t *b1, const bitstr_t *b2, int64_t words);
+typedef int64_t (*words_count_t)(const bitstr_t *b, int64_t words);
+typedef int64_t (*words_op_count_t)(const bitstr_t *b1, const bitstr_t *b2,
+				    int64_t words);
+typedef bool (*words_any_t)(const bitstr_t *b1, const bitstr_t *b2,
+			    int64_t words);
+
+static words_op_t _and_words_resolve(void)
+{
+	return _have_avx2() ? _and_words_avx2 : _and_words_scalar;
+}
+
+static words_op_t _and_not_words_resolve(void)
+{
+	return _have_avx2() ? _and_not_words_avx2 : _and_not_words_scalar;
+}
+
+static words_op_t _or_words_resolve(void)
+{
+	return _have_avx2() ? _or_words_avx2 : _or_words_scalar;
+}
+
+static words_count_t _count_words_resolve(void)
+{
+	if (_have_avx512())
+		return _count_words_avx512;
+	if (_have_avx2() && _have_popcnt())
+		return _count_words_avx2;
+	if (_have_popcnt())
+		return _count_words_popcnt;
+	return _count_words_scalar;
+}
+
+static words_op_count_t _and_count_words_resolve(void)
+{
+	if (_have_avx512())
+		return _and_count_words_avx512;
+	if (_have_avx2() && _have_popcnt())
+		return _and_count_words_avx2;
+	if (_have_popcnt())
+		return _and_count_words_popcnt;
+	return _and_count_words_scalar;
+}
+
+static words_op_count_t _and_not_count_words_resolve(void)
+{
+	if (_have_avx512())
+		return _and_not_count_words_avx512;
+	if (_have_avx2() && _have_popcnt())
+		return _and_not_count_words_avx2;
+	if (_have_popcnt())
+		return _and_not_count_words_popcnt;
+	return _and_not_count_words_scalar;
+}
+
+static words_any_t _and_any_words_resolve(void)
+{
+	return _have_avx2() ? _and_any_words_avx2 : _and_any_words_scalar;
+}
+
+static words_any_t _and_not_any_words_resolve(void)
+{
+	return _have_avx2() ? _and_not_any_words_avx2 :
+			      _and_not_any_words_scalar;
+}
+
+#define BITSTR_IFUNC(_resolver) __attribute__((ifunc(#_resolver)))
+
+static void _and_words(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+	BITSTR_IFUNC(_and_words_resolve);
+static void _and_not_words(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+	BITSTR_IFUNC(_and_not_words_resolve);
+static void _or_words(bitstr_t *b1, const bitstr_t *b2, int64_t words)
+	BITSTR_IFUNC(_or_words_resolve);
+static int64_t _count_words(const bitstr_t *b, int64_t words)
+	BITSTR_IFUNC(_count_words_resolve);
+static int64_t _and_count_words(const bitstr_t *b1, const bitstr_t *b2,
+				int64_t words)
+	BITSTR_IFUNC(_and_count_words_resolve);
+static int64_t _and_not_count_words(const bitstr_t *b1, const bitstr_t *b2,
+				    int64_t words)
+	BITSTR_IFUNC(_and_not_count_words_resolve);
+static bool _and_any_words(const bitstr_t *b1, const bitstr_t *b2,
+			   int64_t words)
+	BITSTR_IFUNC(_and_any_words_resolve);
+static bool _and_not_any_words(const bitstr_t *b1, const bitstr_t *b2,
+			       int64_t words)
+	BITSTR_IFUNC(_and_not_any_words_resolve);
+#else
+#define _and_words		_and_words_scalar
+#define _and_not_words		_and_not_words_scalar
+#define _or_words		_or_words_scalar
+#define _count_words		_count_words_scalar
+#define _and_count_words	_and_count_words_scalar
+#define _and_not_count_words	_and_not_count_words_scalar
+#define _and_any_words		_and_any_words_scalar
+#define _and_not_any_words	_and_not_any_words_scalar
+#endif
+
 /*
  * Define slurm-specific aliases for use by plugins, see slurm_xlator.h
  * for details.
@@ -689,25 +1153,24 @@ bit_fill_gaps(bitstr_t *b)
 int
 bit_super_set(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitoff_t bit, bit_cnt;
+	int64_t words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += BITSTR_WORD_SIZE) {
-		if (b1[_bit_word(bit)] != (b1[_bit_word(bit)] &
-		                           b2[_bit_word(bit)])) {
-			bitstr_t mask;
-			if ((bit + BITSTR_WORD_SIZE) <= _bitstr_bits(b1))
-				return 0;
-			mask = _bit_nmask(_bitstr_bits(b1));
-			if ((b1[_bit_word(bit)] & mask) != (b1[_bit_word(bit)] &
-							    b2[_bit_word(bit)] &
-							    mask))
-				return 0;
-		}
+	bit_cnt = _bitstr_bits(b1);
+	words = bit_cnt >> BITSTR_SHIFT;
+	if (_and_not_any_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+			       words))
+		return 0;
 
+	bit = words << BITSTR_SHIFT;
+	if (bit < bit_cnt) {
+		uint64_t mask = _bit_nmask(bit_cnt);
+		if (b1[_bit_word(bit)] & ~b2[_bit_word(bit)] & mask)
+			return 0;
 	}
 
 	return 1;
@@ -759,9 +1222,9 @@ bit_and(bitstr_t *b1, bitstr_t *b2)
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] &= b2[_bit_word(bit)];
+	_and_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+		   bit_cnt >> BITSTR_SHIFT);
+	bit = (bit_cnt >> BITSTR_SHIFT) << BITSTR_SHIFT;
 
 	if (bit < bit_cnt) {
 		uint64_t mask = ~(_bit_nmask(bit_cnt));
@@ -782,9 +1245,9 @@ void bit_and_not(bitstr_t *b1, bitstr_t *b2)
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] &= ~b2[_bit_word(bit)];
+	_and_not_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+		       bit_cnt >> BITSTR_SHIFT);
+	bit = (bit_cnt >> BITSTR_SHIFT) << BITSTR_SHIFT;
 
 	if (bit < bit_cnt) {
 		uint64_t mask = _bit_nmask(bit_cnt);
@@ -821,9 +1284,9 @@ bit_or(bitstr_t *b1, bitstr_t *b2)
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] |= b2[_bit_word(bit)];
+	_or_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+		  bit_cnt >> BITSTR_SHIFT);
+	bit = (bit_cnt >> BITSTR_SHIFT) << BITSTR_SHIFT;
 
 	if (bit < bit_cnt) {
 		uint64_t mask = _bit_nmask(bit_cnt);
@@ -887,23 +1350,6 @@ bit_copybits(bitstr_t *dest, bitstr_t *src)
 	memcpy(&dest[BITSTR_OVERHEAD], &src[BITSTR_OVERHEAD], len);
 }
 
-#ifdef HAVE___BUILTIN_POPCOUNTLL
-#define hweight __builtin_popcountll
-#else
-/*
- * Returns the hamming weight (i.e. the number of bits set) in a word.
- * NOTE: This routine borrowed from Linux 4.9 <tools/lib/hweight.c>.
- */
-static uint64_t
-hweight(uint64_t w)
-{
-        w -= (w >> 1) & 0x5555555555555555ul;
-        w =  (w & 0x3333333333333333ul) + ((w >> 2) & 0x3333333333333333ul);
-        w =  (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0ful;
-        return (w * 0x0101010101010101ul) >> 56;
-}
-#endif
-
 /*
  * Count the number of bits set in bitstring.
  *   b (IN)		bitstring to check
@@ -912,16 +1358,14 @@ hweight(uint64_t w)
 int32_t
 bit_set_count(bitstr_t *b)
 {
-	int32_t count = 0;
+	int32_t count;
 	bitoff_t bit, bit_cnt;
 
 	_assert_bitstr_valid(b);
 
 	bit_cnt = _bitstr_bits(b);
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE) {
-		count += hweight(b[_bit_word(bit)]);
-	}
+	count = _count_words(&b[BITSTR_OVERHEAD], bit_cnt >> BITSTR_SHIFT);
+	bit = (bit_cnt >> BITSTR_SHIFT) << BITSTR_SHIFT;
 	if (bit < bit_cnt) {
 		uint64_t mask = _bit_nmask(bit_cnt);
 		count += hweight(b[_bit_word(bit)] & mask);
@@ -974,7 +1418,7 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 static int32_t _bit_overlap_internal(bitstr_t *b1, bitstr_t *b2, bool count_it)
 {
 	int32_t count = 0;
-	int64_t anded;
+	int64_t anded, words;
 	bitoff_t bit, bit_cnt;
 
 	_assert_bitstr_valid(b1);
@@ -982,16 +1426,15 @@ static int32_t _bit_overlap_internal(bitstr_t *b1, bitstr_t *b2, bool count_it)
 	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
 	bit_cnt = _bitstr_bits(b1);
-	for (bit = 0; bit < bit_cnt; bit += BITSTR_WORD_SIZE) {
-		if ((bit + BITSTR_WORD_SIZE - 1) >= bit_cnt)
-			break;
-		anded = b1[_bit_word(bit)] & b2[_bit_word(bit)];
-		if (count_it)
-			count += hweight(anded);
-		else if (anded)
-			return 1;
-	}
-
+	words = bit_cnt >> BITSTR_SHIFT;
+	if (count_it)
+		count = _and_count_words(&b1[BITSTR_OVERHEAD],
+					 &b2[BITSTR_OVERHEAD], words);
+	else if (_and_any_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+				words))
+		return 1;
+
+	bit = words << BITSTR_SHIFT;
 	if (bit < bit_cnt) {
 		uint64_t mask = _bit_nmask(bit_cnt);
 		anded = b1[_bit_word(bit)] & b2[_bit_word(bit)] & mask;
@@ -1021,6 +1464,40 @@ extern int32_t bit_overlap_any(bitstr_t *b1, bitstr_t *b2)
 	return _bit_overlap_internal(b1, b2, 0);
 }
 
+/*
+ * Count the bits set in b1 that are not set in b2, without building
+ * the b1 & ~b2 bitmap. Same result as bit_and_not() then bit_set_count(),
+ * bits of b1 beyond the size of b2 are counted.
+ *   b1 (IN)		first bitstring
+ *   b2 (IN)		second bitstring
+ *   RETURN		count of set bits
+ */
+extern int32_t bit_and_not_count(bitstr_t *b1, bitstr_t *b2)
+{
+	int32_t count;
+	int64_t words;
+	bitoff_t bit, bit_cnt;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+
+	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
+	words = bit_cnt >> BITSTR_SHIFT;
+	count = _and_not_count_words(&b1[BITSTR_OVERHEAD],
+				     &b2[BITSTR_OVERHEAD], words);
+
+	bit = words << BITSTR_SHIFT;
+	if (bit < bit_cnt) {
+		uint64_t mask = _bit_nmask(bit_cnt);
+		count += hweight(b1[_bit_word(bit)] & ~b2[_bit_word(bit)] &
+				 mask);
+	}
+	if (bit_cnt < _bitstr_bits(b1))
+		count += bit_set_count_range(b1, bit_cnt, _bitstr_bits(b1));
+
+	return count;
+}
+
 /*
  * Count the number of bits clear in bitstring.
  *   b (IN)		bitstring to check
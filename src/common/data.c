@@ -51,12 +51,28 @@
 #define DATA_MAGIC 0x1992189F
 #define DATA_LIST_MAGIC 0x1992F89F
 #define DATA_LIST_NODE_MAGIC 0x1921F89F
+#define DATA_ARENA_MAGIC 0x1A92F8AF
+/* data_t allocated from an arena */
+#define DATA_IN_ARENA_MAGIC 0x1992A89F
+
+/*
+ * Arena chunks are aligned to their own size to allow finding the arena of any
+ * data_t from its address.
+ */
+#define DATA_ARENA_CHUNK_BYTES (64 * 1024)
+/* Arena allocations larger than this get their own block */
+#define DATA_ARENA_LARGE_BYTES (DATA_ARENA_CHUNK_BYTES / 8)
+#define DATA_ARENA_ALIGN 16
+
+/* Index dictionaries holding at least this many keys */
+#define DATA_DICT_INDEX_MIN 16
 
 /* max chars PRId64 could printf(). strlen("-9223372036854775808") = 20 */
 #define INT64_CHAR_MAX 20
 
 typedef struct data_list_s data_list_t;
 typedef struct data_list_node_s data_list_node_t;
+typedef struct data_arena_block_s data_arena_block_t;
 
 typedef enum {
 	TYPE_NONE = 0, /* invalid or unknown type */
@@ -97,6 +113,7 @@ typedef struct data_list_node_s {
 
 	data_t *data;
 	char *key; /* key for dictionary (only) */
+	uint32_t hash; /* hash of key */
 } data_list_node_t;
 
 /* Single linked list for list_u and dict_u */
@@ -106,8 +123,30 @@ typedef struct data_list_s {
 
 	data_list_node_t *begin;
 	data_list_node_t *end;
+
+	/*
+	 * Open addressing hash of the nodes by key, for dictionaries once they
+	 * reach DATA_DICT_INDEX_MIN keys. The list keeps the insertion order.
+	 */
+	data_list_node_t **index;
+	size_t index_size; /* power of 2, at most half full */
+
+	data_arena_t *arena; /* arena holding list and nodes or NULL for heap */
 } data_list_t;
 
+/* Header of every arena chunk and oversized arena allocation */
+typedef struct data_arena_block_s {
+	data_arena_t *arena;
+	data_arena_block_t *next;
+} data_arena_block_t;
+
+struct data_arena_s {
+	int magic; /* DATA_ARENA_MAGIC */
+	data_arena_block_t *chunks; /* newest chunk first */
+	size_t offset; /* bytes used in newest chunk */
+	data_arena_block_t *large; /* oversized allocations */
+};
+
 /*
  * Data is based on the JSON data type and has the same types.
  * Data forms a tree structure.
@@ -179,12 +218,270 @@ typedef struct {
 static void _check_magic(const data_t *data);
 static void _release(data_t *data);
 static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn);
+static void _check_data_list_node_magic(const data_list_node_t *dn);
 static size_t _convert_tree(data_t *data, const type_t match);
 static char *_type_to_string(type_t type);
 
-static data_list_t *_data_list_new(void)
+/* Arena used by data_new() in this thread */
+static __thread data_arena_t *thread_arena = NULL;
+
+static void _check_arena_magic(const data_arena_t *arena)
+{
+	xassert(arena);
+	xassert(arena->magic == DATA_ARENA_MAGIC);
+}
+
+/* Allocate zeroed memory owned by arena */
+static void *_arena_alloc(data_arena_t *arena, size_t bytes)
+{
+	void *ptr;
+
+	_check_arena_magic(arena);
+
+	bytes = (bytes + DATA_ARENA_ALIGN - 1) & ~(DATA_ARENA_ALIGN - 1);
+
+	if (bytes > DATA_ARENA_LARGE_BYTES) {
+		data_arena_block_t *b = xmalloc(sizeof(*b) + bytes);
+
+		b->arena = arena;
+		b->next = arena->large;
+		arena->large = b;
+
+		return (b + 1);
+	}
+
+	if (!arena->chunks ||
+	    ((arena->offset + bytes) > DATA_ARENA_CHUNK_BYTES)) {
+		data_arena_block_t *c = NULL;
+		int rc;
+
+		if ((rc = posix_memalign((void **) &c, DATA_ARENA_CHUNK_BYTES,
+					 DATA_ARENA_CHUNK_BYTES)))
+			fatal("%s: unable to allocate arena chunk: %s",
+			      __func__, slurm_strerror(rc));
+
+		c->arena = arena;
+		c->next = arena->chunks;
+		arena->chunks = c;
+		arena->offset = sizeof(*c);
+
+		log_flag(DATA, "%s: new chunk(0x%"PRIxPTR") for arena(0x%"PRIxPTR")",
+			 __func__, (uintptr_t) c, (uintptr_t) arena);
+	}
+
+	ptr = ((char *) arena->chunks) + arena->offset;
+	arena->offset += bytes;
+
+	return memset(ptr, 0, bytes);
+}
+
+static char *_arena_strndup(data_arena_t *arena, const char *str,
+			    const size_t len)
+{
+	char *dst = _arena_alloc(arena, (len + 1));
+
+	memcpy(dst, str, len);
+
+	return dst;
+}
+
+/* Get arena owning data or NULL if data is on the heap */
+static data_arena_t *_data_arena(const data_t *data)
+{
+	const data_arena_block_t *c;
+
+	if (data->magic != DATA_IN_ARENA_MAGIC)
+		return NULL;
+
+	c = (const data_arena_block_t *)
+		((uintptr_t) data & ~((uintptr_t) DATA_ARENA_CHUNK_BYTES - 1));
+	_check_arena_magic(c->arena);
+
+	return c->arena;
+}
+
+extern data_arena_t *data_arena_new(void)
+{
+	data_arena_t *arena = xmalloc(sizeof(*arena));
+
+	arena->magic = DATA_ARENA_MAGIC;
+
+	log_flag(DATA, "%s: new arena(0x%"PRIxPTR")",
+		 __func__, (uintptr_t) arena);
+
+	return arena;
+}
+
+extern void data_arena_free(data_arena_t *arena)
+{
+	data_arena_block_t *b;
+	int chunks = 0;
+
+	if (!arena)
+		return;
+
+	_check_arena_magic(arena);
+	xassert(thread_arena != arena);
+
+	while ((b = arena->chunks)) {
+		arena->chunks = b->next;
+		free(b);
+		chunks++;
+	}
+
+	while ((b = arena->large)) {
+		arena->large = b->next;
+		xfree(b);
+	}
+
+	log_flag(DATA, "%s: free arena(0x%"PRIxPTR") with %d chunks",
+		 __func__, (uintptr_t) arena, chunks);
+
+	arena->magic = ~DATA_ARENA_MAGIC;
+	xfree(arena);
+}
+
+extern data_arena_t *data_arena_set(data_arena_t *arena)
+{
+	data_arena_t *prior = thread_arena;
+
+	if (arena)
+		_check_arena_magic(arena);
+
+	thread_arena = arena;
+
+	return prior;
+}
+
+static uint32_t _dict_key_hash(const char *key)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (; *key; key++) {
+		hash ^= (unsigned char) *key;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static void _dict_index_place(data_list_t *dl, data_list_node_t *dn)
+{
+	const size_t mask = dl->index_size - 1;
+	size_t i = dn->hash & mask;
+
+	while (dl->index[i])
+		i = (i + 1) & mask;
+
+	dl->index[i] = dn;
+}
+
+static void _dict_index_build(data_list_t *dl, size_t size)
+{
+	if (dl->arena) {
+		/* prior index is left to the arena */
+		dl->index = _arena_alloc(dl->arena, (size * sizeof(*dl->index)));
+	} else {
+		xfree(dl->index);
+		dl->index = xcalloc(size, sizeof(*dl->index));
+	}
+	dl->index_size = size;
+
+	for (data_list_node_t *i = dl->begin; i; i = i->next)
+		_dict_index_place(dl, i);
+
+	log_flag(DATA, "%s: indexed data-list(0x%"PRIxPTR")[%zu] with %zu slots",
+		 __func__, (uintptr_t) dl, dl->count, size);
+}
+
+/* Index a node just linked into dl */
+static void _dict_index_add(data_list_t *dl, data_list_node_t *dn)
+{
+	if (!dn->key)
+		return;
+
+	if (!dl->index) {
+		if (dl->count >= DATA_DICT_INDEX_MIN)
+			_dict_index_build(dl, (DATA_DICT_INDEX_MIN * 4));
+	} else if ((dl->count * 2) > dl->index_size) {
+		_dict_index_build(dl, (dl->index_size * 2));
+	} else {
+		_dict_index_place(dl, dn);
+	}
+}
+
+static void _dict_index_del(data_list_t *dl, data_list_node_t *dn)
+{
+	const size_t mask = dl->index_size - 1;
+	size_t i = dn->hash & mask, j;
+
+	while (dl->index[i] != dn) {
+		xassert(dl->index[i]);
+		i = (i + 1) & mask;
+	}
+
+	/* Shift back later entries of the probe sequence into the hole */
+	for (j = i; ; ) {
+		size_t k;
+
+		j = (j + 1) & mask;
+		if (!dl->index[j])
+			break;
+
+		k = dl->index[j]->hash & mask;
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+			continue;
+
+		dl->index[i] = dl->index[j];
+		i = j;
+	}
+
+	dl->index[i] = NULL;
+}
+
+static data_list_node_t *_dict_find(const data_list_t *dl, const char *key)
+{
+	data_list_node_t *i;
+
+	if (dl->index) {
+		const size_t mask = dl->index_size - 1;
+		const uint32_t hash = _dict_key_hash(key);
+		size_t slot = hash & mask;
+
+		while ((i = dl->index[slot])) {
+			_check_data_list_node_magic(i);
+
+			if ((i->hash == hash) && !xstrcmp(key, i->key))
+				return i;
+
+			slot = (slot + 1) & mask;
+		}
+
+		return NULL;
+	}
+
+	for (i = dl->begin; i; i = i->next) {
+		_check_data_list_node_magic(i);
+
+		if (!xstrcmp(key, i->key))
+			return i;
+	}
+
+	return NULL;
+}
+
+static data_list_t *_data_list_new(data_arena_t *arena)
 {
-	data_list_t *dl = xmalloc(sizeof(*dl));
+	data_list_t *dl;
+
+	if (arena) {
+		dl = _arena_alloc(arena, sizeof(*dl));
+		dl->arena = arena;
+	} else {
+		dl = xmalloc(sizeof(*dl));
+	}
+
 	dl->magic = DATA_LIST_MAGIC;
 
 	log_flag(DATA, "%s: new data-list(0x%"PRIxPTR")[%zu]",
@@ -259,8 +556,12 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 	log_flag(DATA, "%s: free data-list(0x%"PRIxPTR")[%zu]",
 		 __func__, (uintptr_t) dl, dl->count);
 
+	if (dl->index && dn->key)
+		_dict_index_del(dl, dn);
+
 	/* walk list to find new previous */
-	for (prev = dl->begin; prev && prev->next != dn; ) {
+	for (prev = (dn == dl->begin) ? NULL : dl->begin;
+	     prev && prev->next != dn; ) {
 		_check_data_list_node_magic(prev);
 		prev = prev->next;
 		if (prev)
@@ -294,10 +595,13 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 
 	dl->count--;
 	FREE_NULL_DATA(dn->data);
-	xfree(dn->key);
 
 	dn->magic = ~DATA_LIST_NODE_MAGIC;
-	xfree(dn);
+
+	if (!dl->arena) {
+		xfree(dn->key);
+		xfree(dn);
+	}
 }
 
 static void _release_data_list(data_list_t *dl)
@@ -334,24 +638,40 @@ static void _release_data_list(data_list_t *dl)
 
 finish:
 	dl->magic = ~DATA_LIST_MAGIC;
-	xfree(dl);
+
+	if (!dl->arena) {
+		xfree(dl->index);
+		xfree(dl);
+	}
 }
 
 /*
  * Create new data list node entry
+ * IN dl - list that will hold the node
  * IN d - data type to take ownership of
  * IN key - dictionary key to dup or NULL
  */
-static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
+static data_list_node_t *_new_data_list_node(data_list_t *dl, data_t *d,
+					     const char *key)
 {
-	data_list_node_t *dn = xmalloc(sizeof(*dn));
+	data_list_node_t *dn;
+
+	if (dl->arena)
+		dn = _arena_alloc(dl->arena, sizeof(*dn));
+	else
+		dn = xmalloc(sizeof(*dn));
+
 	dn->magic = DATA_LIST_NODE_MAGIC;
 
 	_check_magic(d);
 
 	dn->data = d;
 	if (key) {
-		dn->key = xstrdup(key);
+		if (dl->arena)
+			dn->key = _arena_strndup(dl->arena, key, strlen(key));
+		else
+			dn->key = xstrdup(key);
+		dn->hash = _dict_key_hash(key);
 
 		log_flag(DATA, "%s: new dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
 			 __func__, (uintptr_t) dn, dn->key, dn->data);
@@ -365,7 +685,7 @@ static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
 
 static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 {
-	data_list_node_t *n = _new_data_list_node(d, key);
+	data_list_node_t *n = _new_data_list_node(dl, d, key);
 	_check_data_list_magic(dl);
 	_check_magic(d);
 
@@ -383,6 +703,7 @@ static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_dict_index_add(dl, n);
 
 	if (n->key)
 		log_flag(DATA, "%s: append dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
@@ -394,7 +715,7 @@ static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 
 static void _data_list_prepend(data_list_t *dl, data_t *d, const char *key)
 {
-	data_list_node_t *n = _new_data_list_node(d, key);
+	data_list_node_t *n = _new_data_list_node(dl, d, key);
 	_check_data_list_magic(dl);
 	_check_magic(d);
 
@@ -409,15 +730,24 @@ static void _data_list_prepend(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_dict_index_add(dl, n);
 
 	log_flag(DATA, "%s: prepend %pD[%s]->data-list-node(0x%"PRIxPTR")[%s]=%pD",
 		 __func__, d, key, (uintptr_t) n, n->key, n->data);
 }
 
-extern data_t *data_new(void)
+static data_t *_data_new(data_arena_t *arena)
 {
-	data_t *data = xmalloc(sizeof(*data));
-	data->magic = DATA_MAGIC;
+	data_t *data;
+
+	if (arena) {
+		data = _arena_alloc(arena, sizeof(*data));
+		data->magic = DATA_IN_ARENA_MAGIC;
+	} else {
+		data = xmalloc(sizeof(*data));
+		data->magic = DATA_MAGIC;
+	}
+
 	data->type = TYPE_NULL;
 
 	log_flag(DATA, "%s: new %pD", __func__, data);
@@ -425,12 +755,18 @@ extern data_t *data_new(void)
 	return data;
 }
 
+extern data_t *data_new(void)
+{
+	return _data_new(thread_arena);
+}
+
 static void _check_magic(const data_t *data)
 {
 	if (!data)
 		return;
 
-	xassert(data->magic == DATA_MAGIC);
+	xassert((data->magic == DATA_MAGIC) ||
+		(data->magic == DATA_IN_ARENA_MAGIC));
 
 	if (slurm_conf.debug_flags & DEBUG_FLAG_DATA) {
 		xassert(data->type > TYPE_START);
@@ -447,6 +783,12 @@ static void _release(data_t *data)
 {
 	_check_magic(data);
 
+	/* arena memory is only released by data_arena_free() */
+	if (data->magic == DATA_IN_ARENA_MAGIC) {
+		data->type = TYPE_NONE;
+		return;
+	}
+
 	switch (data->type) {
 	case TYPE_LIST:
 		_release_data_list(data->data.list_u);
@@ -475,8 +817,14 @@ extern void data_free(data_t *data)
 	_check_magic(data);
 	_release(data);
 
-	data->magic = ~DATA_MAGIC;
 	data->type = TYPE_NONE;
+
+	if (data->magic == DATA_IN_ARENA_MAGIC) {
+		data->magic = ~DATA_IN_ARENA_MAGIC;
+		return;
+	}
+
+	data->magic = ~DATA_MAGIC;
 	xfree(data);
 }
 
@@ -574,6 +922,7 @@ static void _set_data_string_inline(data_t *data, const size_t len,
 
 extern data_t *data_set_string(data_t *data, const char *value)
 {
+	data_arena_t *arena;
 	int len;
 
 	_check_magic(data);
@@ -591,6 +940,9 @@ extern data_t *data_set_string(data_t *data, const char *value)
 
 	if ((len = strlen(value)) < sizeof(data->data.string_inline_u)) {
 		_set_data_string_inline(data, len, value);
+	} else if ((arena = _data_arena(data))) {
+		char *dval = _arena_strndup(arena, value, len);
+		_set_data_string_ptr(data, len, &dval);
 	} else {
 		char *dval = xstrdup(value);
 		_set_data_string_ptr(data, len, &dval);
@@ -601,6 +953,7 @@ extern data_t *data_set_string(data_t *data, const char *value)
 
 extern data_t *_data_set_string_own(data_t *data, char **value_ptr)
 {
+	data_arena_t *arena;
 	char *value;
 	int len;
 	_check_magic(data);
@@ -642,6 +995,10 @@ extern data_t *_data_set_string_own(data_t *data, char **value_ptr)
 		_set_data_string_inline(data, len, value);
 		/* we don't need to keep this string alloc */
 		xfree(value);
+	} else if ((arena = _data_arena(data))) {
+		char *dval = _arena_strndup(arena, value, len);
+		_set_data_string_ptr(data, len, &dval);
+		xfree(value);
 	} else {
 		_set_data_string_ptr(data, len, &value);
 	}
@@ -659,7 +1016,7 @@ extern data_t *data_set_dict(data_t *data)
 	_release(data);
 
 	data->type = TYPE_DICT;
-	data->data.dict_u = _data_list_new();
+	data->data.dict_u = _data_list_new(_data_arena(data));
 
 	log_flag(DATA, "%s: set %pD to dictionary", __func__, data);
 
@@ -675,7 +1032,7 @@ extern data_t *data_set_list(data_t *data)
 	_release(data);
 
 	data->type = TYPE_LIST;
-	data->data.list_u = _data_list_new();
+	data->data.list_u = _data_list_new(_data_arena(data));
 
 	log_flag(DATA, "%s: set %pD to list", __func__, data);
 
@@ -691,7 +1048,7 @@ extern data_t *data_list_append(data_t *data)
 	if (!data || data->type != TYPE_LIST)
 		return NULL;
 
-	ndata = data_new();
+	ndata = _data_new(data->data.list_u->arena);
 	_data_list_append(data->data.list_u, ndata, NULL);
 
 	log_flag(DATA, "%s: appended %pD[%zu]=%pD",
@@ -708,7 +1065,7 @@ extern data_t *data_list_prepend(data_t *data)
 	if (!data || data->type != TYPE_LIST)
 		return NULL;
 
-	ndata = data_new();
+	ndata = _data_new(data->data.list_u->arena);
 	_data_list_prepend(data->data.list_u, ndata, NULL);
 
 	log_flag(DATA, "%s: prepended %pD[%zu]=%pD",
@@ -798,31 +1155,15 @@ extern const data_t *data_key_get_const(const data_t *data, const char *key)
 		return NULL;
 
 	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
-
-	if (i)
+	if ((i = _dict_find(data->data.dict_u, key)))
 		return i->data;
 	else
 		return NULL;
 }
 
-static bool _match_string(const char *key, data_t *data, void *needle_ptr)
-{
-	const char *needle = needle_ptr;
-	return !xstrcmp(key, needle);
-}
-
 extern data_t *data_key_get(data_t *data, const char *key)
 {
-	return data_dict_find_first(data, _match_string, (void *) key);
+	return (data_t *) data_key_get_const(data, key);
 }
 
 extern data_t *data_key_get_int(data_t *data, int64_t key)
@@ -925,7 +1266,7 @@ extern data_t *data_key_set(data_t *data, const char *key)
 		return d;
 	}
 
-	d = data_new();
+	d = _data_new(data->data.dict_u->arena);
 	_data_list_append(data->data.dict_u, d, key);
 
 	log_flag(DATA, "%s: populate new key in %pD[%s]=%pD",
@@ -956,17 +1297,7 @@ extern bool data_key_unset(data_t *data, const char *key)
 		return NULL;
 
 	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
-
-	if (!i) {
+	if (!(i = _dict_find(data->data.dict_u, key))) {
 		log_flag(DATA, "%s: remove non-existent key in %pD[%s]",
 			 __func__, data, key);
 		return false;
@@ -2410,6 +2741,13 @@ extern data_t *data_move(data_t *dest, data_t *src)
 
 	log_flag(DATA, "%s: move data %pD to %pD", __func__, src, dest);
 
+	if (_data_arena(dest) != _data_arena(src)) {
+		/* contents of src belong to another allocator */
+		data_copy(dest, src);
+		data_set_null(src);
+		return dest;
+	}
+
 	memmove(&dest->data, &src->data, sizeof(src->data));
 	dest->type = src->type;
 	src->type = TYPE_NULL;
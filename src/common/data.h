@@ -188,6 +188,48 @@ extern void data_free(data_t *data);
 		_X = NULL;             \
 	} while (0)
 
+/*
+ * Arena for data_t trees
+ *
+ * While an arena is set for the calling thread, data_new() allocates new
+ * trees from that arena instead of the heap. Every node, list, key and string
+ * of such a tree is then carved from the arena too, no matter which thread
+ * modifies it afterwards. data_free() against any part of an arena tree is
+ * cheap and releases nothing. All of the trees are released at once by
+ * data_arena_free().
+ *
+ * Trees created from an arena must never be used after the arena is freed.
+ * Only set an arena around code that is known to free all of its data_t before
+ * the arena is released.
+ */
+typedef struct data_arena_s data_arena_t;
+
+/*
+ * Create new empty arena
+ * RET arena ptr (must be released by FREE_NULL_DATA_ARENA())
+ */
+extern data_arena_t *data_arena_new(void);
+
+/*
+ * Release arena and every data_t allocated from it
+ * IN arena - arena to free
+ */
+extern void data_arena_free(data_arena_t *arena);
+
+#define FREE_NULL_DATA_ARENA(_X)             \
+	do {                                 \
+		if (_X)                      \
+			data_arena_free(_X); \
+		_X = NULL;                   \
+	} while (0)
+
+/*
+ * Set arena used by data_new() in the calling thread
+ * IN arena - arena to allocate from or NULL to use the heap again
+ * RET arena previously set (to be restored by caller)
+ */
+extern data_arena_t *data_arena_set(data_arena_t *arena);
+
 /*
  * Get data type enum.
  * IN data structure to examine
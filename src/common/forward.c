@@ -66,20 +66,34 @@
 #include "src/interfaces/topology.h"
 
 #define HIGH_LOAD_FORWARD_THREAD_COUNT 256
+#define MAX_FORWARD_WORKER_COUNT 128
+
+typedef struct {
+	threadpool_func_t func;
+	void *arg;
+} fwd_work_t;
 
 static pthread_mutex_t global_forward_mutex = PTHREAD_MUTEX_INITIALIZER;
 static event_signal_t event_fini = EVENT_INITIALIZER("FWD-TREE-FINISH");
 static bool enabled = false;
+/* count of outstanding (queued or running) forwards */
 static int thread_count = 0;
+/* count of threads running _fwd_worker() */
+static int worker_count = 0;
+/* fwd_work_t list waiting for a free worker */
+static list_t *work_queue = NULL;
 
 static struct {
 	/* histogram of the latency from request to run */
 	latency_histogram_t request;
 	/* histogram of the time to run _forward_thread() */
 	latency_histogram_t run;
+	/* histogram of the time from sending to a child until its replies */
+	latency_histogram_t hop;
 } forward_stats = {
 	.request = LATENCY_HISTOGRAM_INITIALIZER,
 	.run = LATENCY_HISTOGRAM_INITIALIZER,
+	.hop = LATENCY_HISTOGRAM_INITIALIZER,
 };
 
 static slurm_node_alias_addrs_t *last_alias_addrs = NULL;
@@ -129,6 +143,55 @@ void _destroy_tree_fwd(fwd_tree_t *fwd_tree)
 	}
 }
 
+static void *_fwd_worker(void *arg)
+{
+	fwd_work_t *work = arg;
+
+	/* Keep running queued forwards until there are none left */
+	while (work) {
+		(void) work->func(work->arg);
+		xfree(work);
+
+		slurm_mutex_lock(&global_forward_mutex);
+		if (!work_queue || !(work = list_dequeue(work_queue)))
+			worker_count--;
+		slurm_mutex_unlock(&global_forward_mutex);
+	}
+
+	return NULL;
+}
+
+/*
+ * Run func(arg) on a forwarding worker thread. Only up to
+ * MAX_FORWARD_WORKER_COUNT threads are ever used at once and any further work
+ * is queued until a worker is free.
+ * NOTE: func is responsible for decrementing thread_count
+ */
+static void _queue_fwd_work(threadpool_func_t func, void *arg)
+{
+	fwd_work_t *work = xmalloc(sizeof(*work));
+
+	work->func = func;
+	work->arg = arg;
+
+	slurm_mutex_lock(&global_forward_mutex);
+	thread_count++;
+	xassert(thread_count > 0);
+
+	if (worker_count >= MAX_FORWARD_WORKER_COUNT) {
+		if (!work_queue)
+			work_queue = list_create(NULL);
+		list_enqueue(work_queue, work);
+		slurm_mutex_unlock(&global_forward_mutex);
+		return;
+	}
+
+	worker_count++;
+	slurm_mutex_unlock(&global_forward_mutex);
+
+	slurm_thread_create_detached(NULL, _fwd_worker, work);
+}
+
 static int _forward_get_addr(forward_struct_t *fwd_struct, char *name,
 			     slurm_addr_t *address)
 {
@@ -155,7 +218,7 @@ static void *_forward_thread(void *arg)
 	hostlist_t *hl = hostlist_create(fwd_ptr->nodelist);
 	slurm_addr_t addr;
 	char *buf = NULL;
-	timespec_t ts_start = timespec_now();
+	timespec_t ts_start = timespec_now(), ts_sent;
 
 	HISTOGRAM_ADD_DURATION(&forward_stats.request, fwd_msg->ts_requested);
 
@@ -238,6 +301,7 @@ static void *_forward_thread(void *arg)
 		/*
 		 * forward message
 		 */
+		ts_sent = timespec_now();
 		if (slurm_msg_sendto(conn, get_buf_data(buffer),
 				     get_buf_offset(buffer)) < 0) {
 			error("%s: slurm_msg_sendto: %m", __func__);
@@ -289,6 +353,7 @@ static void *_forward_thread(void *arg)
 
 		ret_list = slurm_receive_resp_msgs(conn, fwd_ptr->tree_depth,
 						   fwd_ptr->timeout);
+		HISTOGRAM_ADD_DURATION(&forward_stats.hop, ts_sent);
 		/* info("sent %d forwards got %d back", */
 		/*      fwd_ptr->cnt, list_count(ret_list)); */
 
@@ -443,6 +508,7 @@ static void *_fwd_tree_thread(void *arg)
 	char *name = NULL;
 	char *buf = NULL;
 	slurm_msg_t send_msg;
+	timespec_t ts_sent;
 
 	slurm_msg_t_init(&send_msg);
 	send_msg.msg_type = fwd_tree->orig_msg->msg_type;
@@ -487,8 +553,10 @@ static void *_fwd_tree_thread(void *arg)
 		} else
 			debug3("Tree sending to %s", name);
 
+		ts_sent = timespec_now();
 		ret_list = slurm_send_addr_recv_msgs(&send_msg, name,
 						     fwd_tree->timeout);
+		HISTOGRAM_ADD_DURATION(&forward_stats.hop, ts_sent);
 
 		xfree(send_msg.forward.nodelist);
 
@@ -618,12 +686,7 @@ static void _start_msg_tree_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		(*fwd_tree->p_thr_count)++;
 		slurm_mutex_unlock(fwd_tree->tree_mutex);
 
-		slurm_mutex_lock(&global_forward_mutex);
-		thread_count++;
-		xassert(thread_count > 0);
-		slurm_mutex_unlock(&global_forward_mutex);
-
-		slurm_thread_create_detached(NULL, _fwd_tree_thread, fwd_tree);
+		_queue_fwd_work(_fwd_tree_thread, fwd_tree);
 	}
 }
 
@@ -675,16 +738,11 @@ static void _forward_msg_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		fwd_msg->header.forward.tree_depth = header->forward.tree_depth;
 		fwd_msg->header.forward.timeout = header->forward.timeout;
 
-		slurm_mutex_lock(&global_forward_mutex);
-		thread_count++;
-		xassert(thread_count > 0);
-		slurm_mutex_unlock(&global_forward_mutex);
-
 		log_flag(NET, "%s: BEGIN: tree forwarding %s from %pA to %s",
 			 __func__, rpc_num2string(fwd_msg->header.msg_type),
 			 &fwd_msg->header.orig_addr, buf);
 
-		slurm_thread_create_detached(NULL, _forward_thread, fwd_msg);
+		_queue_fwd_work(_forward_thread, fwd_msg);
 	}
 }
 
@@ -1044,8 +1102,9 @@ static void _probe_verbose(probe_log_t *log)
 {
 	char histogram[LATENCY_METRIC_HISTOGRAM_STR_LEN] = { 0 };
 
-	probe_log(log, "state: enabled:%c thread_count:%d",
-		  BOOL_CHARIFY(enabled), thread_count);
+	probe_log(log, "state: enabled:%c thread_count:%d worker_count:%d queued:%d",
+		  BOOL_CHARIFY(enabled), thread_count, worker_count,
+		  (work_queue ? list_count(work_queue) : 0));
 
 	(void) latency_histogram_print_labels(histogram, sizeof(histogram));
 	probe_log(log, "histogram: %s", histogram);
@@ -1057,6 +1116,10 @@ static void _probe_verbose(probe_log_t *log)
 	(void) latency_histogram_print(&forward_stats.run, histogram,
 				       sizeof(histogram));
 	probe_log(log, "run histogram: %s", histogram);
+
+	(void) latency_histogram_print(&forward_stats.hop, histogram,
+				       sizeof(histogram));
+	probe_log(log, "hop histogram: %s", histogram);
 }
 
 static probe_status_t _probe(probe_log_t *log, void *arg)
@@ -1070,7 +1133,8 @@ static probe_status_t _probe(probe_log_t *log, void *arg)
 
 	if (!enabled)
 		status = PROBE_RC_ONLINE;
-	else if (thread_count >= HIGH_LOAD_FORWARD_THREAD_COUNT)
+	else if ((thread_count >= HIGH_LOAD_FORWARD_THREAD_COUNT) ||
+		 (work_queue && list_count(work_queue)))
 		status = PROBE_RC_BUSY;
 	else
 		status = PROBE_RC_READY;
@@ -1116,6 +1180,8 @@ extern void forward_fini(void)
 		EVENT_WAIT(&event_fini, &global_forward_mutex);
 	}
 
+	FREE_NULL_LIST(work_queue);
+
 	slurm_mutex_unlock(&global_forward_mutex);
 
 	END_TIMER2(__func__);
@@ -292,6 +292,7 @@ extern void job_record_delete(void *job_entry)
 	}
 	xfree(job_ptr->het_job_id_set);
 	FREE_NULL_LIST(job_ptr->het_job_list);
+	FREE_NULL_LIST(job_ptr->pack_cache);
 	xfree(job_ptr->partition);
 	FREE_NULL_LIST(job_ptr->part_ptr_list);
 	if (job_ptr->prio_mult) {
@@ -363,10 +363,7 @@ struct job_record {
 	void *hres_select; /* DON'T PACK. */
 	uint32_t job_id;		/* job ID */
 	identity_t *id;			/* job identity */
-	job_record_t *job_next;		/* next entry with same hash index */
 	job_record_t *job_array_next_j;	/* job array linked list by job_id */
-	job_record_t *job_array_next_t;	/* job array linked list by task_id */
-	job_record_t *job_next_sluid; /* next entry with same sluid hash */
 	job_record_t *job_preempt_comp; /* het job preempt component */
 	job_resources_t *job_resrcs;	/* details of allocated cores */
 	uint32_t job_state;		/* state of the job */
@@ -432,6 +429,9 @@ struct job_record {
 	 * job_record_t for accounting storage. NULL in live ctld jobs.
 	 */
 	char *oversubscribe;
+	list_t *pack_cache;		/* pack_job() output cached for
+					 * REQUEST_JOB_INFO, internal use only,
+					 * DON'T PACK */
 	char *partition;		/* name of job partition(s) */
 	list_t *part_ptr_list;		/* list of pointers to partition recs */
 	bool part_nodes_missing;	/* set if job's nodes removed from this
@@ -502,6 +502,11 @@ struct job_record {
 	time_t start_time;		/* time execution begins,
 					 * actual or expected */
 	char *state_desc;		/* optional details for state_reason */
+	uint64_t state_fingerprint;	/* hash of the record as last written
+					 * to the job_state journal, 0 if not
+					 * written since the last snapshot */
+	uint32_t state_save_pass;	/* job state save pass that last
+					 * packed this record */
 	uint32_t state_reason;		/* reason job still pending or failed
 					 * see slurm.h:enum job_state_reason */
 	uint32_t state_reason_prev_db;	/* Previous state_reason that isn't
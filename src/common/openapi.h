@@ -414,6 +414,9 @@ typedef struct {
 typedef struct {
 	time_t update_time;
 	uint16_t show_flags;
+	uint32_t cursor;
+	list_t *fields; /* list of char* */
+	uint32_t limit;
 } openapi_job_info_query_t;
 
 typedef struct {
@@ -109,6 +109,38 @@ strong_alias(unpackstr_array,	slurm_unpackstr_array);
 strong_alias(packmem_array,	slurm_packmem_array);
 strong_alias(unpackmem_array,	slurm_unpackmem_array);
 
+/* Largest packmem() size added to the string table of a compact buffer */
+#define STRTAB_MAX_LEN 256
+/* Most strings added to the string table of a compact buffer */
+#define STRTAB_MAX_CNT 65536
+
+/*
+ * The low bits of a compact packmem() header tell how to read it:
+ * PLAIN - size followed by data
+ * INTERN - size followed by data, added to the string table
+ * REF - index of string table entry
+ */
+#define STR_TAG_BITS 2
+#define STR_TAG_MASK 0x3
+#define STR_TAG_PLAIN 0
+#define STR_TAG_INTERN 1
+#define STR_TAG_REF 2
+
+/*
+ * Added to 16, 32 and 64 bit values packed in compact mode so the NO_VAL and
+ * INFINITE sentinels wrap around to the one byte encodings of 0 and 1.
+ */
+#define COMPACT_INT_ROTATE 2
+
+struct buf_strtab {
+	uint32_t *offset;	/* offset of each string in buffer head */
+	uint32_t *len;		/* size of each string */
+	uint32_t cnt;
+	uint32_t alloc;		/* entries in offset and len */
+	uint32_t *slots;	/* pack only: index + 1, 0 if empty */
+	uint32_t slot_cnt;	/* power of 2 */
+};
+
 /* Basic buffer management routines */
 /* create_buf - create a buffer with the supplied contents, contents must
  * be xalloc'ed */
@@ -129,6 +161,8 @@ buf_t *create_buf(char *data, uint32_t size)
 	my_buf->head = data;
 	my_buf->mmaped = false;
 	my_buf->shadow = false;
+	my_buf->compact = false;
+	my_buf->strtab = NULL;
 
 	return my_buf;
 }
@@ -187,6 +221,7 @@ void free_buf(buf_t *my_buf)
 	if (!my_buf)
 		return;
 	xassert(my_buf->magic == BUF_MAGIC);
+	buf_clear_compact(my_buf);
 	if (my_buf->mmaped)
 		munmap(my_buf->head, my_buf->size);
 	else if (!my_buf->shadow)
@@ -271,6 +306,8 @@ buf_t *init_buf(uint32_t size)
 	my_buf->head = xmalloc(size);
 	my_buf->mmaped = false;
 	my_buf->shadow = false;
+	my_buf->compact = false;
+	my_buf->strtab = NULL;
 	return my_buf;
 }
 
@@ -282,6 +319,8 @@ extern void assign_buf(buf_t *buf, char **data_ptr, uint32_t bytes)
 
 	xassert(buf->magic == BUF_MAGIC);
 
+	buf_clear_compact(buf);
+
 	if (buf->shadow) {
 		/* do nothing */
 	} else if (buf->mmaped) {
@@ -330,6 +369,8 @@ extern buf_t *try_init_buf(uint32_t size)
 	buf->processed = 0;
 	buf->mmaped = false;
 	buf->shadow = false;
+	buf->compact = false;
+	buf->strtab = NULL;
 	return buf;
 }
 
@@ -349,11 +390,258 @@ extern void *xfer_buf_data_ptr(buf_t **my_buf_ptr)
 	if (my_buf->shadow)
 		fatal_abort("attempt to xfer shadow buffer not supported");
 
+	buf_clear_compact(my_buf);
 	data_ptr = (void *) my_buf->head;
 	xfree(my_buf);
 	return data_ptr;
 }
 
+extern void buf_set_compact(buf_t *buffer, bool intern)
+{
+	xassert(buffer->magic == BUF_MAGIC);
+	xassert(!buffer->compact);
+
+	buffer->compact = true;
+	if (intern)
+		buffer->strtab = xmalloc(sizeof(*buffer->strtab));
+}
+
+extern void buf_clear_compact(buf_t *buffer)
+{
+	xassert(buffer->magic == BUF_MAGIC);
+
+	buffer->compact = false;
+	if (!buffer->strtab)
+		return;
+
+	xfree(buffer->strtab->offset);
+	xfree(buffer->strtab->len);
+	xfree(buffer->strtab->slots);
+	xfree(buffer->strtab);
+}
+
+/* FNV-1a */
+static uint32_t _strtab_hash(const char *data, uint32_t size)
+{
+	uint32_t hash = 2166136261U;
+
+	for (uint32_t i = 0; i < size; i++) {
+		hash ^= (uint8_t) data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Find the hash slot for data in a packing buffer's string table
+ * RET slot holding data or the empty slot where it belongs
+ */
+static uint32_t _strtab_slot(buf_t *buffer, const char *data, uint32_t size)
+{
+	buf_strtab_t *strtab = buffer->strtab;
+	uint32_t mask = strtab->slot_cnt - 1;
+	uint32_t slot = _strtab_hash(data, size) & mask;
+	uint32_t inx;
+
+	while ((inx = strtab->slots[slot])) {
+		inx--;
+		if ((strtab->len[inx] == size) &&
+		    !memcmp(&buffer->head[strtab->offset[inx]], data, size))
+			break;
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+/* Add the string at offset to the buffer's string table */
+static void _strtab_add(buf_t *buffer, uint32_t offset, uint32_t size)
+{
+	buf_strtab_t *strtab = buffer->strtab;
+
+	if (strtab->cnt >= strtab->alloc) {
+		strtab->alloc = strtab->alloc ? (strtab->alloc * 2) : 64;
+		xrecalloc(strtab->offset, strtab->alloc,
+			  sizeof(*strtab->offset));
+		xrecalloc(strtab->len, strtab->alloc, sizeof(*strtab->len));
+	}
+	strtab->offset[strtab->cnt] = offset;
+	strtab->len[strtab->cnt] = size;
+	strtab->cnt++;
+}
+
+/* Index the last string added to a packing buffer's string table */
+static void _strtab_index(buf_t *buffer)
+{
+	buf_strtab_t *strtab = buffer->strtab;
+	uint32_t inx = strtab->cnt - 1;
+
+	if ((strtab->cnt * 2) > strtab->slot_cnt) {
+		strtab->slot_cnt = strtab->slot_cnt ? (strtab->slot_cnt * 2) :
+						      256;
+		xfree(strtab->slots);
+		strtab->slots = xcalloc(strtab->slot_cnt,
+					sizeof(*strtab->slots));
+		for (uint32_t i = 0; i < inx; i++) {
+			uint32_t slot = _strtab_slot(
+				buffer, &buffer->head[strtab->offset[i]],
+				strtab->len[i]);
+			strtab->slots[slot] = i + 1;
+		}
+	}
+
+	strtab->slots[_strtab_slot(buffer, &buffer->head[strtab->offset[inx]],
+				   strtab->len[inx])] = inx + 1;
+}
+
+static void _pack_varint(uint64_t val, buf_t *buffer)
+{
+	uint8_t bytes[10];
+	int cnt = 0;
+
+	do {
+		bytes[cnt] = val & 0x7f;
+		val >>= 7;
+		if (val)
+			bytes[cnt] |= 0x80;
+		cnt++;
+	} while (val);
+
+	if (try_grow_buf_remaining(buffer, cnt))
+		return;
+
+	memcpy(&buffer->head[buffer->processed], bytes, cnt);
+	buffer->processed += cnt;
+}
+
+/*
+ * Unpack a variable length integer
+ * IN bits - reject values wider than this
+ */
+static int _unpack_varint(uint64_t *valp, int bits, buf_t *buffer)
+{
+	uint64_t val = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		uint8_t byte;
+
+		if (!remaining_buf(buffer))
+			return SLURM_ERROR;
+
+		byte = buffer->head[buffer->processed++];
+		val |= ((uint64_t) (byte & 0x7f)) << shift;
+		if (byte & 0x80)
+			continue;
+		if ((bits < 64) && (val >> bits))
+			return SLURM_ERROR;
+		*valp = val;
+		return SLURM_SUCCESS;
+	}
+
+	return SLURM_ERROR;
+}
+
+static void _packmem_compact(void *valp, uint32_t size_val, buf_t *buffer)
+{
+	buf_strtab_t *strtab = buffer->strtab;
+	uint64_t tag = STR_TAG_PLAIN;
+
+	if (strtab && size_val && (size_val <= STRTAB_MAX_LEN)) {
+		uint32_t inx = 0;
+
+		if (strtab->slot_cnt)
+			inx = strtab->slots[_strtab_slot(buffer, valp,
+							 size_val)];
+		if (inx) {
+			_pack_varint((((uint64_t) (inx - 1)) << STR_TAG_BITS) |
+				     STR_TAG_REF, buffer);
+			return;
+		}
+		if (strtab->cnt < STRTAB_MAX_CNT)
+			tag = STR_TAG_INTERN;
+	}
+
+	_pack_varint((((uint64_t) size_val) << STR_TAG_BITS) | tag, buffer);
+
+	if (!size_val || try_grow_buf_remaining(buffer, size_val))
+		return;
+
+	memcpy(&buffer->head[buffer->processed], valp, size_val);
+	if (tag == STR_TAG_INTERN) {
+		_strtab_add(buffer, buffer->processed, size_val);
+		_strtab_index(buffer);
+	}
+	buffer->processed += size_val;
+}
+
+/*
+ * Unpack the size of data packed with packmem() and skip over the data
+ * OUT offset - offset of data in buffer head, which may be before the size
+ *	when the data is a reference to an earlier copy
+ * OUT size_valp - size of data
+ */
+static int _unpackmem_hdr(uint32_t *offset, uint32_t *size_valp,
+			  buf_t *buffer)
+{
+	uint64_t hdr, tag = STR_TAG_PLAIN;
+
+	*offset = 0;
+	*size_valp = 0;
+
+	if (!buffer->compact) {
+		if (unpack32(size_valp, buffer))
+			return SLURM_ERROR;
+	} else {
+		if (_unpack_varint(&hdr, 64, buffer))
+			return SLURM_ERROR;
+		tag = hdr & STR_TAG_MASK;
+		hdr >>= STR_TAG_BITS;
+
+		if (tag == STR_TAG_REF) {
+			if (!buffer->strtab || (hdr >= buffer->strtab->cnt))
+				return SLURM_ERROR;
+			*offset = buffer->strtab->offset[hdr];
+			*size_valp = buffer->strtab->len[hdr];
+			return SLURM_SUCCESS;
+		} else if ((tag != STR_TAG_PLAIN) && (tag != STR_TAG_INTERN)) {
+			return SLURM_ERROR;
+		}
+
+		if (hdr > MAX_PACK_MEM_LEN)
+			hdr = ((uint64_t) MAX_PACK_MEM_LEN) + 1;
+		*size_valp = hdr;
+	}
+
+	if (!*size_valp)
+		return SLURM_SUCCESS;
+
+	if (*size_valp > MAX_PACK_MEM_LEN) {
+		error("%s: Buffer to be unpacked is too large (%u > %u)",
+		      __func__, *size_valp, MAX_PACK_MEM_LEN);
+		goto unpack_error;
+	}
+
+	if (remaining_buf(buffer) < *size_valp)
+		goto unpack_error;
+
+	if (tag == STR_TAG_INTERN) {
+		if (!buffer->strtab || (*size_valp > STRTAB_MAX_LEN) ||
+		    (buffer->strtab->cnt >= STRTAB_MAX_CNT))
+			goto unpack_error;
+		_strtab_add(buffer, buffer->processed, *size_valp);
+	}
+
+	*offset = buffer->processed;
+	buffer->processed += *size_valp;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	*size_valp = 0;
+	return SLURM_ERROR;
+}
+
 /*
  * Given a time_t in host byte order, promote it to int64_t, convert to
  * network byte order, store in buffer and adjust buffer acc'd'ngly
@@ -362,6 +650,13 @@ void pack_time(time_t val, buf_t *buffer)
 {
 	int64_t n64 = HTON_int64((int64_t) val);
 
+	if (buffer->compact) {
+		/* zigzag so small negative values stay short */
+		_pack_varint((((uint64_t) val) << 1) ^
+			     ((uint64_t) (((int64_t) val) >> 63)), buffer);
+		return;
+	}
+
 	if (try_grow_buf_remaining(buffer, sizeof(n64)))
 		return;
 
@@ -373,6 +668,15 @@ int unpack_time(time_t *valp, buf_t *buffer)
 {
 	int64_t n64;
 
+	if (buffer->compact) {
+		uint64_t val;
+
+		if (_unpack_varint(&val, 64, buffer))
+			return SLURM_ERROR;
+		*valp = (time_t) (((int64_t) (val >> 1)) ^ -((int64_t) (val & 1)));
+		return SLURM_SUCCESS;
+	}
+
 	if (remaining_buf(buffer) < sizeof(n64))
 		return SLURM_ERROR;
 
@@ -532,6 +836,11 @@ void pack64(uint64_t val, buf_t *buffer)
 {
 	uint64_t nl =  HTON_uint64(val);
 
+	if (buffer->compact) {
+		_pack_varint((uint64_t) (val + COMPACT_INT_ROTATE), buffer);
+		return;
+	}
+
 	if (try_grow_buf_remaining(buffer, sizeof(nl)))
 		return;
 
@@ -546,6 +855,16 @@ void pack64(uint64_t val, buf_t *buffer)
 int unpack64(uint64_t *valp, buf_t *buffer)
 {
 	uint64_t nl;
+
+	if (buffer->compact) {
+		uint64_t val;
+
+		if (_unpack_varint(&val, 64, buffer))
+			return SLURM_ERROR;
+		*valp = (uint64_t) (val - COMPACT_INT_ROTATE);
+		return SLURM_SUCCESS;
+	}
+
 	if (remaining_buf(buffer) < sizeof(nl))
 		return SLURM_ERROR;
 
@@ -563,6 +882,11 @@ void pack32(uint32_t val, buf_t *buffer)
 {
 	uint32_t nl = htonl(val);
 
+	if (buffer->compact) {
+		_pack_varint((uint32_t) (val + COMPACT_INT_ROTATE), buffer);
+		return;
+	}
+
 	if (try_grow_buf_remaining(buffer, sizeof(nl)))
 		return;
 
@@ -577,6 +901,16 @@ void pack32(uint32_t val, buf_t *buffer)
 int unpack32(uint32_t *valp, buf_t *buffer)
 {
 	uint32_t nl;
+
+	if (buffer->compact) {
+		uint64_t val;
+
+		if (_unpack_varint(&val, 32, buffer))
+			return SLURM_ERROR;
+		*valp = (uint32_t) (val - COMPACT_INT_ROTATE);
+		return SLURM_SUCCESS;
+	}
+
 	if (remaining_buf(buffer) < sizeof(nl))
 		return SLURM_ERROR;
 
@@ -749,6 +1083,11 @@ void pack16(uint16_t val, buf_t *buffer)
 {
 	uint16_t ns = htons(val);
 
+	if (buffer->compact) {
+		_pack_varint((uint16_t) (val + COMPACT_INT_ROTATE), buffer);
+		return;
+	}
+
 	if (try_grow_buf_remaining(buffer, sizeof(ns)))
 		return;
 
@@ -764,6 +1103,15 @@ int unpack16(uint16_t *valp, buf_t *buffer)
 {
 	uint16_t ns;
 
+	if (buffer->compact) {
+		uint64_t val;
+
+		if (_unpack_varint(&val, 16, buffer))
+			return SLURM_ERROR;
+		*valp = (uint16_t) (val - COMPACT_INT_ROTATE);
+		return SLURM_SUCCESS;
+	}
+
 	if (remaining_buf(buffer) < sizeof(ns))
 		return SLURM_ERROR;
 
@@ -862,6 +1210,11 @@ extern void packmem(void *valp, uint32_t size_val, buf_t *buffer)
 		return;
 	}
 
+	if (buffer->compact) {
+		_packmem_compact(valp, size_val, buffer);
+		return;
+	}
+
 	if (try_grow_buf_remaining(buffer, (sizeof(ns) + size_val)))
 		return;
 
@@ -885,29 +1238,16 @@ extern void packmem(void *valp, uint32_t size_val, buf_t *buffer)
  */
 int unpackmem_ptr(char **valp, uint32_t *size_valp, buf_t *buffer)
 {
-	*valp = NULL;
-	safe_unpack32(size_valp, buffer);
+	uint32_t offset;
 
-	if (!*size_valp)
-		return SLURM_SUCCESS;
-
-	if (*size_valp > MAX_PACK_MEM_LEN) {
-		error("%s: Buffer to be unpacked is too large (%u > %u)",
-		      __func__, *size_valp, MAX_PACK_MEM_LEN);
-		goto unpack_error;
-	}
-
-	if (remaining_buf(buffer) < *size_valp)
-		goto unpack_error;
+	*valp = NULL;
+	if (_unpackmem_hdr(&offset, size_valp, buffer))
+		return SLURM_ERROR;
 
-	*valp = &buffer->head[buffer->processed];
-	buffer->processed += *size_valp;
+	if (*size_valp)
+		*valp = &buffer->head[offset];
 
 	return SLURM_SUCCESS;
-
-unpack_error:
-	*size_valp = 0;
-	return SLURM_ERROR;
 }
 
 /*
@@ -921,24 +1261,17 @@ unpack_error:
  */
 int unpackmem_xmalloc(char **valp, uint32_t *size_valp, buf_t *buffer)
 {
+	uint32_t offset;
+
 	*valp = NULL;
-	safe_unpack32(size_valp, buffer);
+	if (_unpackmem_hdr(&offset, size_valp, buffer))
+		return SLURM_ERROR;
 
 	if (!*size_valp)
 		return SLURM_SUCCESS;
 
-	if (*size_valp > MAX_PACK_MEM_LEN) {
-		error("%s: Buffer to be unpacked is too large (%u > %u)",
-		      __func__, *size_valp, MAX_PACK_MEM_LEN);
-		goto unpack_error;
-	}
-
-	if (remaining_buf(buffer) < *size_valp)
-		goto unpack_error;
-
 	safe_xmalloc(*valp, *size_valp);
-	memcpy(*valp, &buffer->head[buffer->processed], *size_valp);
-	buffer->processed += *size_valp;
+	memcpy(*valp, &buffer->head[offset], *size_valp);
 
 	return SLURM_SUCCESS;
 
@@ -958,25 +1291,19 @@ unpack_error:
  */
 int unpackstr_xmalloc(char **valp, uint32_t *size_valp, buf_t *buffer)
 {
+	uint32_t offset;
+
 	*valp = NULL;
-	safe_unpack32(size_valp, buffer);
+	if (_unpackmem_hdr(&offset, size_valp, buffer))
+		return SLURM_ERROR;
 
 	if (!*size_valp)
 		return SLURM_SUCCESS;
 
-	if (*size_valp > MAX_PACK_MEM_LEN) {
-		error("%s: Buffer to be unpacked is too large (%u > %u)",
-		      __func__, *size_valp, MAX_PACK_MEM_LEN);
-		goto unpack_error;
-	}
-
-	if (remaining_buf(buffer) < *size_valp)
-		goto unpack_error;
-	if (buffer->head[buffer->processed + *size_valp - 1] != '\0')
+	if (buffer->head[offset + *size_valp - 1] != '\0')
 		goto unpack_error;
 	safe_xmalloc(*valp, *size_valp);
-	memcpy(*valp, &buffer->head[buffer->processed], *size_valp);
-	buffer->processed += *size_valp;
+	memcpy(*valp, &buffer->head[offset], *size_valp);
 
 	return SLURM_SUCCESS;
 
@@ -1001,30 +1328,22 @@ unpack_error:
  */
 int unpackstr_xmalloc_escaped(char **valp, uint32_t *size_valp, buf_t *buffer)
 {
-	uint32_t cnt;
+	uint32_t cnt, offset;
 	char *copy = NULL, *str, tmp;
 
 	*valp = NULL;
-	safe_unpack32(size_valp, buffer);
+	if (_unpackmem_hdr(&offset, size_valp, buffer))
+		return SLURM_ERROR;
 
 	if (!*size_valp)
 		return SLURM_SUCCESS;
 
-	if (*size_valp > MAX_PACK_MEM_LEN) {
-		error("%s: Buffer to be unpacked is too large (%u > %u)",
-		      __func__, *size_valp, MAX_PACK_MEM_LEN);
-		return SLURM_ERROR;
-	}
-
 	cnt = *size_valp;
 
-	if (remaining_buf(buffer) < cnt)
-		return SLURM_ERROR;
-
 	/* make a buffer 2 times the size just to be safe */
 	safe_xmalloc(*valp, (cnt * 2) + 1);
 	copy = *valp;
-	str = &buffer->head[buffer->processed];
+	str = &buffer->head[offset];
 
 	for (uint32_t i = 0; i < cnt && *str; i++) {
 		tmp = *str++;
@@ -1036,9 +1355,6 @@ int unpackstr_xmalloc_escaped(char **valp, uint32_t *size_valp, buf_t *buffer)
 		*copy++ = tmp;
 	}
 
-	/* add the original value since that is what we processed */
-	buffer->processed += cnt;
-
 	return SLURM_SUCCESS;
 
 unpack_error:
@@ -1079,13 +1395,8 @@ unpack_error:
 void packstr_array(char **valp, uint32_t size_val, buf_t *buffer)
 {
 	int i;
-	uint32_t ns = htonl(size_val);
 
-	if (try_grow_buf_remaining(buffer, sizeof(ns)))
-		return;
-
-	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
-	buffer->processed += sizeof(ns);
+	pack32(size_val, buffer);
 
 	for (i = 0; i < size_val; i++) {
 		packstr(valp[i], buffer);
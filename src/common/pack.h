@@ -65,6 +65,8 @@
  * allocation error due to array or buffer sizes that are unreasonably large */
 #define MAX_PACK_MEM_LEN	(1024 * 1024 * 1024)
 
+typedef struct buf_strtab buf_strtab_t;
+
 typedef struct {
 	uint32_t magic;
 	char *head;
@@ -72,6 +74,8 @@ typedef struct {
 	uint32_t processed;
 	bool mmaped;
 	bool shadow;
+	bool compact;		/* see buf_set_compact() */
+	buf_strtab_t *strtab;	/* strings interned while compact */
 } buf_t;
 
 #define get_buf_data(__buf)		(__buf->head)
@@ -147,6 +151,23 @@ extern void *xfer_buf_data_ptr(buf_t **my_buf_ptr);
  */
 #define xfer_buf_data(my_buf) xfer_buf_data_ptr(&my_buf)
 
+/*
+ * Switch buffer to the compact encoding until buf_clear_compact(). Integers
+ * packed with pack16/32/64() and pack_time() are written as variable length
+ * integers (NO_VAL and INFINITE take one byte) and packmem() uses a variable
+ * length size. The reader must unpack the same region in compact mode.
+ * Offsets must not be rewritten while compact, as the encoded size of a value
+ * depends on the value.
+ * IN buffer - buffer to pack into or unpack from
+ * IN intern - add short strings packed into the buffer to a string table so
+ *	later copies are packed as a reference to the first one. Always true
+ *	when unpacking, references are only followed when present.
+ */
+extern void buf_set_compact(buf_t *buffer, bool intern);
+
+/* Return buffer to the fixed width encoding and release its string table */
+extern void buf_clear_compact(buf_t *buffer);
+
 extern void pack_time(time_t val, buf_t *buffer);
 extern int unpack_time(time_t *valp, buf_t *buffer);
 
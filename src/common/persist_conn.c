@@ -51,6 +51,7 @@
 #include "src/common/threadpool.h"
 #include "src/common/xsignal.h"
 #include "src/interfaces/auth.h"
+#include "src/interfaces/compress.h"
 #include "src/interfaces/conn.h"
 
 #define MAX_THREAD_COUNT 100
@@ -693,8 +694,11 @@ extern int slurm_persist_conn_open(persist_conn_t *persist_conn)
 	req_msg.protocol_version = persist_conn->version;
 	req_msg.msg_type = REQUEST_PERSIST_INIT;
 	req_msg.flags |= SLURM_GLOBAL_AUTH_KEY;
-	if (persist_conn->flags & PERSIST_FLAG_DBD)
+	if (persist_conn->flags & PERSIST_FLAG_DBD) {
 		req_msg.flags |= SLURMDBD_CONNECTION;
+		if (compress_g_available(COMPRESS_PLUGIN_LZ4))
+			req_msg.flags |= SLURM_COMPRESS_LZ4;
+	}
 	slurm_msg_set_r_uid(&req_msg, persist_conn->r_uid);
 	req_msg.conn = persist_conn->conn;
 
@@ -51,6 +51,7 @@
 #define PERSIST_FLAG_EXT_DBD        SLURM_BIT(5)
 #define PERSIST_FLAG_DONT_UPDATE_CLUSTER SLURM_BIT(6)
 #define PERSIST_FLAG_P_RESOURCE_CASE SLURM_BIT(7)
+#define PERSIST_FLAG_COMPRESS       SLURM_BIT(8)
 
 #define PERSIST_CONN_NOT_INITED -2
 
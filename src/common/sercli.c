@@ -157,6 +157,7 @@ extern int data_parser_dump_cli_stdout(data_parser_type_t type, void *obj,
 	data_parser_t *parser = NULL;
 	buf_t *out = NULL;
 	serialize_dump_state_t *state = NULL;
+	data_arena_t *arena = NULL, *prior_arena = NULL;
 
 	if (!xstrcasecmp(data_parser, "list")) {
 		dprintf(STDERR_FILENO, "Possible data_parser plugins:\n");
@@ -183,6 +184,10 @@ extern int data_parser_dump_cli_stdout(data_parser_type_t type, void *obj,
 
 	out = init_buf(BUF_SIZE);
 
+	/* Dump tree is only needed until serialized */
+	arena = data_arena_new();
+	prior_arena = data_arena_set(arena);
+
 	do {
 		rc = serdes_dump(&state, parser, type, obj, obj_bytes, out,
 				 mime_type, SER_FLAGS_NONE);
@@ -192,6 +197,8 @@ extern int data_parser_dump_cli_stdout(data_parser_type_t type, void *obj,
 		set_buf_offset(out, 0);
 	} while (state);
 
+	(void) data_arena_set(prior_arena);
+
 	printf("\n");
 
 cleanup:
@@ -204,6 +211,7 @@ cleanup:
 #ifdef MEMORY_LEAK_DEBUG
 	FREE_NULL_BUFFER(out);
 	FREE_NULL_DATA_PARSER(parser);
+	FREE_NULL_DATA_ARENA(arena);
 #endif
 
 	return rc;
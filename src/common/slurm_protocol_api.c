@@ -79,6 +79,7 @@
 
 #include "src/interfaces/accounting_storage.h"
 #include "src/interfaces/auth.h"
+#include "src/interfaces/compress.h"
 #include "src/interfaces/conn.h"
 #include "src/interfaces/hash.h"
 
@@ -433,6 +434,35 @@ extern uint16_t slurm_get_track_wckey(void)
 	return track_wckey;
 }
 
+/* slurm_get_compress_threshold
+ * returns the smallest bulk response to compress, from the
+ * CommunicationParameters compress_threshold= option, 0 if disabled
+ */
+extern uint32_t slurm_get_compress_threshold(void)
+{
+	static time_t config_update = (time_t) -1;
+	static uint32_t threshold = COMPRESS_MIN_SIZE;
+	char *temp_str;
+
+	if (config_update == slurm_conf.last_update)
+		return threshold;
+
+	threshold = COMPRESS_MIN_SIZE;
+	if ((temp_str = xstrcasestr(slurm_conf.comm_params,
+				    "compress_threshold="))) {
+		long long tmp_val = strtoll(temp_str + 19, NULL, 10);
+
+		if ((tmp_val >= 0) && (tmp_val <= MAX_BUF_SIZE))
+			threshold = tmp_val;
+		else
+			error("CommunicationParameters option compress_threshold=%lld is invalid, ignored",
+			      tmp_val);
+	}
+	config_update = slurm_conf.last_update;
+
+	return threshold;
+}
+
 /* slurm_with_slurmdbd
  * returns true if operating with slurmdbd
  */
@@ -2258,6 +2288,9 @@ extern int slurm_send_recv_controller_msg(slurm_msg_t * request_msg,
 	request_msg->forward_struct = NULL;
 	slurm_msg_set_r_uid(request_msg, SLURM_AUTH_UID_ANY);
 
+	if (compress_g_available(COMPRESS_PLUGIN_LZ4))
+		request_msg->flags |= SLURM_COMPRESS_LZ4;
+
 tryagain:
 	if (comm_cluster_rec)
 		request_msg->flags |= SLURM_GLOBAL_AUTH_KEY;
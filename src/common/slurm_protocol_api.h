@@ -122,6 +122,12 @@ extern char *slurm_get_tmp_fs(char *node_name);
  */
 extern uint16_t slurm_get_track_wckey(void);
 
+/* slurm_get_compress_threshold
+ * returns the smallest bulk response to compress, from the
+ * CommunicationParameters compress_threshold= option, 0 if disabled
+ */
+extern uint32_t slurm_get_compress_threshold(void);
+
 /* slurm_with_slurmdbd
  * returns true if operating with slurmdbd
  */
@@ -111,5 +111,15 @@
 #define CTLD_QUEUE_PROCESSING	SLURM_BIT(5)
 #define SLURM_NO_AUTH_CRED	SLURM_BIT(6)
 #define SLURM_PACK_ADDRS	SLURM_BIT(7)
+/*
+ * REQUEST_JOB_INFO and REQUEST_NODE_INFO: the client can unpack records in the
+ * compact encoding, see buf_set_compact(). Echoed in the response header.
+ */
+#define SLURM_COMPACT_ENCODING	SLURM_BIT(8)
+/*
+ * The client can decompress bulk responses packed with compress_g_pack_buf()
+ * using COMPRESS_PLUGIN_LZ4. Echoed in the response header.
+ */
+#define SLURM_COMPRESS_LZ4	SLURM_BIT(9)
 
 #endif
@@ -2533,6 +2533,17 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 			xfree(msg->rpc_dump_hostlist[i]);
 		}
 		xfree(msg->rpc_dump_hostlist);
+		for (i = 0; i < msg->lock_type_size; i++)
+			xfree(msg->lock_type_name[i]);
+		xfree(msg->lock_type_name);
+		xfree(msg->lock_read_cnt);
+		xfree(msg->lock_read_wait_cnt);
+		xfree(msg->lock_read_wait_time);
+		xfree(msg->lock_read_wait_max);
+		xfree(msg->lock_write_cnt);
+		xfree(msg->lock_write_wait_cnt);
+		xfree(msg->lock_write_wait_time);
+		xfree(msg->lock_write_wait_max);
 		xfree(msg);
 	}
 }
@@ -4393,6 +4404,7 @@ extern void slurm_free_job_info_msg(job_info_msg_t * job_buffer_ptr)
 			_free_all_job_info(job_buffer_ptr);
 			xfree(job_buffer_ptr->job_array);
 		}
+		xfree(job_buffer_ptr->purged_job_ids);
 		xfree(job_buffer_ptr);
 	}
 }
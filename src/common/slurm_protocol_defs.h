@@ -465,6 +465,9 @@ typedef struct job_info_request_msg {
 	uint16_t show_flags;
 	list_t *job_ids;	/* Optional list of job_ids, otherwise show all
 				 * jobs. */
+	uint32_t after_job_id;	/* only show jobs with a greater job id */
+	uint32_t max_jobs;	/* show at most this many jobs, 0 if no limit */
+	uint64_t fields;	/* JOB_FIELD_* to show, 0 for all */
 } job_info_request_msg_t;
 
 typedef struct {
@@ -66,6 +66,7 @@
 #include "src/interfaces/accounting_storage.h"
 #include "src/interfaces/acct_gather_energy.h"
 #include "src/interfaces/auth.h"
+#include "src/interfaces/compress.h"
 #include "src/interfaces/cred.h"
 #include "src/interfaces/gres.h"
 #include "src/interfaces/hash.h"
@@ -111,6 +112,8 @@ static int _unpack_job_step_pids(job_step_pids_t **msg, buf_t *buffer,
 
 static int _unpack_job_info_members(job_info_t *job, buf_t *buffer,
 				    uint16_t protocol_version);
+static int _unpack_job_info_fields(job_info_t *job, uint64_t fields,
+				   buf_t *buffer, uint16_t protocol_version);
 
 static void _pack_ret_list(list_t *ret_list, uint16_t size_val, buf_t *buffer,
 			   uint16_t protocol_version);
@@ -1722,6 +1725,16 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/*
+ * The records of a RESPONSE_JOB_INFO or RESPONSE_NODE_INFO were packed with
+ * buf_set_compact() when the request asked for it and slurmctld knows how.
+ */
+static bool _compact_records(slurm_msg_t *smsg)
+{
+	return ((smsg->flags & SLURM_COMPACT_ENCODING) &&
+		(smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION));
+}
+
 static int _unpack_node_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 {
 	bitstr_t *hidden_nodes = NULL;
@@ -1735,6 +1748,9 @@ static int _unpack_node_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 		safe_xcalloc(msg->node_array, msg->record_count,
 			     sizeof(node_info_t));
 
+		if (_compact_records(smsg))
+			buf_set_compact(buffer, true);
+
 		/* load individual job info */
 		for (int i = 0; i < msg->record_count; i++) {
 			if (hidden_nodes && bit_test(hidden_nodes, i)) {
@@ -1746,6 +1762,7 @@ static int _unpack_node_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 			}
 		}
 
+		buf_clear_compact(buffer);
 		FREE_NULL_BITMAP(hidden_nodes);
 	}
 
@@ -1753,6 +1770,7 @@ static int _unpack_node_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 	return SLURM_SUCCESS;
 
 unpack_error:
+	buf_clear_compact(buffer);
 	FREE_NULL_BITMAP(hidden_nodes);
 	slurm_free_node_info_msg(msg);
 	return SLURM_ERROR;
@@ -3733,10 +3751,62 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/*
+ * The body of a bulk response packed by _pack_buf_msg() goes through
+ * compress_g_pack_buf() when the request said the client can decompress it.
+ */
+static bool _compress_msg(const slurm_msg_t *msg)
+{
+	return ((msg->flags & SLURM_COMPRESS_LZ4) &&
+		(msg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION));
+}
+
 static void _pack_buf_msg(const slurm_msg_t *msg, buf_t *buffer)
 {
 	buf_t *msg_buffer = msg->data;
-	packmem_array(msg_buffer->head, msg_buffer->processed, buffer);
+
+	if (_compress_msg(msg))
+		(void) compress_g_pack_buf(COMPRESS_PLUGIN_LZ4, msg_buffer,
+					   slurm_get_compress_threshold(),
+					   buffer);
+	else
+		packmem_array(msg_buffer->head, msg_buffer->processed, buffer);
+}
+
+static bool _is_buf_msg(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case RESPONSE_ASSOC_MGR_INFO:
+	case RESPONSE_BURST_BUFFER_INFO:
+	case RESPONSE_JOB_INFO:
+	case RESPONSE_JOB_STEP_INFO:
+	case RESPONSE_LICENSE_INFO:
+	case RESPONSE_NODE_INFO:
+	case RESPONSE_PARTITION_INFO:
+	case RESPONSE_RESERVATION_INFO:
+	case RESPONSE_STATS_INFO:
+	case RESPONSE_RESOURCE_LAYOUT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Decompress the body of a bulk response then unpack it as usual */
+static int _unpack_compressed_msg(slurm_msg_t *msg, buf_t *buffer)
+{
+	buf_t *body = NULL;
+	int rc;
+
+	if (compress_g_unpack_buf(&body, buffer))
+		return SLURM_ERROR;
+
+	msg->flags &= ~SLURM_COMPRESS_LZ4;
+	rc = unpack_msg(msg, (body ? body : buffer));
+	msg->flags |= SLURM_COMPRESS_LZ4;
+
+	FREE_NULL_BUFFER(body);
+	return rc;
 }
 
 static void _pack_job_script_msg(const slurm_msg_t *smsg, buf_t *buffer)
@@ -3771,28 +3841,46 @@ static int _unpack_job_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 		safe_unpack_time(&msg->last_update, buffer);
 		safe_unpack_time(&msg->last_backfill, buffer);
 	}
+	if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION)
+		safe_unpack64(&msg->fields, buffer);
 
 	if (msg->record_count) {
 		safe_xcalloc(msg->job_array, msg->record_count,
 			     sizeof(job_info_t));
 		job = msg->job_array;
 	}
+	if (_compact_records(smsg))
+		buf_set_compact(buffer, true);
 	/* load individual job info */
 	for (int i = 0; i < msg->record_count; i++) {
 		job_info_t *job_ptr = &job[i];
-		if (_unpack_job_info_members(job_ptr, buffer,
-					     smsg->protocol_version))
+		if (msg->fields) {
+			if (_unpack_job_info_fields(job_ptr, msg->fields,
+						    buffer,
+						    smsg->protocol_version))
+				goto unpack_error;
+		} else if (_unpack_job_info_members(job_ptr, buffer,
+						    smsg->protocol_version)) {
 			goto unpack_error;
+		}
 		if ((job_ptr->bitflags & BACKFILL_SCHED) &&
 		    msg->last_backfill && IS_JOB_PENDING(job_ptr) &&
 		    (msg->last_backfill <= job_ptr->last_sched_eval))
 			job_ptr->bitflags |= BACKFILL_LAST;
 	}
+	buf_clear_compact(buffer);
+
+	if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		safe_unpackbool(&msg->delta, buffer);
+		safe_unpack32_array(&msg->purged_job_ids, &msg->purged_cnt,
+				    buffer);
+	}
 
 	smsg->data = msg;
 	return SLURM_SUCCESS;
 
 unpack_error:
+	buf_clear_compact(buffer);
 	slurm_free_job_info_msg(msg);
 	return SLURM_ERROR;
 }
@@ -4665,6 +4753,119 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/*
+ * _unpack_job_info_fields
+ * unpacks the JOB_FIELD_* members of slurm job info for one job, packed by
+ * _pack_job_fields() in slurmctld in the order of the JOB_FIELD_* bits
+ * OUT job - pointer to the job info buffer
+ * IN fields - JOB_FIELD_* packed for each job
+ * IN/OUT buffer - source of the unpack, contains pointers that are
+ *			automatically updated
+ */
+static int _unpack_job_info_fields(job_info_t *job, uint64_t fields,
+				   buf_t *buffer, uint16_t protocol_version)
+{
+	if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		safe_unpack_step_id_members(&job->step_id, buffer,
+					    protocol_version);
+
+		if (fields & JOB_FIELD_ACCOUNT)
+			safe_unpackstr(&job->account, buffer);
+		if (fields & JOB_FIELD_ARRAY) {
+			safe_unpack32(&job->array_job_id, buffer);
+			safe_unpack32(&job->array_task_id, buffer);
+			safe_unpackstr(&job->array_task_str, buffer);
+			safe_unpack32(&job->array_max_tasks, buffer);
+			xlate_array_task_str(&job->array_task_str,
+					     job->array_max_tasks,
+					     &job->array_bitmap);
+		}
+		if (fields & JOB_FIELD_CLUSTER)
+			safe_unpackstr(&job->cluster, buffer);
+		if (fields & JOB_FIELD_COMMENT) {
+			safe_unpackstr(&job->admin_comment, buffer);
+			safe_unpackstr(&job->comment, buffer);
+			safe_unpackstr(&job->system_comment, buffer);
+		}
+		if (fields & JOB_FIELD_CPUS) {
+			safe_unpack32(&job->num_cpus, buffer);
+			safe_unpack32(&job->max_cpus, buffer);
+		}
+		if (fields & JOB_FIELD_EXIT_CODE) {
+			safe_unpack32(&job->derived_ec, buffer);
+			safe_unpack32(&job->exit_code, buffer);
+		}
+		if (fields & JOB_FIELD_FLAGS)
+			safe_unpack64(&job->bitflags, buffer);
+		if (fields & JOB_FIELD_GROUP)
+			safe_unpack32(&job->group_id, buffer);
+		if (fields & JOB_FIELD_HET) {
+			safe_unpack32(&job->het_job_id, buffer);
+			safe_unpackstr(&job->het_job_id_set, buffer);
+			safe_unpack32(&job->het_job_offset, buffer);
+		}
+		if (fields & JOB_FIELD_NAME)
+			safe_unpackstr(&job->name, buffer);
+		if (fields & JOB_FIELD_NODES) {
+			safe_unpackstr(&job->nodes, buffer);
+			safe_unpackstr(&job->sched_nodes, buffer);
+			safe_unpack32(&job->num_nodes, buffer);
+			safe_unpack32(&job->max_nodes, buffer);
+		}
+		if (fields & JOB_FIELD_PARTITION)
+			safe_unpackstr(&job->partition, buffer);
+		if (fields & JOB_FIELD_PRIORITY)
+			safe_unpack32(&job->priority, buffer);
+		if (fields & JOB_FIELD_QOS)
+			safe_unpackstr(&job->qos, buffer);
+		if (fields & JOB_FIELD_RESV)
+			safe_unpackstr(&job->resv_name, buffer);
+		if (fields & JOB_FIELD_STATE) {
+			safe_unpack32(&job->job_state, buffer);
+			safe_unpackstr(&job->state_desc, buffer);
+			safe_unpack32(&job->state_reason, buffer);
+		}
+		if (fields & JOB_FIELD_STDIO) {
+			safe_unpackstr(&job->std_err, buffer);
+			safe_unpackstr(&job->std_in, buffer);
+			safe_unpackstr(&job->std_out, buffer);
+		}
+		if (fields & JOB_FIELD_TIME) {
+			safe_unpack_time(&job->submit_time, buffer);
+			safe_unpack_time(&job->eligible_time, buffer);
+			safe_unpack_time(&job->start_time, buffer);
+			safe_unpack_time(&job->end_time, buffer);
+			safe_unpack_time(&job->suspend_time, buffer);
+			safe_unpack32(&job->time_limit, buffer);
+		}
+		if (fields & JOB_FIELD_TRES) {
+			safe_unpackstr(&job->tres_alloc_str, buffer);
+			safe_unpackstr(&job->tres_req_str, buffer);
+		}
+		if (fields & JOB_FIELD_USER) {
+			safe_unpack32(&job->user_id, buffer);
+			safe_unpackstr(&job->user_name, buffer);
+		}
+		if (fields & JOB_FIELD_WORK_DIR) {
+			safe_unpackstr(&job->command, buffer);
+			safe_unpackstr(&job->work_dir, buffer);
+		}
+	} else {
+		error("%s: protocol_version %hu not supported",
+		      __func__, protocol_version);
+		goto unpack_error;
+	}
+
+	/* set automatically for external applications */
+	job->job_id = job->step_id.job_id;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_job_info_members(job);
+	return SLURM_ERROR;
+}
+
 static void _pack_slurm_conf(const slurm_conf_t *conf,
 			     const uint16_t protocol_version, buf_t *buffer)
 {
@@ -10509,7 +10710,26 @@ static void _pack_job_info_request_msg(const slurm_msg_t *smsg, buf_t *buffer)
 	uint32_t count = NO_VAL;
 	list_itr_t *itr;
 
-	if (smsg->protocol_version >= SLURM_25_11_PROTOCOL_VERSION) {
+	if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		pack_time(msg->last_update, buffer);
+		pack16(msg->show_flags, buffer);
+
+		if (msg->job_ids)
+			count = list_count(msg->job_ids);
+
+		pack32(count, buffer);
+		if (count && count != NO_VAL) {
+			itr = list_iterator_create(msg->job_ids);
+			uint32_t *uint32_ptr;
+			while ((uint32_ptr = list_next(itr)))
+				pack32(*uint32_ptr, buffer);
+			list_iterator_destroy(itr);
+		}
+
+		pack32(msg->after_job_id, buffer);
+		pack32(msg->max_jobs, buffer);
+		pack64(msg->fields, buffer);
+	} else if (smsg->protocol_version >= SLURM_25_11_PROTOCOL_VERSION) {
 		pack_time(msg->last_update, buffer);
 		pack16(msg->show_flags, buffer);
 
@@ -10548,7 +10768,27 @@ static int _unpack_job_info_request_msg(slurm_msg_t *smsg, buf_t *buffer)
 	uint32_t *uint32_ptr = NULL;
 	job_info_request_msg_t *job_info = xmalloc(sizeof(*job_info));
 
-	if (smsg->protocol_version >= SLURM_25_11_PROTOCOL_VERSION) {
+	if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		safe_unpack_time(&job_info->last_update, buffer);
+		safe_unpack16(&job_info->show_flags, buffer);
+
+		safe_unpack32(&count, buffer);
+		if (count > NO_VAL)
+			goto unpack_error;
+		if (count != NO_VAL) {
+			job_info->job_ids = list_create(xfree_ptr);
+			for (int i = 0; i < count; i++) {
+				uint32_ptr = xmalloc(sizeof(uint32_t));
+				safe_unpack32(uint32_ptr, buffer);
+				list_append(job_info->job_ids, uint32_ptr);
+				uint32_ptr = NULL;
+			}
+		}
+
+		safe_unpack32(&job_info->after_job_id, buffer);
+		safe_unpack32(&job_info->max_jobs, buffer);
+		safe_unpack64(&job_info->fields, buffer);
+	} else if (smsg->protocol_version >= SLURM_25_11_PROTOCOL_VERSION) {
 		safe_unpack_time(&job_info->last_update, buffer);
 		safe_unpack16(&job_info->show_flags, buffer);
 
@@ -13239,6 +13479,33 @@ static int _unpack_stats_response_msg(slurm_msg_t *smsg, buf_t *buffer)
 		safe_unpack32(&msg->bf_backfilled_het_jobs, buffer);
 		safe_unpack32_array(&msg->bf_exit, &msg->bf_exit_cnt, buffer);
 
+		if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+			safe_unpack32(&msg->job_state_save_counter, buffer);
+			safe_unpack32(&msg->job_state_save_last, buffer);
+			safe_unpack32(&msg->job_state_save_max, buffer);
+			safe_unpack32(&msg->job_state_save_lock_last, buffer);
+			safe_unpack32(&msg->job_state_save_lock_max, buffer);
+
+			safe_unpackstr_array(&msg->lock_type_name,
+					     &msg->lock_type_size, buffer);
+			safe_unpack64_array(&msg->lock_read_cnt, &uint32_tmp,
+					    buffer);
+			safe_unpack64_array(&msg->lock_read_wait_cnt,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->lock_read_wait_time,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->lock_read_wait_max,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->lock_write_cnt, &uint32_tmp,
+					    buffer);
+			safe_unpack64_array(&msg->lock_write_wait_cnt,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->lock_write_wait_time,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->lock_write_wait_max,
+					    &uint32_tmp, buffer);
+		}
+
 		safe_unpack32(&msg->rpc_type_size, buffer);
 		safe_unpack16_array(&msg->rpc_type_id, &uint32_tmp, buffer);
 		safe_unpack32_array(&msg->rpc_type_cnt, &uint32_tmp, buffer);
@@ -14854,6 +15121,9 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 		return SLURM_ERROR;
 	}
 
+	if (_compress_msg(msg) && _is_buf_msg(msg->msg_type))
+		return _unpack_compressed_msg(msg, buffer);
+
 	switch (msg->msg_type) {
 	case REQUEST_NODE_INFO:
 		rc = _unpack_node_info_request_msg(msg, buffer);
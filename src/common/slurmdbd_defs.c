@@ -125,6 +125,8 @@ extern slurmdbd_msg_type_t str_2_slurmdbd_msg_type(char *msg_type)
 		return DBD_GOT_INSTANCES;
 	} else if (!xstrcasecmp(msg_type, "Got Jobs")) {
 		return DBD_GOT_JOBS;
+	} else if (!xstrcasecmp(msg_type, "Got Jobs Part")) {
+		return DBD_GOT_JOBS_PART;
 	} else if (!xstrcasecmp(msg_type, "Got List")) {
 		return DBD_GOT_LIST;
 	} else if (!xstrcasecmp(msg_type, "Got Problems")) {
@@ -853,6 +855,18 @@ extern char *slurmdbd_msg_type_2_str(slurmdbd_msg_type_t msg_type, int get_enum)
 		} else
 			return "Got Config Response";
 		break;
+	case DBD_COMPRESSED:
+		if (get_enum) {
+			return "DBD_COMPRESSED";
+		} else
+			return "Compressed Response";
+		break;
+	case DBD_GOT_JOBS_PART:
+		if (get_enum) {
+			return "DBD_GOT_JOBS_PART";
+		} else
+			return "Got Jobs Part";
+		break;
 	case SLURM_PERSIST_INIT:
 		if (get_enum) {
 			return "SLURM_PERSIST_INIT";
@@ -939,6 +953,7 @@ extern void slurmdbd_free_msg(persist_msg_t *msg)
 	case DBD_GOT_FEDERATIONS:
 	case DBD_GOT_INSTANCES:
 	case DBD_GOT_JOBS:
+	case DBD_GOT_JOBS_PART:
 	case DBD_GOT_LIST:
 	case DBD_GOT_PROBS:
 	case DBD_GOT_RES:
@@ -169,6 +169,9 @@ typedef enum {
 	DBD_GET_ASSOC_NG_USAGE, /* Get non-grouped assoc usage
 				 * (this is used for sreport user topuser) */
 	DBD_GOT_CONFIG, /* Response to DBD_GET_CONFIG */
+	DBD_COMPRESSED,	/* Response packed with compress_g_pack_buf() */
+	DBD_GOT_JOBS_PART, /* Partial response to a streamed
+			    * DBD_GET_JOBS_COND, more will follow */
 	SLURM_DBD_MESSAGES_END = 2000, /* So that we don't overlap with any
 					* slurm_msg_type_t numbers. */
 	SLURM_PERSIST_INIT = 6500, /* So we don't use the
@@ -784,6 +784,11 @@ extern void wrap_on_connection(conmgr_callback_args_t conmgr_args, void *arg)
 			 __func__, con->name,
 			 (uintptr_t) con->events->on_connection,
 			 (uintptr_t) arg);
+
+		/* on_connection() took ownership of new_arg */
+		slurm_mutex_lock(&mgr.mutex);
+		con->new_arg = NULL;
+		slurm_mutex_unlock(&mgr.mutex);
 	}
 
 	if (!arg) {
@@ -1353,7 +1358,8 @@ again:
 				log_flag(CONMGR, "%s: [%pA(fd:%d)] connect() interrupted during shutdown. Closing connection.",
 					 __func__, addr, fd);
 				fd_close(&fd);
-				return SLURM_SUCCESS;
+				/* No callbacks will ever be run for arg */
+				return SLURM_COMMUNICATIONS_SHUTDOWN_ERROR;
 			}
 
 			log_flag(CONMGR, "%s: [%pA(fd:%d)] connect() interrupted. Retrying.",
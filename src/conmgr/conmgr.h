@@ -271,6 +271,20 @@ typedef struct {
 	 */
 	int (*on_connect_timeout)(conmgr_callback_args_t conmgr_args,
 				  void *arg);
+
+	/*
+	 * Call back when connection ended before on_connection() was called,
+	 * such as when connect() was refused or timed out.
+	 * Called once per connection instead of on_finish().
+	 *
+	 * IN conmgr_args - Args relaying conmgr callback state
+	 *	conmgr_args.status_code holds the reason for the failure
+	 * IN arg - arg ptr handed to fd processing functions
+	 * 	Ownership of arg pointer returned to caller as it will not be
+	 * 	used anymore.
+	 */
+	void (*on_connect_failed)(conmgr_callback_args_t conmgr_args,
+				  void *arg);
 } conmgr_events_t;
 
 typedef enum {
@@ -41,6 +41,7 @@
 
 #include "config.h"
 
+#include <ctype.h>
 #include <sys/stat.h>
 #include <limits.h>
 
@@ -63,6 +64,9 @@
 #define PW_SCRIPT_TIMEOUT_SECONDS 10
 #define PW_SCRIPT_DEFAULT_REFRESH_SECONDS 300
 #define PW_SCRIPT_TOKEN_PREFIX "TOKEN="
+#define BATCH_DEFAULT_MAX_ROWS 256
+#define BATCH_DEFAULT_MAX_DELAY 100 /* milliseconds */
+#define BATCH_MAX_BYTES (1024 * 1024) /* stay well under max_allowed_packet */
 
 static char *table_defs_table = "table_defs_table";
 
@@ -366,6 +370,92 @@ end_it:
 	return rc;
 }
 
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static void _batch_clear(mysql_conn_t *mysql_conn)
+{
+	xfree(mysql_conn->batch_query);
+	xfree(mysql_conn->batch_prefix);
+	xfree(mysql_conn->batch_values);
+	xfree(mysql_conn->batch_suffix);
+	mysql_conn->batch_cnt = 0;
+}
+
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static void _batch_close_insert(mysql_conn_t *mysql_conn)
+{
+	if (!mysql_conn->batch_prefix)
+		return;
+
+	xstrfmtcat(mysql_conn->batch_query, "%s%s%s;",
+		   mysql_conn->batch_prefix, mysql_conn->batch_values,
+		   mysql_conn->batch_suffix);
+	xfree(mysql_conn->batch_prefix);
+	xfree(mysql_conn->batch_values);
+	xfree(mysql_conn->batch_suffix);
+}
+
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static int _batch_flush(mysql_conn_t *mysql_conn)
+{
+	char *query;
+	uint32_t cnt = mysql_conn->batch_cnt;
+	int rc;
+
+	if (!cnt)
+		return SLURM_SUCCESS;
+
+	if (!mysql_conn->db_conn) {
+		error("%s: dropping batch of %u statements, no connection",
+		      __func__, cnt);
+		_batch_clear(mysql_conn);
+		return SLURM_ERROR;
+	}
+
+	_batch_close_insert(mysql_conn);
+	query = mysql_conn->batch_query;
+	mysql_conn->batch_query = NULL;
+	mysql_conn->batch_cnt = 0;
+
+	/* Errors past the first statement only show up in the results */
+	if ((rc = _mysql_query_internal(mysql_conn->db_conn, query)) !=
+	    SLURM_ERROR)
+		rc = _clear_results(mysql_conn->db_conn);
+	if (rc != SLURM_SUCCESS)
+		error("%s: batch of %u statements failed", __func__, cnt);
+	xfree(query);
+
+	return rc;
+}
+
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static int _batch_added(mysql_conn_t *mysql_conn)
+{
+	size_t size = 0;
+
+	if (!mysql_conn->batch_cnt++) {
+		timespec_t delay = {
+			.tv_sec = mysql_conn->batch_max_delay / 1000,
+			.tv_nsec = (mysql_conn->batch_max_delay % 1000) *
+				   NSEC_IN_MSEC,
+		};
+
+		mysql_conn->batch_deadline =
+			timespec_add(timespec_now(), delay);
+	}
+
+	if (mysql_conn->batch_query)
+		size += strlen(mysql_conn->batch_query);
+	if (mysql_conn->batch_values)
+		size += strlen(mysql_conn->batch_values);
+
+	if ((mysql_conn->batch_cnt >= mysql_conn->batch_max_rows) ||
+	    (size >= BATCH_MAX_BYTES) ||
+	    timespec_is_after(timespec_now(), mysql_conn->batch_deadline))
+		return _batch_flush(mysql_conn);
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * Determine if a database server upgrade has taken place and if so, check to
  * see if the candidate table alteration query should be used to alter the table
@@ -872,8 +962,9 @@ void _set_mysql_ssl_opts(MYSQL *db_conn, const char *options)
 			key = val_str;
 		else if (!xstrcasecmp(opt_str, "SSL_CIPHER"))
 			cipher = val_str;
-		else if (!xstrncasecmp(opt_str, "token_", 6)) {
-			/* Skip token_ parameters - handled elsewhere */
+		else if (!xstrncasecmp(opt_str, "token_", 6) ||
+			 !xstrncasecmp(opt_str, "batch_", 6)) {
+			/* Skip token_ and batch_ parameters - handled elsewhere */
 			goto next;
 		} else {
 			error("Invalid storage option '%s'", opt_str);
@@ -976,6 +1067,7 @@ extern int destroy_mysql_conn(mysql_conn_t *mysql_conn)
 		slurm_mutex_destroy(&mysql_conn->lock);
 		FREE_NULL_LIST(mysql_conn->update_list);
 		xfree(mysql_conn->wsrep_trx_fragment_unit_orig);
+		_batch_clear(mysql_conn);
 		xfree(mysql_conn);
 	}
 
@@ -996,6 +1088,26 @@ static void _parse_token_params(mysql_db_info_t *db_info)
 	xfree(duration);
 }
 
+/* Parse statement batching parameters from parameter string */
+static void _parse_batch_params(mysql_db_info_t *db_info)
+{
+	char *tmp_str = NULL;
+
+	if ((tmp_str = conf_get_opt_str(db_info->params, "batch_max_rows=")))
+		db_info->batch_max_rows =
+			parse_int("batch_max_rows", tmp_str, false);
+	else
+		db_info->batch_max_rows = BATCH_DEFAULT_MAX_ROWS;
+	xfree(tmp_str);
+
+	if ((tmp_str = conf_get_opt_str(db_info->params, "batch_max_delay=")))
+		db_info->batch_max_delay =
+			parse_int("batch_max_delay", tmp_str, false);
+	else
+		db_info->batch_max_delay = BATCH_DEFAULT_MAX_DELAY;
+	xfree(tmp_str);
+}
+
 extern mysql_db_info_t *create_mysql_db_info(slurm_mysql_plugin_type_t type)
 {
 	mysql_db_info_t *db_info = xmalloc(sizeof(mysql_db_info_t));
@@ -1013,6 +1125,7 @@ extern mysql_db_info_t *create_mysql_db_info(slurm_mysql_plugin_type_t type)
 		db_info->pass_script =
 			xstrdup(slurmdbd_conf->storage_pass_script);
 		db_info->params = xstrdup(slurm_conf.accounting_storage_params);
+		_parse_batch_params(db_info);
 		break;
 	case SLURM_MYSQL_PLUGIN_JC:
 		if (!slurm_conf.job_comp_port)
@@ -1132,8 +1245,12 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 		}
 
 		storage_init = true;
-		if (mysql_conn->flags & DB_CONN_FLAG_ROLLBACK)
+		if (mysql_conn->flags & DB_CONN_FLAG_ROLLBACK) {
 			mysql_autocommit(mysql_conn->db_conn, 0);
+			/* Only batch inside of transactions */
+			mysql_conn->batch_max_rows = db_info->batch_max_rows;
+			mysql_conn->batch_max_delay = db_info->batch_max_delay;
+		}
 		rc = _mysql_query_internal(mysql_conn->db_conn,
 					   "SET session sql_mode='ANSI_QUOTES,"
 					   "NO_ENGINE_SUBSTITUTION';");
@@ -1147,6 +1264,7 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 {
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_clear(mysql_conn);
 	if (mysql_conn && mysql_conn->db_conn) {
 		if (mysql_thread_safe())
 			mysql_thread_end();
@@ -1179,6 +1297,7 @@ extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	rc = _mysql_query_internal(mysql_conn->db_conn, query);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
@@ -1197,6 +1316,7 @@ extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	if (!(rc = _mysql_query_internal(mysql_conn->db_conn, query)))
 		rc = mysql_affected_rows(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
@@ -1232,6 +1352,7 @@ extern int mysql_db_commit(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_commit(mysql_conn->db_conn)) {
@@ -1253,6 +1374,7 @@ extern int mysql_db_rollback(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_clear(mysql_conn);
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_rollback(mysql_conn->db_conn)) {
@@ -1279,6 +1401,7 @@ extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
 		if (mysql_errno(mysql_conn->db_conn) == ER_NO_SUCH_TABLE)
 			goto fini;
@@ -1308,6 +1431,7 @@ extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 	int rc = SLURM_SUCCESS;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	if ((rc = _mysql_query_internal(
 		     mysql_conn->db_conn, query)) != SLURM_ERROR)
 		rc = _clear_results(mysql_conn->db_conn);
@@ -1320,6 +1444,7 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 	uint64_t new_id = 0;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_flush(mysql_conn);
 	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
 		new_id = mysql_insert_id(mysql_conn->db_conn);
 		if (!new_id) {
@@ -1333,6 +1458,67 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 
 }
 
+extern int mysql_db_batch_query(mysql_conn_t *mysql_conn, char *query)
+{
+	int len, rc;
+
+	if (!mysql_conn->batch_max_rows)
+		return mysql_db_query(mysql_conn, query);
+
+	/* An empty statement between two ';' is an error */
+	len = strlen(query);
+	while (len && ((query[len - 1] == ';') || isspace(query[len - 1])))
+		len--;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	_batch_close_insert(mysql_conn);
+	xstrfmtcat(mysql_conn->batch_query, "%.*s;", len, query);
+	rc = _batch_added(mysql_conn);
+	slurm_mutex_unlock(&mysql_conn->lock);
+
+	return rc;
+}
+
+extern int mysql_db_batch_insert(mysql_conn_t *mysql_conn, char *prefix,
+				 char *values, char *suffix)
+{
+	int rc;
+
+	if (!mysql_conn->batch_max_rows) {
+		char *query = xstrdup_printf("%s%s%s", prefix, values, suffix);
+
+		rc = mysql_db_query(mysql_conn, query);
+		xfree(query);
+		return rc;
+	}
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	if (!xstrcmp(mysql_conn->batch_prefix, prefix) &&
+	    !xstrcmp(mysql_conn->batch_suffix, suffix)) {
+		xstrfmtcat(mysql_conn->batch_values, ", %s", values);
+	} else {
+		_batch_close_insert(mysql_conn);
+		mysql_conn->batch_prefix = xstrdup(prefix);
+		mysql_conn->batch_values = xstrdup(values);
+		mysql_conn->batch_suffix = xstrdup(suffix);
+	}
+	rc = _batch_added(mysql_conn);
+	slurm_mutex_unlock(&mysql_conn->lock);
+
+	return rc;
+}
+
+extern int mysql_db_batch_flush(mysql_conn_t *mysql_conn)
+{
+	int rc;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	rc = _batch_flush(mysql_conn);
+	slurm_mutex_unlock(&mysql_conn->lock);
+
+	return rc;
+}
+
 extern int mysql_db_create_table(mysql_conn_t *mysql_conn, char *table_name,
 				 storage_field_t *fields, char *ending)
 {
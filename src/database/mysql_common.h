@@ -47,6 +47,7 @@
 
 #include "slurm/slurm_errno.h"
 #include "src/common/list.h"
+#include "src/common/slurm_time.h"
 #include "src/common/xstring.h"
 
 #include <mysql.h>
@@ -69,6 +70,14 @@ typedef struct {
 	int conn;
 	uint64_t wsrep_trx_fragment_size_orig;
 	char *wsrep_trx_fragment_unit_orig;
+	char *batch_query;	/* queued statements not yet sent */
+	char *batch_prefix;	/* open multi-row insert, "insert ... values " */
+	char *batch_values;	/* rows of the open insert */
+	char *batch_suffix;	/* "on duplicate key update ..." of open insert */
+	uint32_t batch_cnt;	/* statements and rows queued */
+	timespec_t batch_deadline; /* send the batch after this time */
+	uint32_t batch_max_rows; /* 0 to run statements right away */
+	uint32_t batch_max_delay; /* milliseconds */
 } mysql_conn_t;
 
 typedef struct {
@@ -81,6 +90,8 @@ typedef struct {
 	char *pass_script;
 	time_t token_expires;
 	uint32_t token_duration;
+	uint32_t batch_max_rows;
+	uint32_t batch_max_delay;
 	pthread_mutex_t token_lock;
 } mysql_db_info_t;
 
@@ -111,6 +122,26 @@ extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query);
 
 extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query);
 
+/*
+ * Queue a statement that returns no data. Queued statements are sent to the
+ * database together before any other query on mysql_conn, on commit, or once
+ * batch_max_rows or batch_max_delay is reached. Runs the statement right away
+ * if batching is disabled on mysql_conn.
+ * NOTE: errors from queued statements are only logged.
+ */
+extern int mysql_db_batch_query(mysql_conn_t *mysql_conn, char *query);
+
+/*
+ * Same as mysql_db_batch_query() for "<prefix><values><suffix>". Consecutive
+ * inserts with the same prefix and suffix are merged into one multi-row
+ * insert, so the suffix must use VALUES() to refer to the row being added.
+ */
+extern int mysql_db_batch_insert(mysql_conn_t *mysql_conn, char *prefix,
+				 char *values, char *suffix);
+
+/* Send any statements queued on mysql_conn */
+extern int mysql_db_batch_flush(mysql_conn_t *mysql_conn);
+
 extern int mysql_db_create_table(mysql_conn_t *mysql_conn, char *table_name,
 				 storage_field_t *fields, char *ending);
 extern int mysql_db_get_var_str(mysql_conn_t *mysql_conn,
@@ -203,6 +203,9 @@ typedef struct slurm_acct_storage_ops {
 	int  (*job_suspend)        (void *db_conn, job_record_t *job_ptr);
 	list_t *(*get_jobs_cond)   (void *db_conn, uint32_t uid,
 				    slurmdb_job_cond_t *job_cond);
+	int (*foreach_job)         (void *db_conn, uint32_t uid,
+				    slurmdb_job_cond_t *job_cond,
+				    ListForF func, void *arg);
 	int (*archive_dump)        (void *db_conn,
 				    slurmdb_archive_cond_t *arch_cond);
 	int (*archive_load)        (void *db_conn,
@@ -294,6 +297,7 @@ static const char *syms[] = {
 	"jobacct_storage_p_step_complete",
 	"jobacct_storage_p_suspend",
 	"jobacct_storage_p_get_jobs_cond",
+	"jobacct_storage_p_foreach_job",
 	"jobacct_storage_p_archive",
 	"jobacct_storage_p_archive_load",
 	"acct_storage_p_update_shares_used",
@@ -1265,6 +1269,18 @@ extern list_t *jobacct_storage_g_get_jobs_cond(void *db_conn, uint32_t uid,
 	return ret_list;
 }
 
+extern int jobacct_storage_g_foreach_job(void *db_conn, uint32_t uid,
+					 slurmdb_job_cond_t *job_cond,
+					 ListForF func, void *arg)
+{
+	xassert(plugin_inited != PLUGIN_NOT_INITED);
+
+	if (plugin_inited == PLUGIN_NOOP)
+		return SLURM_SUCCESS;
+
+	return (*(ops.foreach_job))(db_conn, uid, job_cond, func, arg);
+}
+
 /*
  * expire old info from the storage
  */
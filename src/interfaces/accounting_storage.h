@@ -696,6 +696,17 @@ extern int jobacct_storage_g_job_suspend(void *db_conn,
 extern list_t *jobacct_storage_g_get_jobs_cond(void *db_conn, uint32_t uid,
 					       slurmdb_job_cond_t *job_cond);
 
+/*
+ * get info from the storage one job at a time
+ * IN func - called with each slurmdb_job_rec_t, which is freed once func
+ *	returns. Return a negative value to stop.
+ * NOTE: jobs are given in storage order and are not sorted across clusters
+ * RET SLURM_SUCCESS or error
+ */
+extern int jobacct_storage_g_foreach_job(void *db_conn, uint32_t uid,
+					 slurmdb_job_cond_t *job_cond,
+					 ListForF func, void *arg);
+
 /*
  * expire old info from the storage
  */
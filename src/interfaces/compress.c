@@ -36,13 +36,19 @@
 #include <pthread.h>
 
 #include "src/common/list.h"
+#include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/pack.h"
 #include "src/common/plugin.h"
+#include "src/common/read_config.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/compress.h"
 
+/* Most compressed output per block packed by compress_g_pack_buf() */
+#define COMPRESS_BLOCK_SIZE (512 * 1024)
+
 typedef struct compress_ops {
 	uint32_t *plugin_id;
 	ssize_t (*compress_p_comp_block)(char **in_buf,
@@ -214,3 +220,114 @@ done:
 	slurm_rwlock_unlock(&context_lock);
 	return rc;
 }
+
+extern bool compress_g_available(const int type)
+{
+	if (compress_g_init() != SLURM_SUCCESS)
+		return false;
+
+	return (compress_g_type_available(type) == SLURM_SUCCESS);
+}
+
+/*
+ * Packed as:
+ *	uint16_t type
+ * followed by the uncompressed data when type is COMPRESS_PLUGIN_NONE, else:
+ *	uint32_t uncompressed size
+ *	blocks of uint32_t uncompressed block size, packmem() compressed block
+ */
+extern bool compress_g_pack_buf(const int type, buf_t *src,
+				const uint32_t min_size, buf_t *buffer)
+{
+	uint32_t size = get_buf_offset(src);
+	uint32_t start = get_buf_offset(buffer);
+	char *in_buf = get_buf_data(src), *block = NULL;
+	ssize_t remaining = size;
+
+	if ((type == COMPRESS_PLUGIN_NONE) || !min_size || (size < min_size) ||
+	    !compress_g_available(type))
+		goto uncompressed;
+
+	block = xmalloc(COMPRESS_BLOCK_SIZE);
+	pack16(type, buffer);
+	pack32(size, buffer);
+
+	while (remaining > 0) {
+		ssize_t block_remaining = remaining, comp_size;
+
+		comp_size = compress_g_comp_block(type, &in_buf, size, &block,
+						  COMPRESS_BLOCK_SIZE,
+						  &remaining);
+		if (comp_size <= 0)
+			break;
+
+		pack32((block_remaining - remaining), buffer);
+		packmem(block, comp_size, buffer);
+
+		/* give up once it is clear there is nothing to gain */
+		if ((get_buf_offset(buffer) - start) >= size)
+			break;
+	}
+	xfree(block);
+
+	if (!remaining && ((get_buf_offset(buffer) - start) < size)) {
+		log_flag(NET, "%s: compressed %u bytes to %u bytes",
+			 __func__, size, (get_buf_offset(buffer) - start));
+		return true;
+	}
+
+	set_buf_offset(buffer, start);
+uncompressed:
+	pack16(COMPRESS_PLUGIN_NONE, buffer);
+	packmem_array(get_buf_data(src), size, buffer);
+	return false;
+}
+
+extern int compress_g_unpack_buf(buf_t **dst, buf_t *buffer)
+{
+	uint16_t type;
+	uint32_t size, offset = 0;
+	buf_t *out = NULL;
+
+	*dst = NULL;
+
+	safe_unpack16(&type, buffer);
+	if (type == COMPRESS_PLUGIN_NONE)
+		return SLURM_SUCCESS;
+
+	if (!compress_g_available(type)) {
+		error("%s: compression type %hu not supported",
+		      __func__, type);
+		return SLURM_ERROR;
+	}
+
+	safe_unpack32(&size, buffer);
+	if (size > MAX_BUF_SIZE)
+		goto unpack_error;
+	if (!(out = try_init_buf(size)))
+		goto unpack_error;
+
+	while (offset < size) {
+		uint32_t block_size, comp_size;
+		char *comp = NULL, *data;
+
+		safe_unpack32(&block_size, buffer);
+		safe_unpackmem_ptr(&comp, &comp_size, buffer);
+		if (!block_size || !comp_size || (block_size > (size - offset)))
+			goto unpack_error;
+
+		if (!(data = compress_g_decompress(type, comp, comp_size,
+						   block_size)))
+			goto unpack_error;
+		memcpy(&out->head[offset], data, block_size);
+		xfree(data);
+		offset += block_size;
+	}
+
+	*dst = out;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	FREE_NULL_BUFFER(out);
+	return SLURM_ERROR;
+}
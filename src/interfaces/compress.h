@@ -36,6 +36,11 @@
 #ifndef _INTERFACES_COMPRESS_H
 #define _INTERFACES_COMPRESS_H
 
+#include "src/common/pack.h"
+
+/* Smallest payload compress_g_pack_buf() compresses by default */
+#define COMPRESS_MIN_SIZE (64 * 1024)
+
 extern int compress_g_init(void);
 extern void compress_g_fini(void);
 
@@ -51,6 +56,12 @@ extern void compress_g_fini(void);
  */
 extern int compress_g_type_available(const int type);
 
+/*
+ * Load the compression plugins on first use
+ * RET true if the requested plugin type is available
+ */
+extern bool compress_g_available(const int type);
+
 /*
  * Arguments:
  * 	int type - one of the compress_plugin_type enum values
@@ -80,4 +91,26 @@ extern char *compress_g_decompress(const int type, char *in_buf,
 				   const ssize_t in_size,
 				   const ssize_t out_size);
 
+/*
+ * Pack the contents of src into buffer, compressed with type if src holds at
+ * least min_size bytes and compression makes it smaller. Unpack with
+ * compress_g_unpack_buf().
+ * IN type - one of the compress_plugin_type enum values
+ * IN src - buffer holding get_buf_offset(src) bytes to pack
+ * IN min_size - smallest payload to compress, 0 to never compress
+ * IN/OUT buffer - destination of the pack
+ * RET true if the data was compressed
+ */
+extern bool compress_g_pack_buf(const int type, buf_t *src,
+				const uint32_t min_size, buf_t *buffer);
+
+/*
+ * Unpack data packed with compress_g_pack_buf()
+ * OUT dst - new buffer holding the decompressed data at offset 0, or NULL if
+ *	the data was not compressed and follows in buffer
+ * IN/OUT buffer - source of the unpack
+ * RET SLURM_SUCCESS or error
+ */
+extern int compress_g_unpack_buf(buf_t **dst, buf_t *buffer);
+
 #endif
@@ -94,6 +94,9 @@ typedef struct {
 	bool (*is_complex)(void *arg);
 	bool (*is_deprecated)(void *arg);
 	int (*dump_flags)(void *arg, data_t *dst);
+	int (*dump_emit)(void *arg, data_parser_type_t type, void *src,
+			 ssize_t src_bytes,
+			 const data_parser_emitter_t *emitter);
 } parse_funcs_t;
 
 typedef struct {
@@ -119,6 +122,7 @@ static const char *parse_syms[] = {
 	"data_parser_p_is_complex",
 	"data_parser_p_is_deprecated",
 	"data_parser_p_dump_flags",
+	"data_parser_p_dump_emit",
 };
 
 static plugins_t *plugins = NULL;
@@ -185,6 +189,35 @@ extern int data_parser_g_dump(data_parser_t *parser, data_parser_type_t type,
 	return rc;
 }
 
+extern int data_parser_g_dump_emit(data_parser_t *parser,
+				   data_parser_type_t type, void *src,
+				   ssize_t src_bytes,
+				   const data_parser_emitter_t *emitter)
+{
+	DEF_TIMERS;
+	int rc;
+	const parse_funcs_t *funcs;
+
+	if (!parser)
+		return ESLURM_DATA_INVALID_PARSER;
+
+	funcs = plugins->functions[parser->plugin_offset];
+
+	xassert(emitter);
+	xassert(type > DATA_PARSER_TYPE_INVALID);
+	xassert(type < DATA_PARSER_TYPE_MAX);
+	xassert(parser->magic == PARSE_MAGIC);
+	xassert(plugins && (plugins->magic == PLUGINS_MAGIC));
+	xassert(parser->plugin_offset < plugins->count);
+	xassert(plugins->functions[parser->plugin_offset]);
+
+	START_TIMER;
+	rc = funcs->dump_emit(parser->arg, type, src, src_bytes, emitter);
+	END_TIMER2(__func__);
+
+	return rc;
+}
+
 /* takes ownership of params */
 static data_parser_t *_new_parser(data_parser_on_error_t on_parse_error,
 				  data_parser_on_error_t on_dump_error,
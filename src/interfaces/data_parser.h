@@ -865,6 +865,11 @@ typedef enum {
 	DATA_PARSER_ATTR_DBCONN_PTR, /* return of slurmdb_connection_get() - will not xfree */
 	DATA_PARSER_ATTR_QOS_LIST, /* List<slurmdb_qos_rec_t *> - will xfree() */
 	DATA_PARSER_ATTR_TRES_LIST, /* List<slurmdb_tres_rec_t *> - will xfree() */
+	/*
+	 * List<char *> of field keys - will xfree()
+	 * Only dump these fields of each record in dumped record lists
+	 */
+	DATA_PARSER_ATTR_FIELDS,
 	DATA_PARSER_ATTR_MAX /* place holder - do not use */
 } data_parser_attr_type_t;
 
@@ -967,6 +972,42 @@ extern int data_parser_g_dump(data_parser_t *parser, data_parser_type_t type,
 #define DATA_DUMP(parser, type, src, dst) \
 	data_parser_g_dump(parser, DATA_PARSER_##type, &src, sizeof(src), dst)
 
+/*
+ * Callbacks to receive a dump while it is generated instead of as a complete
+ * data_t tree. Every value is either a full data_t or is built up by
+ * dict_begin()/dict_key()/dict_end() and list_begin()/list_end() calls.
+ * Each callback returns SLURM_SUCCESS or error to abort dumping.
+ */
+typedef struct {
+	int (*dict_begin)(void *arg);
+	int (*dict_key)(void *arg, const char *key);
+	int (*dict_end)(void *arg);
+	int (*list_begin)(void *arg);
+	int (*list_end)(void *arg);
+	/* value is only valid during call */
+	int (*value)(void *arg, const data_t *value);
+	void *arg; /* arg to pass to every callback */
+} data_parser_emitter_t;
+
+/*
+ * Dump given target struct src directly to emitter
+ * Only a single record should be held as data_t at any one time.
+ *
+ * IN parser - return from data_parser_g_new()
+ * IN type - type of obj
+ * IN src - ptr to struct/scalar to dump
+ * 	This *must* be a pointer to the object and not just a value of the object.
+ * IN src_bytes - size of object pointed to by src
+ * IN emitter - callbacks to receive dump
+ * RET SLURM_SUCCESS or error
+ * 	ESLURM_NOT_SUPPORTED if plugin can not emit type (before calling
+ * 	emitter)
+ */
+extern int data_parser_g_dump_emit(data_parser_t *parser,
+				   data_parser_type_t type, void *src,
+				   ssize_t src_bytes,
+				   const data_parser_emitter_t *emitter);
+
 /*
  * Get the OpenAPI type for a given parser's field
  * IN parser - parser to query
@@ -67,9 +67,9 @@ typedef struct {
 	int (*data_to_string)(char **dest, size_t *length, const data_t *src,
 			      serializer_flags_t flags);
 	int (*string_to_data)(data_t **dest, const char *src, size_t length);
-	int (*dump)(serialize_dump_state_t **state_ptr, data_parser_type_t type,
-		    void *src, ssize_t src_bytes, buf_t *dst,
-		    serializer_flags_t flags);
+	int (*dump)(serialize_dump_state_t **state_ptr, data_parser_t *parser,
+		    data_parser_type_t type, void *src, ssize_t src_bytes,
+		    buf_t *dst, serializer_flags_t flags);
 	int (*parse)(serialize_parse_state_t **state_ptr,
 		     data_parser_type_t type, void *dst, ssize_t dst_bytes,
 		     const buf_t *src);
@@ -457,7 +457,8 @@ extern int serialize_g_dump(serialize_dump_state_t **state_ptr,
 	func_ptr = plugins->functions[pmt->index];
 
 	START_TIMER;
-	rc = (*func_ptr->dump)(state_ptr, type, src, src_bytes, dst, flags);
+	rc = (*func_ptr->dump)(state_ptr, parser, type, src, src_bytes, dst,
+			       flags);
 	END_TIMER2(__func__);
 
 	return rc;
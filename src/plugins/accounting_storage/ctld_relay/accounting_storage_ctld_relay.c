@@ -671,6 +671,13 @@ extern list_t *jobacct_storage_p_get_jobs_cond(void *db_conn, uid_t uid,
 	return NULL;
 }
 
+extern int jobacct_storage_p_foreach_job(void *db_conn, uid_t uid,
+					 slurmdb_job_cond_t *job_cond,
+					 ListForF func, void *arg)
+{
+	return SLURM_SUCCESS;
+}
+
 /*
  * Expire old info from the storage
  * Not applicable for any database
@@ -3735,6 +3735,22 @@ extern list_t *jobacct_storage_p_get_jobs_cond(mysql_conn_t *mysql_conn,
 	return job_list;
 }
 
+extern int jobacct_storage_p_foreach_job(mysql_conn_t *mysql_conn, uid_t uid,
+					 slurmdb_job_cond_t *job_cond,
+					 ListForF func, void *arg)
+{
+	list_t *job_list;
+
+	if (!(job_list = jobacct_storage_p_get_jobs_cond(mysql_conn, uid,
+							 job_cond)))
+		return (errno ? errno : SLURM_ERROR);
+
+	(void) list_for_each(job_list, func, arg);
+	FREE_NULL_LIST(job_list);
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * expire old info from the storage
  */
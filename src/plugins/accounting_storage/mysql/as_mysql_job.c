@@ -944,7 +944,7 @@ extern int as_mysql_job_heavy(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 		return rc;
 
 	DB_DEBUG(DB_JOB, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_batch_query(mysql_conn, query);
 	xfree(query);
 
 	return rc;
@@ -1379,7 +1379,7 @@ extern int as_mysql_job_complete(mysql_conn_t *mysql_conn,
 	xstrfmtcat(query, "where job_db_inx=%"PRIu64";", job_ptr->db_index);
 
 	DB_DEBUG(DB_JOB, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_batch_query(mysql_conn, query);
 	xfree(query);
 
 	return rc;
@@ -1394,7 +1394,7 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 	char *node_list = NULL;
 	char *node_inx = NULL;
 	time_t start_time, submit_time;
-	char *query = NULL;
+	char *query = NULL, *values = NULL, *suffix = NULL;
 
 	if (!step_ptr->job_ptr->db_index
 	    && ((!step_ptr->job_ptr->details
@@ -1515,8 +1515,10 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 	if (step_ptr->container)
 		xstrcat(query, ", container");
 
-	xstrfmtcat(query,
-		   ") values (%"PRIu64", %d, %u, %d, %u, '%s', %d, '%s', %d, "
+	xstrcat(query, ") values ");
+
+	xstrfmtcat(values,
+		   "(%"PRIu64", %d, %u, %d, %u, '%s', %d, '%s', %d, "
 		   "%d, '%s', '%s', %d, %u, %u, %u",
 		   step_ptr->job_ptr->db_index,
 		   step_ptr->step_id.step_id,
@@ -1528,46 +1530,54 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 		   step_ptr->cpu_freq_gov);
 
 	if (step_ptr->cwd)
-		xstrfmtcat(query, ", '%s'", step_ptr->cwd);
+		xstrfmtcat(values, ", '%s'", step_ptr->cwd);
 	if (step_ptr->std_err)
-		xstrfmtcat(query, ", '%s'", step_ptr->std_err);
+		xstrfmtcat(values, ", '%s'", step_ptr->std_err);
 	if (step_ptr->std_in)
-		xstrfmtcat(query, ", '%s'", step_ptr->std_in);
+		xstrfmtcat(values, ", '%s'", step_ptr->std_in);
 	if (step_ptr->std_out)
-		xstrfmtcat(query, ", '%s'", step_ptr->std_out);
+		xstrfmtcat(values, ", '%s'", step_ptr->std_out);
 	if (step_ptr->submit_line)
-		xstrfmtcat(query, ", '%s'", step_ptr->submit_line);
+		xstrfmtcat(values, ", '%s'", step_ptr->submit_line);
 	if (step_ptr->container)
-		xstrfmtcat(query, ", '%s'", step_ptr->container);
+		xstrfmtcat(values, ", '%s'", step_ptr->container);
 
-	xstrfmtcat(query,
-		   ") on duplicate key update "
-		   "nodes_alloc=%d, task_cnt=%d, time_end=0, timelimit=%u, "
-		   "state=%d, nodelist='%s', node_inx='%s', task_dist=%d, "
-		   "req_cpufreq=%u, req_cpufreq_min=%u, req_cpufreq_gov=%u,"
-		   "tres_alloc='%s'",
-		   nodes, tasks, step_ptr->time_limit, step_ptr->state,
-		   node_list, node_inx, task_dist, step_ptr->cpu_freq_max,
-		   step_ptr->cpu_freq_min, step_ptr->cpu_freq_gov,
-		   step_ptr->tres_alloc_str);
+	xstrcat(values, ")");
+
+	/*
+	 * Use VALUES() so steps with the same columns can be sent as one
+	 * multi-row insert.
+	 */
+	xstrcat(suffix,
+		" on duplicate key update "
+		"nodes_alloc=VALUES(nodes_alloc), task_cnt=VALUES(task_cnt), "
+		"time_end=0, timelimit=VALUES(timelimit), "
+		"state=VALUES(state), nodelist=VALUES(nodelist), "
+		"node_inx=VALUES(node_inx), task_dist=VALUES(task_dist), "
+		"req_cpufreq=VALUES(req_cpufreq), "
+		"req_cpufreq_min=VALUES(req_cpufreq_min), "
+		"req_cpufreq_gov=VALUES(req_cpufreq_gov), "
+		"tres_alloc=VALUES(tres_alloc)");
 
 	if (step_ptr->cwd)
-		xstrfmtcat(query, ", cwd='%s'", step_ptr->cwd);
+		xstrcat(suffix, ", cwd=VALUES(cwd)");
 	if (step_ptr->std_err)
-		xstrfmtcat(query, ", std_err='%s'", step_ptr->std_err);
+		xstrcat(suffix, ", std_err=VALUES(std_err)");
 	if (step_ptr->std_in)
-		xstrfmtcat(query, ", std_in='%s'", step_ptr->std_in);
+		xstrcat(suffix, ", std_in=VALUES(std_in)");
 	if (step_ptr->std_out)
-		xstrfmtcat(query, ", std_out='%s'", step_ptr->std_out);
+		xstrcat(suffix, ", std_out=VALUES(std_out)");
 	if (step_ptr->submit_line)
-		xstrfmtcat(query, ", submit_line='%s'", step_ptr->submit_line);
-
+		xstrcat(suffix, ", submit_line=VALUES(submit_line)");
 	if (step_ptr->container)
-		xstrfmtcat(query, ", container='%s'", step_ptr->container);
+		xstrcat(suffix, ", container=VALUES(container)");
 
-	DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s%s%s",
+		 query, values, suffix);
+	rc = mysql_db_batch_insert(mysql_conn, query, values, suffix);
 	xfree(query);
+	xfree(values);
+	xfree(suffix);
 
 	return rc;
 }
@@ -1816,7 +1826,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 		   step_ptr->job_ptr->db_index, step_ptr->step_id.step_id,
 		   step_ptr->step_id.step_het_comp);
 	DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_batch_query(mysql_conn, query);
 	xfree(query);
 
 	/* set the energy for the entire job. */
@@ -1829,7 +1839,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			step_ptr->job_ptr->tres_alloc_str, derived_ec_str,
 			step_ptr->job_ptr->db_index);
 		DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = mysql_db_batch_query(mysql_conn, query);
 		xfree(query);
 		xfree(derived_ec_str);
 	} else if (exit_code &&
@@ -1842,7 +1852,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			mysql_conn->cluster_name, job_table, derived_ec_str,
 			step_ptr->job_ptr->db_index);
 		DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = mysql_db_batch_query(mysql_conn, query);
 		xfree(query);
 		xfree(derived_ec_str);
 	}
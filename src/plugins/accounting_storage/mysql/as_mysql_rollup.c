@@ -42,6 +42,7 @@
 #include "as_mysql_archive.h"
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 
 enum {
 	TIME_ALLOC,
@@ -70,7 +71,7 @@ typedef struct {
 
 typedef struct {
 	int id;
-	int id_alt;
+	int id_alt; /* must follow id, see _id_usage_hash_id() */
 	list_t *loc_tres;
 } local_id_usage_t;
 
@@ -141,16 +142,6 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
-{
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
-
-	if (loc->id == id)
-		return 1;
-	return 0;
-}
-
 static int _find_id_alt_usage(void *x, void *key)
 {
 	local_id_usage_t *loc = x;
@@ -162,6 +153,46 @@ static int _find_id_alt_usage(void *x, void *key)
 	return 0;
 }
 
+static void _id_usage_hash_id(void *item, const char **key, uint32_t *key_len)
+{
+	local_id_usage_t *usage = item;
+
+	/* id and id_alt are adjacent so both are hashed as the key */
+	*key = (const char *) &usage->id;
+	*key_len = sizeof(usage->id) + sizeof(usage->id_alt);
+}
+
+/*
+ * Find the usage record matching id and id_alt or add a new one to
+ * usage_list and usage_hash.
+ * IN make_tres - create loc_tres for a new record
+ */
+static local_id_usage_t *_get_id_usage(list_t *usage_list, xhash_t *usage_hash,
+				       int id, int id_alt, bool make_tres)
+{
+	local_id_usage_t key = {
+		.id = id,
+		.id_alt = id_alt,
+	};
+	local_id_usage_t *usage;
+	const char *key_str;
+	uint32_t key_len;
+
+	_id_usage_hash_id(&key, &key_str, &key_len);
+	if ((usage = xhash_get(usage_hash, key_str, key_len)))
+		return usage;
+
+	usage = xmalloc(sizeof(*usage));
+	usage->id = id;
+	usage->id_alt = id_alt;
+	if (make_tres)
+		usage->loc_tres = list_create(_destroy_local_tres_usage);
+	list_append(usage_list, usage);
+	xhash_add(usage_hash, usage);
+
+	return usage;
+}
+
 static void _remove_job_tres_time_from_cluster(list_t *c_tres, list_t *j_tres,
 					       int seconds)
 {
@@ -1285,6 +1316,7 @@ static void _add_planned_time(local_cluster_usage_t *c_usage, time_t job_start,
 }
 
 static local_id_usage_t *_check_q_usage(list_t *qos_usage_list,
+					xhash_t *qos_usage_hash,
 					local_id_usage_t *curr_q_usage,
 					local_id_usage_t *id_usage)
 {
@@ -1294,19 +1326,8 @@ static local_id_usage_t *_check_q_usage(list_t *qos_usage_list,
 	if (curr_q_usage && _find_id_alt_usage(curr_q_usage, id_usage))
 		return curr_q_usage;
 
-	curr_q_usage = list_find_first(qos_usage_list,
-				       _find_id_alt_usage,
-				       id_usage);
-	if (!curr_q_usage) {
-		curr_q_usage = xmalloc(sizeof(*curr_q_usage));
-		curr_q_usage->id = id_usage->id;
-		curr_q_usage->id_alt = id_usage->id_alt;
-		list_append(qos_usage_list, curr_q_usage);
-		curr_q_usage->loc_tres = list_create(
-			_destroy_local_tres_usage);
-	}
-
-	return curr_q_usage;
+	return _get_id_usage(qos_usage_list, qos_usage_hash, id_usage->id,
+			     id_usage->id_alt, true);
 }
 
 extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
@@ -1340,6 +1361,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	local_id_usage_t *a_usage = NULL;
 	local_id_usage_t *q_usage = NULL;
 	local_id_usage_t *w_usage = NULL;
+	xhash_t *assoc_usage_hash = NULL;
+	xhash_t *qos_usage_hash = NULL;
+	xhash_t *wckey_usage_hash = NULL;
+	uint64_t job_rows = 0;
+	timespec_t ts_start = timespec_now();
 	/* char start_char[20], end_char[20]; */
 
 	char *job_req_inx[] = {
@@ -1400,6 +1426,10 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	qos_usage_list = list_create(_destroy_local_id_usage);
 	wckey_usage_list = list_create(_destroy_local_id_usage);
 	resv_usage_list = list_create(_destroy_local_resv_usage);
+	/* Index into the lists above, which own the records */
+	assoc_usage_hash = xhash_init(_id_usage_hash_id, NULL);
+	qos_usage_hash = xhash_init(_id_usage_hash_id, NULL);
+	wckey_usage_hash = xhash_init(_id_usage_hash_id, NULL);
 
 	i=0;
 	xstrfmtcat(job_str, "%s", job_req_inx[i]);
@@ -1510,6 +1540,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				.id_alt = qos_id,
 			};
 
+			job_rows++;
+
 			if (row_start && (row_start < curr_start))
 				row_start = curr_start;
 
@@ -1575,17 +1607,18 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			 * Do the qos calculation check the assoc_id now since
 			 * it will change in the next if
 			 */
-			q_usage = _check_q_usage(qos_usage_list, q_usage,
-						 &id_usage);
+			q_usage = _check_q_usage(qos_usage_list, qos_usage_hash,
+						 q_usage, &id_usage);
 
 			if (last_id != assoc_id) {
-				a_usage = xmalloc(sizeof(local_id_usage_t));
-				a_usage->id = assoc_id;
-				list_append(assoc_usage_list, a_usage);
+				/*
+				 * a_usage->loc_tres is made later,
+				 * don't do it here.
+				 */
+				a_usage = _get_id_usage(assoc_usage_list,
+							assoc_usage_hash,
+							assoc_id, 0, false);
 				last_id = assoc_id;
-				/* a_usage->loc_tres is made later,
-				   don't do it here.
-				*/
 			}
 
 			/* Short circuit this so so we don't get a pointer. */
@@ -1594,20 +1627,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
-
-				if (!w_usage) {
-					w_usage = xmalloc(
-						sizeof(local_id_usage_t));
-					w_usage->id = wckey_id;
-					list_append(wckey_usage_list,
-						    w_usage);
-					w_usage->loc_tres = list_create(
-						_destroy_local_tres_usage);
-				}
+				w_usage = _get_id_usage(wckey_usage_list,
+							wckey_usage_hash,
+							wckey_id, 0, true);
 				last_wckeyid = wckey_id;
 			}
 
@@ -1851,8 +1873,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 					if (id_usage.id_alt) {
 						q_usage = _check_q_usage(
-							qos_usage_list, q_usage,
-							&id_usage);
+							qos_usage_list,
+							qos_usage_hash,
+							q_usage, &id_usage);
 
 						_add_time_tres(
 							q_usage->loc_tres,
@@ -1862,20 +1885,15 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 							0);
 					}
 
-					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
-						a_usage = xmalloc(
-							sizeof(local_id_usage_t));
-						a_usage->id = associd;
-						list_append(assoc_usage_list,
-							    a_usage);
+					if (last_id != associd)
+						a_usage = _get_id_usage(
+							assoc_usage_list,
+							assoc_usage_hash,
+							associd, 0, true);
+					last_id = associd;
+					if (!a_usage->loc_tres)
 						a_usage->loc_tres = list_create(
 							_destroy_local_tres_usage);
-					}
-					last_id = associd;
 
 					_add_time_tres(a_usage->loc_tres,
 						       TIME_ALLOC, loc_tres->id,
@@ -1981,6 +1999,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		q_usage     = NULL;
 		w_usage     = NULL;
 
+		xhash_clear(assoc_usage_hash);
+		xhash_clear(qos_usage_hash);
+		xhash_clear(wckey_usage_hash);
 		list_flush(assoc_usage_list);
 		list_flush(cluster_down_list);
 		list_flush(qos_usage_list);
@@ -2006,12 +2027,26 @@ end_it:
 	if (r_itr)
 		list_iterator_destroy(r_itr);
 
+	xhash_free(assoc_usage_hash);
+	xhash_free(qos_usage_hash);
+	xhash_free(wckey_usage_hash);
 	FREE_NULL_LIST(assoc_usage_list);
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(qos_usage_list);
 	FREE_NULL_LIST(wckey_usage_list);
 	FREE_NULL_LIST(resv_usage_list);
 
+	if (slurm_conf.debug_flags & DEBUG_FLAG_DB_USAGE) {
+		double secs = timespec_to_secs(timespec_rem(timespec_now(),
+							    ts_start));
+
+		DB_DEBUG(DB_USAGE, mysql_conn->conn,
+			 "%s: hourly rollup of %s processed %"PRIu64" job rows for %ld hours in %.3f seconds (%.0f rows/sec)",
+			 __func__, cluster_name, job_rows,
+			 ((curr_start - start) / add_sec), secs,
+			 (secs > 0 ? (job_rows / secs) : 0));
+	}
+
 /* 	info("stop start %s", slurm_ctime2(&curr_start)); */
 /* 	info("stop end %s", slurm_ctime2(&curr_end)); */
 
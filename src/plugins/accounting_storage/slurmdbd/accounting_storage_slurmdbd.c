@@ -2939,6 +2939,97 @@ extern list_t *jobacct_storage_p_get_jobs_cond(void *db_conn, uid_t uid,
 	return my_job_list;
 }
 
+extern int jobacct_storage_p_foreach_job(void *db_conn, uid_t uid,
+					 slurmdb_job_cond_t *job_cond,
+					 ListForF func, void *arg)
+{
+	persist_msg_t req = {0}, resp = {0};
+	dbd_cond_msg_t get_msg = {0};
+	uint32_t orig_flags;
+	bool stop = false;
+	int rc;
+
+	if (running_in_slurmctld()) {
+		/*
+		 * The agent owns the connection in slurmctld so only ask for
+		 * a single response.
+		 */
+		list_t *job_list;
+
+		if (!(job_list = jobacct_storage_p_get_jobs_cond(db_conn, uid,
+								 job_cond)))
+			return (errno ? errno : SLURM_ERROR);
+		(void) list_for_each(job_list, func, arg);
+		FREE_NULL_LIST(job_list);
+		return SLURM_SUCCESS;
+	}
+
+	get_msg.cond = job_cond;
+
+	req.msg_type = DBD_GET_JOBS_COND;
+	req.pcon = db_conn;
+	req.data = &get_msg;
+
+	/*
+	 * Older slurmdbd ignore JOBCOND_FLAG_STREAM and reply with a single
+	 * DBD_GOT_JOBS which is handled the same way below.
+	 */
+	orig_flags = job_cond->flags;
+	job_cond->flags |= JOBCOND_FLAG_STREAM;
+	rc = dbd_conn_send_recv_direct(SLURM_PROTOCOL_VERSION, &req, &resp);
+	job_cond->flags = orig_flags;
+
+	while (rc == SLURM_SUCCESS) {
+		dbd_list_msg_t *got_msg;
+		bool last;
+
+		if (resp.msg_type == PERSIST_RC) {
+			persist_rc_msg_t *msg = resp.data;
+
+			if ((rc = msg->rc))
+				error("%s", msg->comment);
+			else
+				info("%s", msg->comment);
+			slurm_persist_free_rc_msg(msg);
+			break;
+		} else if ((resp.msg_type != DBD_GOT_JOBS) &&
+			   (resp.msg_type != DBD_GOT_JOBS_PART)) {
+			error("response type not DBD_GOT_JOBS: %u",
+			      resp.msg_type);
+			slurmdbd_free_msg(&resp);
+			rc = SLURM_ERROR;
+			break;
+		}
+
+		got_msg = resp.data;
+		last = (resp.msg_type == DBD_GOT_JOBS);
+
+		if (!got_msg->my_list) {
+			rc = got_msg->return_code;
+			error("%s", slurm_strerror(rc));
+		} else if (!stop &&
+			   (list_for_each(got_msg->my_list, func, arg) < 0)) {
+			/* Keep reading to leave the connection in sync */
+			stop = true;
+		}
+		slurmdbd_free_list_msg(got_msg);
+
+		if (last)
+			break;
+
+		memset(&resp, 0, sizeof(resp));
+		rc = dbd_conn_recv_direct(SLURM_PROTOCOL_VERSION, db_conn,
+					  &resp);
+	}
+
+	if (rc != SLURM_SUCCESS) {
+		error("DBD_GET_JOBS_COND failure: %s", slurm_strerror(rc));
+		errno = rc;
+	}
+
+	return rc;
+}
+
 /*
  * Expire old info from the storage
  * Not applicable for any database
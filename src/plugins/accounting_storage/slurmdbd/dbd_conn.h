@@ -73,6 +73,16 @@ extern int dbd_conn_send_recv_direct(uint16_t rpc_version,
 				     persist_msg_t *req,
 				     persist_msg_t *resp);
 
+/*
+ * Wait for another reply message to an RPC already sent with
+ * dbd_conn_send_recv_direct() (e.g. DBD_GOT_JOBS_PART).
+ *
+ * The "resp" message must be freed by the caller.
+ * Returns SLURM_SUCCESS or an error code
+ */
+extern int dbd_conn_recv_direct(uint16_t rpc_version, persist_conn_t *pc,
+				persist_msg_t *resp);
+
 /*
  * Send an RPC to the SlurmDBD and wait for the return code reply (fill in
  * comment as well if comment != NULL.
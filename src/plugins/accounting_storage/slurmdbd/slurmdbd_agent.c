@@ -37,6 +37,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <dirent.h>
+
 #include "src/common/slurm_xlator.h"
 
 #include "src/common/fd.h"
@@ -48,7 +50,8 @@
 
 enum {
 	MAX_DBD_ACTION_DISCARD,
-	MAX_DBD_ACTION_EXIT
+	MAX_DBD_ACTION_EXIT,
+	MAX_DBD_ACTION_SPOOL
 };
 
 typedef struct {
@@ -62,6 +65,9 @@ persist_conn_t *slurmdbd_conn = NULL;
 #define DBD_MAGIC		0xDEAD3219
 #define DEBUG_PRINT_MAX_MSG_TYPES 10
 #define MAX_DBD_DEFAULT_ACTION MAX_DBD_ACTION_DISCARD
+#define DBD_SPOOL_PREFIX	"dbd.spool."
+#define DBD_SPOOL_SEGMENT_MSGS	5000	/* records per spool segment file */
+#define DBD_SPOOL_LOAD_CNT	1000	/* refill agent_list below this */
 
 static pthread_mutex_t agent_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
@@ -78,6 +84,22 @@ static pthread_cond_t  slurmdbd_cond = PTHREAD_COND_INITIALIZER;
 
 static int max_dbd_msg_action = MAX_DBD_DEFAULT_ACTION;
 
+/*
+ * Segmented append-only spool of messages that did not fit in agent_list.
+ * Segments are named DBD_SPOOL_PREFIX<number> in StateSaveLocation and are
+ * numbered from head (oldest) up to next (exclusive). Every message in
+ * agent_list is older than any spooled message. Protected by agent_lock.
+ */
+static struct {
+	uint32_t head;		/* oldest segment to load */
+	uint32_t next;		/* number of the next segment to create */
+	int tail_fd;		/* open segment being appended to or -1 */
+	uint32_t tail_cnt;	/* records written to tail_fd */
+	uint32_t cnt;		/* total spooled records */
+} spool = {
+	.tail_fd = -1,
+};
+
 typedef struct {
 	list_t *id_rc_list;
 	int rc;
@@ -384,14 +406,16 @@ static buf_t *_load_dbd_rec(int fd)
 	return buffer;
 }
 
-static void _load_dbd_state(void)
+/*
+ * Load every record in a state file into agent_list
+ * RET number of records recovered
+ */
+static int _load_dbd_file(const char *dbd_fname)
 {
-	char *dbd_fname = NULL;
 	buf_t *buffer;
 	int fd, recovered = 0;
 	uint16_t rpc_version = 0;
 
-	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
 	fd = open(dbd_fname, O_RDONLY);
 	if (fd < 0) {
 		/* don't print an error message if there is no file */
@@ -457,9 +481,20 @@ static void _load_dbd_state(void)
 		}
 
 	end_it:
-		verbose("recovered %d pending RPCs", recovered);
+		verbose("recovered %d pending RPCs from %s",
+			recovered, dbd_fname);
 		(void) close(fd);
 	}
+
+	return recovered;
+}
+
+static void _load_dbd_state(void)
+{
+	char *dbd_fname = NULL;
+
+	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
+	(void) _load_dbd_file(dbd_fname);
 	xfree(dbd_fname);
 }
 
@@ -563,6 +598,186 @@ end_it:
 	xfree(dbd_fname);
 }
 
+static char *_spool_fname(uint32_t seg)
+{
+	char *fname = NULL;
+
+	xstrfmtcat(fname, "%s/" DBD_SPOOL_PREFIX "%u",
+		   slurm_conf.state_save_location, seg);
+	return fname;
+}
+
+/* Count the records in a spool segment without reading them */
+static uint32_t _spool_count_recs(const char *fname)
+{
+	uint32_t cnt = 0, msg_size;
+	int fd;
+
+	if ((fd = open(fname, O_RDONLY)) < 0) {
+		error("%s: open(%s): %m", __func__, fname);
+		return 0;
+	}
+
+	while (read(fd, &msg_size, sizeof(msg_size)) == sizeof(msg_size)) {
+		if ((msg_size > MAX_BUF_SIZE) ||
+		    (lseek(fd, msg_size + sizeof(uint32_t), SEEK_CUR) < 0))
+			break;
+		cnt++;
+	}
+	(void) close(fd);
+
+	/* first record is the version header */
+	return (cnt ? (cnt - 1) : 0);
+}
+
+/*
+ * Find any spool segments left behind by a previous slurmctld
+ * NOTE: agent_lock must be locked
+ */
+static void _spool_init(void)
+{
+	DIR *f_dir;
+	struct dirent *dir_ent;
+	bool found = false;
+
+	spool.head = spool.next = spool.cnt = 0;
+
+	if (!(f_dir = opendir(slurm_conf.state_save_location))) {
+		error("opendir(%s): %m", slurm_conf.state_save_location);
+		return;
+	}
+
+	while ((dir_ent = readdir(f_dir))) {
+		char *endptr = NULL;
+		uint32_t seg;
+
+		if (xstrncmp(DBD_SPOOL_PREFIX, dir_ent->d_name,
+			     strlen(DBD_SPOOL_PREFIX)))
+			continue;
+		seg = strtoul(dir_ent->d_name + strlen(DBD_SPOOL_PREFIX),
+			      &endptr, 10);
+		if (!endptr || (endptr[0] != '\0'))
+			continue;
+
+		if (!found || (seg < spool.head))
+			spool.head = seg;
+		if (!found || (seg >= spool.next))
+			spool.next = seg + 1;
+		found = true;
+	}
+	closedir(f_dir);
+
+	for (uint32_t seg = spool.head; seg < spool.next; seg++) {
+		char *fname = _spool_fname(seg);
+		spool.cnt += _spool_count_recs(fname);
+		xfree(fname);
+	}
+
+	if (spool.cnt)
+		verbose("found %u spooled RPCs in %u segments",
+			spool.cnt, (spool.next - spool.head));
+}
+
+/*
+ * Finish writing the current spool segment
+ * NOTE: agent_lock must be locked
+ */
+static void _spool_close_tail(void)
+{
+	if (spool.tail_fd < 0)
+		return;
+
+	if (fsync_and_close(spool.tail_fd, DBD_SPOOL_PREFIX))
+		error("%s: error from fsync_and_close", __func__);
+	spool.tail_fd = -1;
+	spool.tail_cnt = 0;
+}
+
+/*
+ * Append a message to the spool instead of keeping it in memory
+ * NOTE: agent_lock must be locked
+ * RET SLURM_SUCCESS or error. buffer is only consumed on success.
+ */
+static int _spool_rec(buf_t *buffer)
+{
+	if (spool.tail_cnt >= DBD_SPOOL_SEGMENT_MSGS)
+		_spool_close_tail();
+
+	if (spool.tail_fd < 0) {
+		char curr_ver_str[10];
+		char *fname = _spool_fname(spool.next);
+		buf_t *ver_buf;
+		int rc;
+
+		spool.tail_fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC |
+				     O_CLOEXEC, 0600);
+		if (spool.tail_fd < 0) {
+			error("%s: Creating spool file %s: %m",
+			      __func__, fname);
+			xfree(fname);
+			return SLURM_ERROR;
+		}
+		xfree(fname);
+		spool.next++;
+
+		snprintf(curr_ver_str, sizeof(curr_ver_str),
+			 "VER%d", SLURM_PROTOCOL_VERSION);
+		ver_buf = init_buf(strlen(curr_ver_str));
+		packstr(curr_ver_str, ver_buf);
+		rc = _save_dbd_rec(spool.tail_fd, ver_buf);
+		FREE_NULL_BUFFER(ver_buf);
+		if (rc != SLURM_SUCCESS) {
+			_spool_close_tail();
+			return rc;
+		}
+	}
+
+	if (_save_dbd_rec(spool.tail_fd, buffer) != SLURM_SUCCESS) {
+		/* Start a new segment for the next record */
+		_spool_close_tail();
+		return SLURM_ERROR;
+	}
+
+	spool.tail_cnt++;
+	spool.cnt++;
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Move the oldest spool segment into agent_list
+ * NOTE: agent_lock must be locked
+ */
+static void _spool_load(void)
+{
+	char *fname;
+	int recovered;
+
+	if (spool.head == spool.next)
+		return;
+
+	/* The tail segment must be complete before it can be read */
+	if ((spool.head + 1) == spool.next)
+		_spool_close_tail();
+
+	fname = _spool_fname(spool.head);
+	recovered = _load_dbd_file(fname);
+	if (unlink(fname))
+		error("%s: unlink(%s): %m", __func__, fname);
+	xfree(fname);
+
+	spool.head++;
+	if (spool.head == spool.next) {
+		/* spool is empty, start numbering over */
+		spool.head = spool.next = spool.cnt = 0;
+	} else {
+		spool.cnt -= MIN(spool.cnt, recovered);
+	}
+
+	log_flag(DBD_AGENT, "loaded %d spooled RPCs, %u still spooled",
+		 recovered, spool.cnt);
+}
+
 /*
  * Purge queued records from the agent queue
  */
@@ -600,6 +815,11 @@ static int _purge_agent_list_req(void *x, void *arg)
 static void _max_dbd_msg_action(uint32_t *msg_cnt)
 {
 	int purged = 0;
+
+	/* Messages past MaxDBDMsgs go to the spool instead */
+	if (max_dbd_msg_action == MAX_DBD_ACTION_SPOOL)
+		return;
+
 	if (max_dbd_msg_action == MAX_DBD_ACTION_EXIT) {
 		if (*msg_cnt < slurm_conf.max_dbd_msgs)
 			return;
@@ -726,6 +946,11 @@ static void *_agent(void *x)
 
 		slurm_mutex_lock(&agent_lock);
 		cnt = list_count(agent_list);
+		if ((cnt < DBD_SPOOL_LOAD_CNT) && (spool.head != spool.next) &&
+		    slurmdbd_conn->conn) {
+			_spool_load();
+			cnt = list_count(agent_list);
+		}
 		if ((cnt == 0) || !slurmdbd_conn->conn ||
 		    (fail_time && (difftime(time(NULL), fail_time) < 10))) {
 			slurm_mutex_unlock(&slurmdbd_lock);
@@ -855,9 +1080,10 @@ static void *_agent(void *x)
 
 	slurm_mutex_lock(&agent_lock);
 	_save_dbd_state();
+	_spool_close_tail();
 
-	log_flag(AGENT, "slurmdbd agent ending with agent_count=%d",
-		 list_count(agent_list));
+	log_flag(AGENT, "slurmdbd agent ending with agent_count=%d spool_count=%u",
+		 list_count(agent_list), spool.cnt);
 
 	FREE_NULL_LIST(agent_list);
 	agent_running = false;
@@ -877,6 +1103,7 @@ static void _create_agent(void)
 	if (agent_list == NULL) {
 		agent_list = list_create(slurmdbd_free_buffer);
 		_load_dbd_state();
+		_spool_init();
 	}
 
 	if (agent_tid == 0) {
@@ -1020,7 +1247,22 @@ extern int slurmdbd_agent_send(uint16_t rpc_version, persist_msg_t *req)
 	/* Handle action */
 	_max_dbd_msg_action(&cnt);
 
-	if (cnt < slurm_conf.max_dbd_msgs) {
+	/*
+	 * Anything queued after a spooled message must be spooled to keep
+	 * order. Registrations are never saved to disk, see _save_dbd_state().
+	 */
+	if ((req->msg_type != DBD_REGISTER_CTLD) &&
+	    ((spool.head != spool.next) ||
+	     ((max_dbd_msg_action == MAX_DBD_ACTION_SPOOL) &&
+	      (cnt >= slurm_conf.max_dbd_msgs)))) {
+		if ((rc = _spool_rec(buffer))) {
+			error("unable to spool %s:%u request, discarding",
+			      slurmdbd_msg_type_2_str(req->msg_type, 1),
+			      req->msg_type);
+			(slurmdbd_conn->trigger_callbacks.acct_full)();
+			FREE_NULL_BUFFER(buffer);
+		}
+	} else if (cnt < slurm_conf.max_dbd_msgs) {
 		list_enqueue(agent_list, buffer);
 	} else {
 		error("agent queue is full (%u), discarding %s:%u request",
@@ -1048,7 +1290,7 @@ extern bool slurmdbd_conn_active(void)
 
 extern int slurmdbd_agent_queue_count(void)
 {
-	return list_count(agent_list);
+	return (list_count(agent_list) + spool.cnt);
 }
 
 extern void slurmdbd_agent_config_setup(void)
@@ -1075,6 +1317,8 @@ extern void slurmdbd_agent_config_setup(void)
 			max_dbd_msg_action = MAX_DBD_ACTION_DISCARD;
 		else if (!xstrcasecmp(type, "exit"))
 			max_dbd_msg_action = MAX_DBD_ACTION_EXIT;
+		else if (!xstrcasecmp(type, "spool"))
+			max_dbd_msg_action = MAX_DBD_ACTION_SPOOL;
 		else
 			fatal("Unknown SlurmctldParameters option for max_dbd_msg_action '%s'",
 			      type);
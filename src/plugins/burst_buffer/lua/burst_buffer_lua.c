@@ -876,7 +876,7 @@ static int _run_lua_script(run_lua_args_t *args)
 		list_append(job_ids, &job_ptr->job_id);
 		info_buf = pack_spec_jobs(job_ids, SHOW_DETAIL,
 					  slurm_conf.slurm_user_id, NO_VAL,
-					  SLURM_PROTOCOL_VERSION);
+					  false, SLURM_PROTOCOL_VERSION);
 
 		if (!args->have_job_lock)
 			unlock_slurmctld(job_read_lock);
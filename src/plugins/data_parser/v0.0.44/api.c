@@ -304,3 +304,13 @@ extern int data_parser_p_dump_flags(args_t *args, data_t *dst)
 	return data_parser_p_dump(args, DATA_PARSER_FLAGS, &args->flags,
 				  sizeof(args->flags), dst);
 }
+
+extern int data_parser_p_dump_emit(args_t *args, data_parser_type_t type,
+				   void *src, ssize_t src_bytes,
+				   const data_parser_emitter_t *emitter)
+{
+	xassert(args->magic == MAGIC_ARGS);
+
+	/* Callers must fall back to data_parser_p_dump() */
+	return ESLURM_NOT_SUPPORTED;
+}
@@ -192,6 +192,7 @@ extern void data_parser_p_free(args_t *args)
 
 	FREE_NULL_LIST(args->tres_list);
 	FREE_NULL_LIST(args->qos_list);
+	FREE_NULL_LIST(args->fields);
 	if (args->close_db_conn)
 		slurmdb_connection_close(&args->db_conn);
 
@@ -234,6 +235,16 @@ extern int data_parser_p_assign(args_t *args, data_parser_attr_type_t type,
 		log_flag(DATA, "assigned QOS List at 0x%" PRIxPTR" to parser 0x%"PRIxPTR,
 			 (uintptr_t) obj, (uintptr_t) args);
 		return SLURM_SUCCESS;
+	case DATA_PARSER_ATTR_FIELDS:
+		xassert(!args->fields || (args->fields == obj) || !obj);
+
+		if (args->fields != obj)
+			FREE_NULL_LIST(args->fields);
+		args->fields = obj;
+
+		log_flag(DATA, "assigned fields List at 0x%" PRIxPTR" to parser 0x%"PRIxPTR,
+			 (uintptr_t) obj, (uintptr_t) args);
+		return SLURM_SUCCESS;
 	default:
 		return EINVAL;
 	}
@@ -304,3 +315,22 @@ extern int data_parser_p_dump_flags(args_t *args, data_t *dst)
 	return data_parser_p_dump(args, DATA_PARSER_FLAGS, &args->flags,
 				  sizeof(args->flags), dst);
 }
+
+extern int data_parser_p_dump_emit(args_t *args, data_parser_type_t type,
+				   void *src, ssize_t src_bytes,
+				   const data_parser_emitter_t *emitter)
+{
+	const parser_t *const parser = find_parser_by_type(type);
+
+	xassert(type > DATA_PARSER_TYPE_INVALID);
+	xassert(type < DATA_PARSER_TYPE_MAX);
+	xassert(args->magic == MAGIC_ARGS);
+	xassert(!src || (src_bytes > 0));
+	xassert(emitter);
+
+	/* Specification is only generated into a data_t */
+	if (!parser || (args->flags & FLAG_SPEC_ONLY))
+		return ESLURM_NOT_SUPPORTED;
+
+	return emit(src, src_bytes, parser, emitter, args);
+}
@@ -68,6 +68,8 @@ typedef enum {
 	FLAG_MINIMIZE_REFS = SLURM_BIT(4),
 } data_parser_flags_t;
 
+typedef struct emit_state_s emit_state_t;
+
 typedef struct {
 	int magic; /* MAGIC_ARGS */
 	data_parser_on_error_t on_parse_error;
@@ -83,6 +85,9 @@ typedef struct {
 	list_t *tres_list;
 	list_t *qos_list;
 	data_parser_flags_t flags;
+	emit_state_t *emit; /* state while emitting or NULL */
+	list_t *fields; /* list of char* field keys of records to dump or NULL */
+	data_t *fields_record; /* record to dump with only fields or NULL */
 } args_t;
 
 extern bool data_parser_p_is_deprecated(args_t *args);
@@ -4070,7 +4070,7 @@ static int DUMP_FUNC(NODES)(const parser_t *const parser, void *obj,
 		/* filter unassigned dynamic nodes */
 		if (nodes->node_array[i].name)
 			rc = DUMP(NODE, nodes->node_array[i],
-				  data_list_append(dst), args);
+				  dump_list_item(dst, args), args);
 	}
 
 	return SLURM_SUCCESS;
@@ -4507,8 +4507,8 @@ static int DUMP_FUNC(JOB_INFO_MSG)(const parser_t *const parser, void *obj,
 	}
 
 	for (size_t i = 0; !rc && (i < msg->record_count); ++i)
-		rc = DUMP(JOB_INFO, msg->job_array[i], data_list_append(dst),
-			  args);
+		rc = DUMP(JOB_INFO, msg->job_array[i],
+			  dump_list_item(dst, args), args);
 
 	return rc;
 }
@@ -4576,8 +4576,8 @@ static int DUMP_FUNC(STEP_INFO_MSG)(const parser_t *const parser, void *obj,
 	}
 
 	for (size_t i = 0; !rc && (i < msg->job_step_count); ++i)
-		rc = DUMP(STEP_INFO, msg->job_steps[i], data_list_append(dst),
-			  args);
+		rc = DUMP(STEP_INFO, msg->job_steps[i],
+			  dump_list_item(dst, args), args);
 
 	return rc;
 }
@@ -4828,7 +4828,7 @@ static int DUMP_FUNC(PARTITION_INFO_MSG)(const parser_t *const parser,
 
 	for (uint32_t i = 0; !rc && (i < msg->record_count); ++i)
 		rc = DUMP(PARTITION_INFO, msg->partition_array[i],
-			  data_list_append(dst), args);
+			  dump_list_item(dst, args), args);
 
 	return rc;
 }
@@ -4845,7 +4845,7 @@ static int DUMP_FUNC(RESERVATION_INFO_MSG)(const parser_t *const parser,
 
 	for (int i = 0; !rc && (i < res->record_count); i++)
 		rc = DUMP(RESERVATION_INFO, res->reservation_array[i],
-			  data_list_append(dst), args);
+			  dump_list_item(dst, args), args);
 
 	return SLURM_SUCCESS;
 }
@@ -11191,6 +11191,9 @@ static const parser_t PARSER_ARRAY(OPENAPI_JOB_INFO_DELETE_QUERY)[] = {
 static const parser_t PARSER_ARRAY(OPENAPI_JOB_INFO_QUERY)[] = {
 	add_parse(TIMESTAMP, update_time, "update_time", "Query jobs updated more recently than this time (UNIX timestamp)"),
 	add_parse(JOB_SHOW_FLAGS, show_flags, "flags", "Query flags"),
+	add_parse(UINT32, cursor, "cursor", "Query jobs with a job ID greater than this job ID. Use the job_id of the last job of the previous page to query the next page."),
+	add_parse(CSV_STRING_LIST, fields, "fields", "CSV list of job fields to return. All fields are returned if not set."),
+	add_parse(UINT32, limit, "limit", "Query at most this many jobs sorted by job ID. Fewer jobs than limit are returned for the last page."),
 };
 #undef add_parse
 
@@ -52,6 +52,8 @@
 #define MAGIC_FOREACH_LIST 0xaefa2af3
 #define MAGIC_FOREACH_NT_ARRAY 0xaba1be2b
 #define MAGIC_FOREACH_PARSE_MARRAY 0xa081be2b
+#define MAGIC_EMIT_STATE 0xa0e1be2b
+#define MAGIC_FOREACH_EMIT 0xa0e1be2c
 
 typedef struct {
 	int magic;
@@ -84,6 +86,20 @@ typedef struct {
 	data_t *parent_path;
 } foreach_nt_array_t;
 
+struct emit_state_s {
+	int magic; /* MAGIC_EMIT_STATE */
+	const data_parser_emitter_t *emitter;
+	data_t *list; /* list being dumped via dump_list_item() */
+	bool list_started; /* list_begin() already sent for list */
+	int rc; /* first emitter error */
+};
+
+typedef struct {
+	int magic; /* MAGIC_FOREACH_EMIT */
+	args_t *args;
+	const parser_t *const parser;
+} foreach_emit_t;
+
 typedef struct {
 	int magic; /* MAGIC_FOREACH_PARSE_MARRAY */
 	args_t *args;
@@ -1584,6 +1600,29 @@ static int _dump_linked(args_t *args, const parser_t *const array,
 	return rc;
 }
 
+static int _find_field_key(void *x, void *key)
+{
+	const char *field = x;
+	const char *path = key;
+	const char *sep = strchr(path, '/');
+
+	if (!sep)
+		return !xstrcmp(field, path);
+
+	return (!xstrncmp(field, path, (sep - path)) &&
+		!field[sep - path]);
+}
+
+/* Check if the first key of a record field was requested in args->fields */
+static bool _is_field_selected(args_t *args, const parser_t *const field)
+{
+	if (!field->key)
+		return false;
+
+	return list_find_first_ro(args->fields, _find_field_key,
+				  (void *) field->key);
+}
+
 static void _check_dump(const parser_t *const parser, data_t *dst, args_t *args)
 {
 	/*
@@ -1648,15 +1687,30 @@ extern int dump(void *src, ssize_t src_bytes,
 		rc = _dump_flag_bit_array(args, src, dst, parser);
 		break;
 	case PARSER_MODEL_ARRAY:
+	{
+		bool filter = (args->fields && (args->fields_record == dst));
+
 		verify_parser_not_sliced(parser);
 		xassert(parser->fields);
 		xassert((data_get_type(dst) == DATA_TYPE_NULL) ||
 			(data_get_type(dst) == DATA_TYPE_DICT));
+
+		if (filter) {
+			args->fields_record = NULL;
+			data_set_dict(dst);
+		}
+
 		/* recursively run linked parsers for each struct field */
-		for (int i = 0; !rc && (i < parser->field_count); i++)
+		for (int i = 0; !rc && (i < parser->field_count); i++) {
+			if (filter &&
+			    !_is_field_selected(args, &parser->fields[i]))
+				continue;
+
 			rc = _dump_linked(args, parser, &parser->fields[i], src,
 					  dst);
+		}
 		break;
+	}
 	case PARSER_MODEL_LIST:
 		xassert(parser->list_type > DATA_PARSER_TYPE_INVALID);
 		xassert(parser->list_type < DATA_PARSER_TYPE_MAX);
@@ -1726,3 +1780,317 @@ done:
 
 	return rc;
 }
+
+static int _emit_value(emit_state_t *state, const data_t *value)
+{
+	const data_parser_emitter_t *emitter = state->emitter;
+
+	if (!state->rc)
+		state->rc = emitter->value(emitter->arg, value);
+
+	return state->rc;
+}
+
+/* Call emitter callback without arguments */
+static int _emit_call(emit_state_t *state, int (*func)(void *arg))
+{
+	if (!state->rc)
+		state->rc = func(state->emitter->arg);
+
+	return state->rc;
+}
+
+/* Send and release every item already dumped into state->list */
+static void _emit_flush_list(emit_state_t *state)
+{
+	data_t *item;
+
+	if (!state->list_started) {
+		_emit_call(state, state->emitter->list_begin);
+		state->list_started = true;
+	}
+
+	while ((item = data_list_dequeue(state->list))) {
+		_emit_value(state, item);
+		FREE_NULL_DATA(item);
+	}
+}
+
+extern data_t *dump_list_item(data_t *dst, args_t *args)
+{
+	emit_state_t *state = args->emit;
+	data_t *item;
+
+	xassert(args->magic == MAGIC_ARGS);
+
+	if (state && (state->list == dst)) {
+		xassert(state->magic == MAGIC_EMIT_STATE);
+		_emit_flush_list(state);
+	}
+
+	item = data_list_append(dst);
+
+	/* Only dump the requested fields of each record */
+	if (args->fields)
+		args->fields_record = item;
+
+	return item;
+}
+
+/* Dump object into a temporary data_t to send to emitter */
+static int _emit_dumped(void *src, ssize_t src_bytes,
+			const parser_t *const field_parser,
+			const parser_t *const parser, args_t *args)
+{
+	emit_state_t *state = args->emit;
+	data_t *prior_list = state->list;
+	bool prior_started = state->list_started;
+	data_t *d = data_new();
+	int rc;
+
+	state->list = d;
+	state->list_started = false;
+
+	if (!(rc = dump(src, src_bytes, field_parser, parser, d, args))) {
+		if (state->list_started) {
+			/* dump function already sent part of the list */
+			_emit_flush_list(state);
+			_emit_call(state, state->emitter->list_end);
+		} else {
+			_emit_value(state, d);
+		}
+
+		rc = state->rc;
+	}
+
+	state->list = prior_list;
+	state->list_started = prior_started;
+	FREE_NULL_DATA(d);
+
+	return rc;
+}
+
+static int _emit(void *src, ssize_t src_bytes,
+		 const parser_t *const field_parser,
+		 const parser_t *const parser, args_t *args);
+
+static int _foreach_emit_list(void *obj, void *arg)
+{
+	foreach_emit_t *args = arg;
+
+	xassert(args->magic == MAGIC_FOREACH_EMIT);
+
+	if (_emit(&obj, NO_VAL, NULL,
+		  find_parser_by_type(args->parser->list_type), args->args))
+		return -1;
+
+	return 0;
+}
+
+static int _emit_list(const parser_t *const parser, void *src, args_t *args)
+{
+	list_t **list_ptr = src;
+	foreach_emit_t fargs = {
+		.magic = MAGIC_FOREACH_EMIT,
+		.args = args,
+		.parser = parser,
+	};
+	int rc;
+
+	if ((rc = _emit_call(args->emit, args->emit->emitter->list_begin)))
+		return rc;
+
+	if (list_ptr && *list_ptr &&
+	    (list_for_each(*list_ptr, _foreach_emit_list, &fargs) < 0)) {
+		if ((rc = args->emit->rc))
+			return rc;
+
+		return on_error(DUMPING, parser->type, args, SLURM_ERROR,
+				"_foreach_emit_list", __func__,
+				"dumping list failed");
+	}
+
+	return _emit_call(args->emit, args->emit->emitter->list_end);
+}
+
+static int _emit_nt_array(const parser_t *const parser, void *src,
+			  args_t *args)
+{
+	const parser_t *const ap = find_parser_by_type(parser->array_type);
+	int rc;
+
+	if ((rc = _emit_call(args->emit, args->emit->emitter->list_begin)))
+		return rc;
+
+	if (parser->model == PARSER_MODEL_NT_PTR_ARRAY) {
+		void **array = *((void ***) src);
+
+		for (int i = 0; !rc && array && array[i]; i++)
+			rc = _emit((array + i), NO_VAL, NULL, ap, args);
+	} else {
+		void **array = src;
+
+		for (int i = 0; !rc && *array; i++) {
+			bool done = true;
+			void *ptr = *array + (ap->size * i);
+
+			/* check every byte of object is zero */
+			for (int j = 0; j < ap->size; j++)
+				if (((char *) ptr)[j])
+					done = false;
+
+			if (done)
+				break;
+
+			rc = _emit(ptr, NO_VAL, NULL, ap, args);
+		}
+	}
+
+	if (rc)
+		return rc;
+
+	return _emit_call(args->emit, args->emit->emitter->list_end);
+}
+
+/*
+ * Check if every field of parser array is placed under its own top level key
+ * to allow emitting each field separately.
+ */
+static bool _is_flat_array(const parser_t *const parser)
+{
+	for (int i = 0; i < parser->field_count; i++) {
+		const parser_t *const field = &parser->fields[i];
+
+		if ((field->model == PARSER_MODEL_ARRAY_SKIP_FIELD) &&
+		    !field->key)
+			continue;
+
+		if (!field->key || xstrstr(field->key, "/") ||
+		    (field->model ==
+		     PARSER_MODEL_ARRAY_LINKED_EXPLODED_FLAG_ARRAY_FIELD))
+			return false;
+	}
+
+	return true;
+}
+
+static data_for_each_cmd_t _foreach_emit_field(const char *key,
+					       const data_t *data, void *arg)
+{
+	emit_state_t *state = arg;
+
+	xassert(state->magic == MAGIC_EMIT_STATE);
+
+	if (!state->rc)
+		state->rc = state->emitter->dict_key(state->emitter->arg, key);
+	_emit_value(state, data);
+
+	return (state->rc ? DATA_FOR_EACH_FAIL : DATA_FOR_EACH_CONT);
+}
+
+static int _emit_array(const parser_t *const parser, void *src, args_t *args)
+{
+	emit_state_t *state = args->emit;
+	int rc;
+
+	if ((rc = _emit_call(state, state->emitter->dict_begin)))
+		return rc;
+
+	for (int i = 0; !rc && (i < parser->field_count); i++) {
+		const parser_t *const field = &parser->fields[i];
+
+		if (field->model == PARSER_MODEL_ARRAY_LINKED_FIELD) {
+			void *fsrc = src;
+
+			if ((field->ptr_offset != NO_VAL) && fsrc)
+				fsrc += field->ptr_offset;
+
+			if (!(rc = state->emitter->dict_key(
+				      state->emitter->arg, field->key)))
+				rc = _emit(fsrc, NO_VAL, field,
+					   find_parser_by_type(field->type),
+					   args);
+		} else if (field->key) {
+			/* Dump removed and skipped fields as usual */
+			data_t *d = data_set_dict(data_new());
+
+			if (!(rc = _dump_linked(args, parser, field, src, d)) &&
+			    (data_dict_for_each_const(d, _foreach_emit_field,
+						      state) < 0))
+				rc = state->rc;
+
+			FREE_NULL_DATA(d);
+		}
+	}
+
+	if (rc)
+		return rc;
+
+	return _emit_call(state, state->emitter->dict_end);
+}
+
+static int _emit(void *src, ssize_t src_bytes,
+		 const parser_t *const field_parser,
+		 const parser_t *const parser, args_t *args)
+{
+	int rc;
+
+	check_parser(parser);
+	xassert(args->magic == MAGIC_ARGS);
+	xassert(args->emit->magic == MAGIC_EMIT_STATE);
+
+	if ((rc = load_prereqs(DUMPING, parser, args)))
+		return rc;
+
+	switch (parser->model) {
+	case PARSER_MODEL_ARRAY:
+		if (!_is_flat_array(parser))
+			break;
+		return _emit_array(parser, src, args);
+	case PARSER_MODEL_LIST:
+		return _emit_list(parser, src, args);
+	case PARSER_MODEL_PTR:
+		if (!*((void **) src))
+			break;
+		return _emit(*((void **) src), NO_VAL, NULL,
+			     find_parser_by_type(parser->pointer_type), args);
+	case PARSER_MODEL_NT_PTR_ARRAY:
+	case PARSER_MODEL_NT_ARRAY:
+		return _emit_nt_array(parser, src, args);
+	case PARSER_MODEL_ALIAS:
+		return _emit(src, src_bytes, NULL,
+			     find_parser_by_type(parser->alias_type), args);
+	default:
+		break;
+	}
+
+	return _emit_dumped(src, src_bytes, field_parser, parser, args);
+}
+
+extern int emit(void *src, ssize_t src_bytes, const parser_t *const parser,
+		const data_parser_emitter_t *emitter, args_t *args)
+{
+	emit_state_t state = {
+		.magic = MAGIC_EMIT_STATE,
+		.emitter = emitter,
+	};
+	data_arena_t *prior_arena;
+	int rc;
+
+	xassert(!args->emit);
+	args->emit = &state;
+
+	/*
+	 * Values are released as soon as they are emitted which an arena would
+	 * hold until the whole dump is complete.
+	 */
+	prior_arena = data_arena_set(NULL);
+
+	rc = _emit(src, src_bytes, NULL, parser, args);
+
+	(void) data_arena_set(prior_arena);
+	args->emit = NULL;
+	state.magic = ~MAGIC_EMIT_STATE;
+
+	return (rc ? rc : state.rc);
+}
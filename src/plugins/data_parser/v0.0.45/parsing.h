@@ -66,6 +66,25 @@ extern int dump(void *src, ssize_t src_bytes,
 	dump(&src, sizeof(src), NULL, find_parser_by_type(DATA_PARSER_##type), \
 	     dst, args)
 
+/*
+ * Dump src directly to emitter
+ * Struct fields, lists and pointers are walked directly while everything else
+ * is dumped into a temporary data_t per value.
+ */
+extern int emit(void *src, ssize_t src_bytes, const parser_t *const parser,
+		const data_parser_emitter_t *emitter, args_t *args);
+
+/*
+ * Append next item to list dst while dumping
+ * Use instead of data_list_append() in dump functions that generate a list of
+ * records. While emitting, the prior items are sent to the emitter instead of
+ * being held until the dump is complete.
+ * IN dst - list being dumped
+ * IN args - parser args
+ * RET new list item
+ */
+extern data_t *dump_list_item(data_t *dst, args_t *args);
+
 extern int parse(void *dst, ssize_t dst_bytes, const parser_t *const parser,
 		 data_t *src, args_t *args, data_t *parent_path);
 #define PARSE(type, dst, src, parent_path, args)                               \
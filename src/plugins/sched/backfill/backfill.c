@@ -131,8 +131,16 @@
 typedef struct {
 	node_space_map_t *node_space;
 	int *node_space_recs;
+	bitstr_t *node_bitmap; /* only reserve jobs on these nodes, if set */
 } node_space_handler_t;
 
+/* node_space map of a set of partitions disjoint from any other partition */
+typedef struct {
+	bitstr_t *node_bitmap;
+	node_space_map_t *node_space;
+	int node_space_recs;
+} node_space_group_t;
+
 /*
  * HetJob scheduling structures
  * NOTE: An individual hetjob component can be submitted to multiple
@@ -213,6 +221,8 @@ static int bf_job_part_count_reserve = 0;
 static int bf_max_job_array_resv = BF_MAX_JOB_ARRAY_RESV;
 static int bf_min_age_reserve = 0;
 static int bf_node_space_size = 0;
+static bool bf_node_space_tree = false;
+static bool bf_part_node_space = false;
 static bool bf_running_job_reserve = false;
 static bool bf_licenses = false;
 static uint32_t bf_min_prio_reserve = 0;
@@ -239,6 +249,9 @@ static int yield_sleep   = YIELD_SLEEP;
 static list_t *het_job_list = NULL;
 static xhash_t *user_usage_map = NULL; /* look up user usage when no assoc */
 static bitstr_t *planned_bitmap = NULL;
+static node_space_group_t *ns_groups = NULL;
+static int ns_group_cnt = 0;
+static int ns_group_inx = 0;
 static bool soft_time_limit = false;
 
 /*********************** local functions *********************/
@@ -359,6 +372,154 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 	log_flag(BACKFILL, "=========================================");
 }
 
+/*
+ * node_space treap (bf_node_space_tree)
+ *
+ * Records never change their begin_time and, except for the first record
+ * which may shrink to an empty time range, cover consecutive and non-empty
+ * time ranges. So the records other than the first one have unique
+ * begin_time keys and the record covering a time is found in O(log n)
+ * instead of walking the "next" list. Record 0 is the null link.
+ */
+static int _ns_tree_rotate_right(node_space_map_t *node_space, int x)
+{
+	int y = node_space[x].tree_left;
+
+	node_space[x].tree_left = node_space[y].tree_right;
+	node_space[y].tree_right = x;
+	return y;
+}
+
+static int _ns_tree_rotate_left(node_space_map_t *node_space, int x)
+{
+	int y = node_space[x].tree_right;
+
+	node_space[x].tree_right = node_space[y].tree_left;
+	node_space[y].tree_left = x;
+	return y;
+}
+
+static int _ns_tree_insert(node_space_map_t *node_space, int root, int x)
+{
+	if (!root)
+		return x;
+
+	if (node_space[x].begin_time < node_space[root].begin_time) {
+		node_space[root].tree_left =
+			_ns_tree_insert(node_space, node_space[root].tree_left,
+					x);
+		if (node_space[node_space[root].tree_left].tree_prio >
+		    node_space[root].tree_prio)
+			root = _ns_tree_rotate_right(node_space, root);
+	} else {
+		node_space[root].tree_right =
+			_ns_tree_insert(node_space, node_space[root].tree_right,
+					x);
+		if (node_space[node_space[root].tree_right].tree_prio >
+		    node_space[root].tree_prio)
+			root = _ns_tree_rotate_left(node_space, root);
+	}
+
+	return root;
+}
+
+static int _ns_tree_join(node_space_map_t *node_space, int left, int right)
+{
+	if (!left)
+		return right;
+	if (!right)
+		return left;
+
+	if (node_space[left].tree_prio > node_space[right].tree_prio) {
+		node_space[left].tree_right =
+			_ns_tree_join(node_space, node_space[left].tree_right,
+				      right);
+		return left;
+	}
+
+	node_space[right].tree_left =
+		_ns_tree_join(node_space, left, node_space[right].tree_left);
+	return right;
+}
+
+static int _ns_tree_remove(node_space_map_t *node_space, int root, int x)
+{
+	if (!root)
+		return 0;
+
+	if (root == x)
+		return _ns_tree_join(node_space, node_space[x].tree_left,
+				     node_space[x].tree_right);
+
+	if (node_space[x].begin_time < node_space[root].begin_time)
+		node_space[root].tree_left =
+			_ns_tree_remove(node_space, node_space[root].tree_left,
+					x);
+	else
+		node_space[root].tree_right =
+			_ns_tree_remove(node_space, node_space[root].tree_right,
+					x);
+
+	return root;
+}
+
+/* Add a new record, which must have its begin_time set */
+static void _ns_tree_add(node_space_map_t *node_space, int x)
+{
+	if (!bf_node_space_tree)
+		return;
+
+	node_space[x].tree_left = node_space[x].tree_right = 0;
+	/* Any priority independent of begin_time keeps the treap balanced */
+	node_space[x].tree_prio = (uint32_t) x * 2654435761U;
+	node_space[0].tree_left = _ns_tree_insert(node_space,
+						  node_space[0].tree_left, x);
+}
+
+/* Remove a record unlinked from the "next" list */
+static void _ns_tree_del(node_space_map_t *node_space, int x)
+{
+	if (!bf_node_space_tree)
+		return;
+
+	node_space[0].tree_left = _ns_tree_remove(node_space,
+						  node_space[0].tree_left, x);
+}
+
+/* Return the last record with begin_time <= when, 0 if none */
+static int _ns_tree_find_le(node_space_map_t *node_space, time_t when)
+{
+	int found = 0;
+
+	for (int x = node_space[0].tree_left; x; ) {
+		if (node_space[x].begin_time <= when) {
+			found = x;
+			x = node_space[x].tree_right;
+		} else {
+			x = node_space[x].tree_left;
+		}
+	}
+
+	return found;
+}
+
+extern int bf_node_space_find(node_space_map_t *node_space, time_t when)
+{
+	int j;
+
+	if (bf_node_space_tree) {
+		j = _ns_tree_find_le(node_space, when);
+		return (node_space[j].end_time > when) ? j : 0;
+	}
+
+	for (j = 0; node_space[j].end_time <= when; ) {
+		if ((j = node_space[j].next) == 0)
+			break;
+	}
+
+	return j;
+}
+
 static void _set_job_time_limit(job_record_t *job_ptr, uint32_t new_limit)
 {
 	job_ptr->time_limit = new_limit;
@@ -792,6 +953,16 @@ static void _load_config(void)
 		bf_node_space_size = max_backfill_job_cnt;
 	}
 
+	if (xstrcasestr(sched_params, "bf_node_space_tree"))
+		bf_node_space_tree = true;
+	else
+		bf_node_space_tree = false;
+
+	if (xstrcasestr(sched_params, "bf_part_node_space"))
+		bf_part_node_space = true;
+	else
+		bf_part_node_space = false;
+
 	if ((tmp_ptr = xstrcasestr(sched_params, "bf_resolution="))) {
 		backfill_resolution = atoi(tmp_ptr + 14);
 		if (backfill_resolution < 1 ||
@@ -1559,6 +1730,11 @@ static int _bf_reserve_running(void *x, void *arg)
 	if (preemptable && !licenses)
 		return SLURM_SUCCESS;
 
+	if (ns_h->node_bitmap &&
+	    (!job_ptr->node_bitmap ||
+	     !bit_overlap_any(ns_h->node_bitmap, job_ptr->node_bitmap)))
+		return SLURM_SUCCESS;
+
 	if (*ns_recs_ptr >= bf_node_space_size)
 		return SLURM_ERROR;
 
@@ -2058,7 +2234,7 @@ static int _get_licenses_from_nspace(node_space_map_t *node_space,
 				     time_t start_time,
 				     bf_licenses_t **licenses_pptr)
 {
-	int j = 0;
+	int j = bf_node_space_find(node_space, start_time);
 	while (true) {
 		if ((node_space[j].end_time > start_time) &&
 		    (node_space[j].begin_time <= start_time)) {
@@ -2110,12 +2286,234 @@ static int _hres_pre_select(job_record_t *job_ptr, node_space_map_t *node_space,
 	continue;	/* not runnable in this partition */		\
 }
 
+/*
+ * Create a node_space map for a backfill cycle, reserving resources of
+ * running jobs with bf_running_job_reserve.
+ * IN node_bitmap - if set, only reserve jobs running on these nodes
+ * OUT node_space_recs - records used in the map
+ */
+static node_space_map_t *_node_space_create(time_t sched_start,
+					    time_t window_end,
+					    bitstr_t *node_bitmap,
+					    int *node_space_recs)
+{
+	node_space_map_t *node_space;
+	int j;
+
+	node_space = xcalloc((bf_node_space_size + 1),
+			     sizeof(node_space_map_t));
+	node_space[0].begin_time = sched_start / backfill_resolution;
+	node_space[0].begin_time *= backfill_resolution;
+	node_space[0].end_time = window_end;
+
+	node_space[0].avail_bitmap = bit_copy(avail_node_bitmap);
+	/* Make "resuming" nodes available to be scheduled in backfill */
+	bit_or(node_space[0].avail_bitmap, rs_node_bitmap);
+
+	if (bf_licenses)
+		node_space[0].licenses =
+			bf_licenses_initial(bf_running_job_reserve);
+
+	if (bf_topopt_enable) {
+		node_space[0].fragmentation = topology_g_get_fragmentation(
+			node_space[0].avail_bitmap);
+	}
+
+	node_space[0].next = 0;
+	*node_space_recs = 1;
+
+	if (bf_running_job_reserve) {
+		node_space_handler_t node_space_handler;
+		node_space_handler.node_space = node_space;
+		node_space_handler.node_space_recs = node_space_recs;
+		node_space_handler.node_bitmap = node_bitmap;
+
+		if (bf_licenses) {
+			int cluster_list_count = cluster_license_count();
+
+			list_for_each(resv_list, _bf_reserve_resv_licenses,
+				      &node_space_handler);
+			j = 0;
+			while (cluster_list_count) {
+				/* if 2+ resv license was added sort the list */
+				if (list_count(node_space[j].licenses) >
+				    (cluster_list_count + 1)) {
+					list_sort(node_space[j].licenses,
+						  bf_license_cmp);
+				}
+
+				if ((j = node_space[j].next) == 0)
+					break;
+			}
+		}
+
+		list_for_each(job_list, _bf_reserve_running,
+			      &node_space_handler);
+	}
+
+	return node_space;
+}
+
+static void _node_space_free(node_space_map_t *node_space,
+			     int node_space_recs)
+{
+	int i;
+
+	for (i = 0; ; ) {
+		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
+		FREE_NULL_BF_LICENSES(node_space[i].licenses);
+		if ((i = node_space[i].next) == 0)
+			break;
+	}
+	for (i = node_space_recs; i <= bf_node_space_size; i++) {
+		if (!node_space[i].avail_bitmap)
+			break;
+		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
+	}
+	xfree(node_space);
+}
+
+/*
+ * With bf_part_node_space, split the partitions into groups which share no
+ * nodes with other groups and give each group its own node_space map. A job
+ * can only be allocated nodes of its partition, so reservations made in one
+ * group never constrain jobs of another one, and each job only walks and
+ * splits the map of its own group.
+ *
+ * Licenses are a cluster-wide resource, so this is not done with
+ * bf_licenses. With exclusive topology the partition nodes are extended to
+ * whole topology blocks first.
+ */
+static void _node_space_groups_create(time_t sched_start, time_t window_end)
+{
+	list_itr_t *part_iterator;
+	part_record_t *part_ptr;
+	bitstr_t *node_bitmap;
+	int g, into, part_cnt = list_count(part_list);
+
+	ns_groups = xcalloc(MAX(part_cnt, 1), sizeof(node_space_group_t));
+	ns_group_cnt = 0;
+
+	part_iterator = list_iterator_create(part_list);
+	while ((part_ptr = list_next(part_iterator))) {
+		if (!part_ptr->node_bitmap)
+			continue;
+		node_bitmap = bit_copy(part_ptr->node_bitmap);
+		if (topology_g_whole_topo_enabled(part_ptr->topology_idx))
+			topology_g_whole_topo(node_bitmap,
+					      part_ptr->topology_idx);
+
+		into = -1;
+		for (g = 0; g < ns_group_cnt; g++) {
+			if (!bit_overlap_any(ns_groups[g].node_bitmap,
+					     node_bitmap))
+				continue;
+			if (into < 0) {
+				into = g;
+				bit_or(ns_groups[g].node_bitmap, node_bitmap);
+				continue;
+			}
+			/* Partition joins two groups, merge them */
+			bit_or(ns_groups[into].node_bitmap,
+			       ns_groups[g].node_bitmap);
+			FREE_NULL_BITMAP(ns_groups[g].node_bitmap);
+			ns_groups[g] = ns_groups[--ns_group_cnt];
+			ns_groups[ns_group_cnt].node_bitmap = NULL;
+			g--;
+		}
+		if (into < 0)
+			ns_groups[ns_group_cnt++].node_bitmap = node_bitmap;
+		else
+			FREE_NULL_BITMAP(node_bitmap);
+	}
+	list_iterator_destroy(part_iterator);
+
+	if (ns_group_cnt < 2) {
+		/* Nothing to split, use a single map */
+		for (g = 0; g < ns_group_cnt; g++)
+			FREE_NULL_BITMAP(ns_groups[g].node_bitmap);
+		xfree(ns_groups);
+		ns_group_cnt = 0;
+		return;
+	}
+
+	for (g = 0; g < ns_group_cnt; g++) {
+		ns_groups[g].node_space =
+			_node_space_create(sched_start, window_end,
+					   ns_groups[g].node_bitmap,
+					   &ns_groups[g].node_space_recs);
+	}
+	log_flag(BACKFILL, "using %d node_space maps for disjoint partitions",
+		 ns_group_cnt);
+}
+
+/* Free the node_space groups, return the total of records used */
+static int _node_space_groups_free(void)
+{
+	int node_space_recs = 0;
+
+	for (int g = 0; g < ns_group_cnt; g++) {
+		node_space_recs += ns_groups[g].node_space_recs;
+		_node_space_free(ns_groups[g].node_space,
+				 ns_groups[g].node_space_recs);
+		FREE_NULL_BITMAP(ns_groups[g].node_bitmap);
+	}
+	xfree(ns_groups);
+	ns_group_cnt = 0;
+	ns_group_inx = 0;
+
+	return node_space_recs;
+}
+
+static int _node_space_group(part_record_t *part_ptr)
+{
+	if (!part_ptr || !part_ptr->node_bitmap)
+		return 0;
+
+	for (int g = 0; g < ns_group_cnt; g++) {
+		if (bit_overlap_any(ns_groups[g].node_bitmap,
+				    part_ptr->node_bitmap))
+			return g;
+	}
+
+	return 0;
+}
+
+/*
+ * Return the node_space map to use for jobs of a partition, node_space
+ * without bf_part_node_space.
+ */
+static node_space_map_t *_part_node_space(part_record_t *part_ptr,
+					  node_space_map_t *node_space)
+{
+	if (!ns_group_cnt)
+		return node_space;
+
+	return ns_groups[_node_space_group(part_ptr)].node_space;
+}
+
+/* Make the node_space map of part_ptr the current one */
+static void _node_space_switch(part_record_t *part_ptr,
+			       node_space_map_t **node_space,
+			       int *node_space_recs)
+{
+	int g = _node_space_group(part_ptr);
+
+	if (g == ns_group_inx)
+		return;
+
+	ns_groups[ns_group_inx].node_space_recs = *node_space_recs;
+	ns_group_inx = g;
+	*node_space = ns_groups[g].node_space;
+	*node_space_recs = ns_groups[g].node_space_recs;
+}
+
 static void _attempt_backfill(void)
 {
 	DEF_TIMERS;
 	list_t *job_queue = NULL;
 	job_queue_rec_t *job_queue_rec = NULL;
-	int bb, i, j, node_space_recs, mcs_select = 0;
+	int bb, j, node_space_recs, mcs_select = 0;
 	slurmdb_qos_rec_t *qos_ptr = NULL;
 	job_record_t *job_ptr = NULL;
 	part_record_t *part_ptr;
@@ -2212,56 +2610,18 @@ static void _attempt_backfill(void)
 	slurmctld_diag_stats.bf_last_depth_try = 0;
 	slurmctld_diag_stats.bf_when_last_cycle = now;
 
-	node_space = xcalloc((bf_node_space_size + 1),
-			     sizeof(node_space_map_t));
-	node_space[0].begin_time = sched_start / backfill_resolution;
-	node_space[0].begin_time *= backfill_resolution;
 	window_end = (sched_start + backfill_window) / backfill_resolution;
 	window_end *= backfill_resolution;
-	node_space[0].end_time = window_end;
-
-	node_space[0].avail_bitmap = bit_copy(avail_node_bitmap);
-	/* Make "resuming" nodes available to be scheduled in backfill */
-	bit_or(node_space[0].avail_bitmap, rs_node_bitmap);
-
-	if (bf_licenses)
-		node_space[0].licenses =
-			bf_licenses_initial(bf_running_job_reserve);
-
-	if (bf_topopt_enable) {
-		node_space[0].fragmentation = topology_g_get_fragmentation(
-			node_space[0].avail_bitmap);
-	}
-
-	node_space[0].next = 0;
-	node_space_recs = 1;
-
-	if (bf_running_job_reserve) {
-		node_space_handler_t node_space_handler;
-		node_space_handler.node_space = node_space;
-		node_space_handler.node_space_recs = &node_space_recs;
-
-		if (bf_licenses) {
-			int cluster_list_count = cluster_license_count();
-
-			list_for_each(resv_list, _bf_reserve_resv_licenses,
-				      &node_space_handler);
-			j = 0;
-			while (cluster_list_count) {
-				/* if 2+ resv license was added sort the list */
-				if (list_count(node_space[j].licenses) >
-				    (cluster_list_count + 1)) {
-					list_sort(node_space[j].licenses,
-						  bf_license_cmp);
-				}
-
-				if ((j = node_space[j].next) == 0)
-					break;
-			}
-		}
 
-		list_for_each(job_list, _bf_reserve_running,
-			      &node_space_handler);
+	if (bf_part_node_space && !bf_licenses)
+		_node_space_groups_create(sched_start, window_end);
+	if (ns_group_cnt) {
+		ns_group_inx = 0;
+		node_space = ns_groups[0].node_space;
+		node_space_recs = ns_groups[0].node_space_recs;
+	} else {
+		node_space = _node_space_create(sched_start, window_end, NULL,
+						&node_space_recs);
 	}
 
 	_init_node_used_array_and_list(&nodes_used, &nodes_used_list);
@@ -2436,6 +2796,10 @@ static void _attempt_backfill(void)
 		job_ptr->priority = bf_job_priority;
 		job_ptr->qos_ptr = qos_ptr;
 
+		if (ns_group_cnt)
+			_node_space_switch(part_ptr, &node_space,
+					   &node_space_recs);
+
 		mcs_select = slurm_mcs_get_select(job_ptr);
 		het_job_time = _het_job_start_find(job_ptr);
 		if (het_job_time > (now + backfill_window))
@@ -2919,7 +3283,7 @@ TRY_LATER:
 		}
 
 		COPY_BITMAP(tmp_bitmap, avail_bitmap);
-		for (j = 0; ; ) {
+		for (j = bf_node_space_find(node_space, start_res); ; ) {
 			if ((node_space[j].end_time > start_res) &&
 			     node_space[j].next && (later_start == 0)) {
 				int tmp = node_space[j].next;
@@ -3119,7 +3483,7 @@ later_start_set:
 			orig_end_time = end_time;
 			end_time += boot_time;
 
-			for (j = 0; ; ) {
+			for (j = bf_node_space_find(node_space, start_res); ; ) {
 				if (node_space[j].end_time <= start_res)
 					;
 				else if (node_space[j].begin_time <= end_time) {
@@ -3719,18 +4083,12 @@ skip_start:
 	FREE_NULL_BITMAP(next_bitmap);
 	FREE_NULL_BITMAP(current_bitmap);
 
-	for (i = 0; ; ) {
-		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
-		FREE_NULL_BF_LICENSES(node_space[i].licenses);
-		if ((i = node_space[i].next) == 0)
-			break;
-	}
-	for (i = node_space_recs; i <= bf_node_space_size; i++) {
-		if (!node_space[i].avail_bitmap)
-			break;
-		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
+	if (ns_group_cnt) {
+		ns_groups[ns_group_inx].node_space_recs = node_space_recs;
+		node_space_recs = _node_space_groups_free();
+	} else {
+		_node_space_free(node_space, node_space_recs);
 	}
-	xfree(node_space);
 
 	FREE_NULL_LIST(job_queue);
 	FREE_NULL_LIST(nodes_used_list);
@@ -3978,7 +4336,20 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 	 */
 	if (end_reserve < (start_time + backfill_resolution))
 		end_reserve = start_time + backfill_resolution;
-	for (j = 0; ; ) {
+	if (bf_node_space_tree) {
+		/*
+		 * Start from the record before the one ending at or after
+		 * start_time, as the walk below would reach it.
+		 */
+		j = _ns_tree_find_le(node_space, start_time);
+		if (j && (node_space[j].begin_time == start_time))
+			j = _ns_tree_find_le(node_space, start_time - 1);
+		if (j)
+			one_before = _ns_tree_find_le(
+				node_space, node_space[j].begin_time - 1);
+	} else
+		j = 0;
+	for ( ; ; ) {
 		if (node_space[j].end_time > start_time) {
 			/* insert start entry record */
 			i = *node_space_recs;
@@ -3993,6 +4364,7 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 				node_space[j].fragmentation;
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
+			_ns_tree_add(node_space, i);
 			(*node_space_recs)++;
 			placed = true;
 			break;
@@ -4022,6 +4394,7 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 				node_space[j].fragmentation;
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
+			_ns_tree_add(node_space, i);
 			(*node_space_recs)++;
 		}
 
@@ -4068,6 +4441,7 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 		}
 		node_space[i].end_time = node_space[j].end_time;
 		node_space[i].next = node_space[j].next;
+		_ns_tree_del(node_space, j);
 		if (node_space[j].avail_bitmap) {
 			for (i = *node_space_recs;
 			     i <= bf_node_space_size; i++) {
@@ -4100,7 +4474,7 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 			       uint32_t start_time, uint32_t end_reserve)
 {
 	bool overlap = false;
-	int j = 0;
+	int j = bf_node_space_find(node_space, start_time);
 	bitstr_t *use_bitmap_efctv = NULL;
 	bitstr_t *use_bitmap_orig = use_bitmap;
 
@@ -4575,7 +4949,10 @@ static int _het_job_start_now(het_job_map_t *map, node_space_map_t *node_space)
 			 * beforehand for _reset_job_time_limit.
 			 */
 			if (reset_time)
-				_reset_job_time_limit(job_ptr, now, node_space);
+				_reset_job_time_limit(
+					job_ptr, now,
+					_part_node_space(job_ptr->part_ptr,
+							 node_space));
 		}
 		if (reset_time)
 			jobacct_storage_g_job_start(acct_db_conn, job_ptr);
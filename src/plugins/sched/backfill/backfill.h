@@ -50,6 +50,14 @@ typedef struct {
 	bf_licenses_t *licenses;
 	uint32_t fragmentation;
 	int next; /* next record, by time, zero termination */
+	/*
+	 * With bf_node_space_tree, records other than the first one are also
+	 * kept in a treap ordered by begin_time, zero termination. The root
+	 * is tree_left of the first record.
+	 */
+	int tree_left;
+	int tree_right;
+	uint32_t tree_prio;
 } node_space_map_t;
 
 /* backfill_agent - detached thread periodically attempts to backfill jobs */
@@ -61,6 +69,12 @@ extern void stop_backfill_agent(void);
 /* Note that slurm.conf has changed */
 extern void backfill_reconfig(void);
 
+/*
+ * Return the first record of node_space ending after "when", or 0 if there is
+ * no such record.
+ */
+extern int bf_node_space_find(node_space_map_t *node_space, time_t when);
+
 /* Used for testsuite to call backfill */
 extern void __attempt_backfill(void);
 
@@ -51,7 +51,7 @@ static int _get_bitmap_from_nspace(node_space_map_t *node_space,
 				   time_t start_time, bitstr_t *out_bitmap,
 				   uint32_t *fragmentation)
 {
-	int j = 0;
+	int j = bf_node_space_find(node_space, start_time);
 	while (true) {
 		if ((node_space[j].end_time > start_time) &&
 		    (node_space[j].begin_time <= start_time)) {
@@ -92,8 +92,8 @@ static void _handle_gres_exc_topo(resv_exc_t *resv_exc_ptr, int node_inx,
 		bitstr_t *tmp_bitmap =
 			bit_copy(gres_ns->topo_gres_bitmap[topo_inx]);
 		bit_and(tmp_bitmap, gres_js->gres_bit_alloc[node_inx]);
-		bit_and_not(tmp_bitmap, gres_ns->gres_bit_alloc);
-		gres_cnt = bit_set_count(tmp_bitmap);
+		gres_cnt = bit_and_not_count(tmp_bitmap,
+					     gres_ns->gres_bit_alloc);
 		FREE_NULL_BITMAP(tmp_bitmap);
 	} else {
 		gres_cnt = bit_overlap(gres_js->gres_bit_alloc[node_inx],
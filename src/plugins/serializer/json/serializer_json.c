@@ -47,14 +47,16 @@
 
 #include "src/common/data.h"
 #include "src/common/log.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/serializer.h"
 
-#define SERIALIZER_JSON_DEFAULT_FORMAT JSON_C_TO_STRING_PLAIN
 #define SERIALIZER_JSON_DEFAULT_FLAGS SER_FLAGS_PRETTY
+/* Spaces per level of indentation for pretty output */
+#define SERIALIZER_JSON_INDENT 2
 
 /* Required Slurm plugin symbols: */
 const char plugin_name[] = "Serializer JSON plugin";
@@ -70,15 +72,35 @@ const char *mime_types[] = {
 
 static serializer_flags_t global_flags = SERIALIZER_JSON_DEFAULT_FLAGS;
 
-#define MAGIC_CONVERT_FOREACH 0x0a0b0808
+#define MAGIC_WRITER 0x0a0b1808
+#define MAGIC_WRITE_FOREACH 0x0a0b1809
 
+/*
+ * Output is written directly into a buffer while walking the data_t tree
+ * instead of building a json-c object tree first.
+ */
 typedef struct {
-	int magic; /* MAGIC_CONVERT_FOREACH */
-	json_object *jobj;
+	int magic; /* MAGIC_WRITER */
+	buf_t *buf;
+	bool pretty;
 	serializer_flags_t flags;
-} convert_foreach_arg_t;
+	int rc;
+
+	/* State while receiving a dump from data_parser_g_dump_emit() */
+	bool *first; /* no entry written yet for each open dict or list */
+	int depth; /* number of open dicts and lists */
+	int depth_size; /* size of first array */
+	bool after_key; /* dict key written and waiting on value */
+} writer_t;
 
-static json_object *_data_to_json(const data_t *d, serializer_flags_t flags);
+typedef struct {
+	int magic; /* MAGIC_WRITE_FOREACH */
+	writer_t *writer;
+	int level;
+	bool first;
+} write_foreach_arg_t;
+
+static void _write_data(writer_t *w, const data_t *d, int level);
 
 /* Merge global_flags and flags into the coherent set of flags */
 static serializer_flags_t _merge_flags(serializer_flags_t flags)
@@ -169,92 +191,255 @@ static data_t *_json_to_data(json_object *jobj, data_t *d)
 	return d;
 }
 
-static data_for_each_cmd_t _convert_dict_json(const char *key,
-					      const data_t *data,
-					      void *arg)
+/* Ensure bytes can be written to the buffer */
+static bool _reserve(writer_t *w, size_t bytes)
 {
-	convert_foreach_arg_t *args = arg;
-	json_object *jobj = args->jobj;
-	json_object *jobject = _data_to_json(data, args->flags);
+	buf_t *buf = w->buf;
+
+	if (w->rc)
+		return false;
 
-	xassert(args->magic == MAGIC_CONVERT_FOREACH);
+	if (remaining_buf(buf) >= bytes)
+		return true;
 
-	json_object_object_add(jobj, key, jobject);
-	return DATA_FOR_EACH_CONT;
+	/* Grow geometrically to avoid reallocating for every BUF_SIZE */
+	if ((w->rc = try_grow_buf(buf, MAX(bytes, size_buf(buf)))))
+		return false;
+
+	return true;
 }
 
-static data_for_each_cmd_t _convert_list_json(const data_t *data, void *arg)
+static void _write(writer_t *w, const char *str, size_t bytes)
 {
-	convert_foreach_arg_t *args = arg;
-	json_object *jobj = args->jobj;
-	json_object *jarray = _data_to_json(data, args->flags);
+	if (!_reserve(w, bytes))
+		return;
+
+	memcpy((get_buf_data(w->buf) + get_buf_offset(w->buf)), str, bytes);
+	set_buf_offset(w->buf, (get_buf_offset(w->buf) + bytes));
+}
 
-	xassert(args->magic == MAGIC_CONVERT_FOREACH);
+#define _write_str(w, str) _write(w, str, strlen(str))
 
-	json_object_array_add(jobj, jarray);
-	return DATA_FOR_EACH_CONT;
+static void _write_newline(writer_t *w, int level)
+{
+	size_t bytes = (level * SERIALIZER_JSON_INDENT) + 1;
+	char *pos;
+
+	if (!w->pretty || !_reserve(w, bytes))
+		return;
+
+	pos = get_buf_data(w->buf) + get_buf_offset(w->buf);
+	pos[0] = '\n';
+	memset((pos + 1), ' ', (bytes - 1));
+	set_buf_offset(w->buf, (get_buf_offset(w->buf) + bytes));
 }
 
-static json_object *_data_to_json(const data_t *d, serializer_flags_t flags)
+/* Write string with the same escaping done by json-c */
+static void _write_string(writer_t *w, const char *str)
 {
-	if (!d)
-		return NULL;
+	const char *start = str;
+
+	_write(w, "\"", 1);
+
+	for (; *str; str++) {
+		const unsigned char c = *str;
+		const char *esc = NULL;
+		char hex[7];
+
+		switch (c) {
+		case '\b':
+			esc = "\\b";
+			break;
+		case '\n':
+			esc = "\\n";
+			break;
+		case '\r':
+			esc = "\\r";
+			break;
+		case '\t':
+			esc = "\\t";
+			break;
+		case '\f':
+			esc = "\\f";
+			break;
+		case '"':
+			esc = "\\\"";
+			break;
+		case '\\':
+			esc = "\\\\";
+			break;
+		case '/':
+			esc = "\\/";
+			break;
+		default:
+			if (c < ' ') {
+				(void) snprintf(hex, sizeof(hex), "\\u%04x", c);
+				esc = hex;
+			}
+			break;
+		}
+
+		if (!esc)
+			continue;
+
+		_write(w, start, (str - start));
+		_write_str(w, esc);
+		start = str + 1;
+	}
+
+	_write(w, start, (str - start));
+	_write(w, "\"", 1);
+}
+
+/* Write float with the same format as json-c */
+static void _write_float(writer_t *w, double value)
+{
+	char str[64];
+	int bytes;
+
+	if (!(w->flags & SER_FLAGS_COMPLEX)) {
+		if (isinf(value))
+			value = (double) INFINITE64;
+		else if (isnan(value))
+			value = (double) NO_VAL64;
+	}
+
+	if (isnan(value)) {
+		_write_str(w, "NaN");
+		return;
+	} else if (isinf(value)) {
+		_write_str(w, ((value > 0) ? "Infinity" : "-Infinity"));
+		return;
+	}
+
+	bytes = snprintf(str, sizeof(str), "%.17g", value);
+
+	/* Always mark value as a float */
+	if (!strpbrk(str, ".e"))
+		bytes += snprintf((str + bytes), (sizeof(str) - bytes), ".0");
+
+	_write(w, str, bytes);
+}
+
+/* Start next entry in dict or list at level */
+static void _write_entry(writer_t *w, bool *first, int level)
+{
+	if (!*first)
+		_write(w, ",", 1);
+	*first = false;
+
+	_write_newline(w, (level + 1));
+}
+
+static void _write_separator(write_foreach_arg_t *args)
+{
+	_write_entry(args->writer, &args->first, args->level);
+}
+
+static data_for_each_cmd_t _write_dict_json(const char *key,
+					    const data_t *data, void *arg)
+{
+	write_foreach_arg_t *args = arg;
+	writer_t *w = args->writer;
+
+	xassert(args->magic == MAGIC_WRITE_FOREACH);
+
+	_write_separator(args);
+	_write_string(w, key);
+
+	if (w->pretty)
+		_write(w, ": ", 2);
+	else
+		_write(w, ":", 1);
+
+	_write_data(w, data, (args->level + 1));
+
+	return (w->rc ? DATA_FOR_EACH_FAIL : DATA_FOR_EACH_CONT);
+}
+
+static data_for_each_cmd_t _write_list_json(const data_t *data, void *arg)
+{
+	write_foreach_arg_t *args = arg;
+	writer_t *w = args->writer;
+
+	xassert(args->magic == MAGIC_WRITE_FOREACH);
+
+	_write_separator(args);
+	_write_data(w, data, (args->level + 1));
+
+	return (w->rc ? DATA_FOR_EACH_FAIL : DATA_FOR_EACH_CONT);
+}
+
+static void _write_data(writer_t *w, const data_t *d, int level)
+{
+	xassert(w->magic == MAGIC_WRITER);
+
+	if (w->rc)
+		return;
 
 	switch (data_get_type(d)) {
+	case DATA_TYPE_NONE:
 	case DATA_TYPE_NULL:
-		return NULL;
+		_write_str(w, "null");
 		break;
 	case DATA_TYPE_BOOL:
-		return json_object_new_boolean(data_get_bool(d));
+		_write_str(w, (data_get_bool(d) ? "true" : "false"));
 		break;
 	case DATA_TYPE_FLOAT:
-		if (!(flags & SER_FLAGS_COMPLEX)) {
-			if (isinf(data_get_float(d)))
-				return json_object_new_double(
-					(double) INFINITE64);
-			else if (isnan(data_get_float(d)))
-				return json_object_new_double(
-					(double) NO_VAL64);
-		}
-
-		return json_object_new_double(data_get_float(d));
+		_write_float(w, data_get_float(d));
 		break;
 	case DATA_TYPE_INT_64:
-		return json_object_new_int64(data_get_int(d));
+	{
+		char str[32];
+		int bytes = snprintf(str, sizeof(str), "%"PRId64,
+				     data_get_int(d));
+
+		_write(w, str, bytes);
 		break;
+	}
 	case DATA_TYPE_DICT:
 	{
-		json_object *jobj = json_object_new_object();
-		convert_foreach_arg_t args = {
-			.magic = MAGIC_CONVERT_FOREACH,
-			.jobj = jobj,
-			.flags = flags,
+		write_foreach_arg_t args = {
+			.magic = MAGIC_WRITE_FOREACH,
+			.writer = w,
+			.level = level,
+			.first = true,
 		};
-		if (data_dict_for_each_const(d, _convert_dict_json, &args) < 0)
-			error("%s: unexpected error calling _convert_dict_json()",
+
+		_write(w, "{", 1);
+		if ((data_dict_for_each_const(d, _write_dict_json, &args) < 0) &&
+		    !w->rc)
+			error("%s: unexpected error calling _write_dict_json()",
 			      __func__);
-		return jobj;
+		if (!args.first)
+			_write_newline(w, level);
+		_write(w, "}", 1);
+		break;
 	}
 	case DATA_TYPE_LIST:
 	{
-		json_object *jobj = json_object_new_array();
-		convert_foreach_arg_t args = {
-			.magic = MAGIC_CONVERT_FOREACH,
-			.jobj = jobj,
-			.flags = flags,
+		write_foreach_arg_t args = {
+			.magic = MAGIC_WRITE_FOREACH,
+			.writer = w,
+			.level = level,
+			.first = true,
 		};
-		if (data_list_for_each_const(d, _convert_list_json, &args) < 0)
-			error("%s: unexpected error calling _convert_list_json()",
+
+		_write(w, "[", 1);
+		if ((data_list_for_each_const(d, _write_list_json, &args) < 0) &&
+		    !w->rc)
+			error("%s: unexpected error calling _write_list_json()",
 			      __func__);
-		return jobj;
+		if (!args.first)
+			_write_newline(w, level);
+		_write(w, "]", 1);
+		break;
 	}
 	case DATA_TYPE_STRING:
 	{
 		const char *str = data_get_string(d);
-		if (str)
-			return json_object_new_string(str);
-		else
-			return json_object_new_string("");
+
+		_write_string(w, (str ? str : ""));
 		break;
 	}
 	default:
@@ -266,30 +451,34 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
-	struct json_object *jobj = NULL;
-	int jflags = 0;
+	writer_t w = {
+		.magic = MAGIC_WRITER,
+		.buf = init_buf(BUF_SIZE),
+	};
 
 	flags = _merge_flags(flags);
-	jobj = _data_to_json(src, flags);
 
 	/* can't be pretty and compact at the same time! */
 	xassert((flags & (SER_FLAGS_PRETTY | SER_FLAGS_COMPACT)) !=
 		(SER_FLAGS_PRETTY | SER_FLAGS_COMPACT));
 
-	if (flags & SER_FLAGS_PRETTY)
-		jflags = JSON_C_TO_STRING_SPACED | JSON_C_TO_STRING_PRETTY;
-	else if (flags & SER_FLAGS_COMPACT)
-		jflags = JSON_C_TO_STRING_PLAIN;
-	else
-		jflags = SERIALIZER_JSON_DEFAULT_FORMAT;
+	w.flags = flags;
+	w.pretty = (flags & SER_FLAGS_PRETTY);
 
-	/* string will die with jobj */
-	*dest = xstrdup(json_object_to_json_string_ext(jobj, jflags));
-	if (length)
-		*length = strlen(*dest);
+	_write_data(&w, src, 0);
+	/* always terminate string */
+	_write(&w, "", 1);
 
-	/* put is equiv to free() */
-	json_object_put(jobj);
+	if (w.rc) {
+		error("%s: unable to serialize JSON: %s",
+		      __func__, slurm_strerror(w.rc));
+		FREE_NULL_BUFFER(w.buf);
+		return w.rc;
+	}
+
+	if (length)
+		*length = get_buf_offset(w.buf) - 1;
+	*dest = xfer_buf_data(w.buf);
 
 	return SLURM_SUCCESS;
 }
@@ -329,12 +518,152 @@ extern int serialize_p_string_to_data(data_t **dest, const char *src,
 	return rc;
 }
 
+/* Start next value received from emitter */
+static void _emit_prefix(writer_t *w)
+{
+	if (w->after_key) {
+		w->after_key = false;
+		return;
+	}
+
+	if (w->depth)
+		_write_entry(w, &w->first[w->depth - 1], (w->depth - 1));
+}
+
+static int _emit_open(writer_t *w, const char *open)
+{
+	xassert(w->magic == MAGIC_WRITER);
+
+	_emit_prefix(w);
+	_write_str(w, open);
+
+	if (w->depth >= w->depth_size) {
+		w->depth_size = MAX(8, (w->depth_size * 2));
+		xrecalloc(w->first, w->depth_size, sizeof(*w->first));
+	}
+
+	w->first[w->depth++] = true;
+
+	return w->rc;
+}
+
+static int _emit_close(writer_t *w, const char *close)
+{
+	xassert(w->magic == MAGIC_WRITER);
+	xassert(w->depth > 0);
+	xassert(!w->after_key);
+
+	w->depth--;
+
+	if (!w->first[w->depth])
+		_write_newline(w, w->depth);
+	_write_str(w, close);
+
+	return w->rc;
+}
+
+static int _emit_dict_begin(void *arg)
+{
+	return _emit_open(arg, "{");
+}
+
+static int _emit_dict_key(void *arg, const char *key)
+{
+	writer_t *w = arg;
+
+	xassert(w->magic == MAGIC_WRITER);
+	xassert(w->depth > 0);
+	xassert(!w->after_key);
+
+	_write_entry(w, &w->first[w->depth - 1], (w->depth - 1));
+	_write_string(w, key);
+
+	if (w->pretty)
+		_write(w, ": ", 2);
+	else
+		_write(w, ":", 1);
+
+	w->after_key = true;
+
+	return w->rc;
+}
+
+static int _emit_dict_end(void *arg)
+{
+	return _emit_close(arg, "}");
+}
+
+static int _emit_list_begin(void *arg)
+{
+	return _emit_open(arg, "[");
+}
+
+static int _emit_list_end(void *arg)
+{
+	return _emit_close(arg, "]");
+}
+
+static int _emit_value(void *arg, const data_t *value)
+{
+	writer_t *w = arg;
+
+	xassert(w->magic == MAGIC_WRITER);
+
+	_emit_prefix(w);
+	_write_data(w, value, w->depth);
+
+	return w->rc;
+}
+
 extern int serialize_p_dump(serialize_dump_state_t **state_ptr,
-			    data_parser_type_t type, void *src,
-			    ssize_t src_bytes, buf_t *dst,
+			    data_parser_t *parser, data_parser_type_t type,
+			    void *src, ssize_t src_bytes, buf_t *dst,
 			    serializer_flags_t flags)
 {
-	return ESLURM_NOT_SUPPORTED;
+	writer_t w = {
+		.magic = MAGIC_WRITER,
+		.buf = dst,
+	};
+	const data_parser_emitter_t emitter = {
+		.dict_begin = _emit_dict_begin,
+		.dict_key = _emit_dict_key,
+		.dict_end = _emit_dict_end,
+		.list_begin = _emit_list_begin,
+		.list_end = _emit_list_end,
+		.value = _emit_value,
+		.arg = &w,
+	};
+	uint32_t offset;
+	int rc;
+
+	/* Dump is always completed in a single call */
+	xassert(!*state_ptr);
+
+	if (!dst)
+		return SLURM_SUCCESS;
+
+	offset = get_buf_offset(dst);
+
+	if (data_parser_g_is_complex(parser))
+		flags |= SER_FLAGS_COMPLEX;
+
+	flags = _merge_flags(flags);
+	w.flags = flags;
+	w.pretty = (flags & SER_FLAGS_PRETTY);
+
+	rc = data_parser_g_dump_emit(parser, type, src, src_bytes, &emitter);
+
+	if (!rc)
+		rc = w.rc;
+
+	xassert(rc || !w.depth);
+	xfree(w.first);
+
+	/* Avoid leaving partial output behind */
+	if (rc)
+		set_buf_offset(dst, offset);
+
+	return rc;
 }
 
 extern int serialize_p_parse(serialize_parse_state_t **state_ptr,
@@ -774,8 +774,8 @@ extern int serialize_p_string_to_data(data_t **dest, const char *src,
 }
 
 extern int serialize_p_dump(serialize_dump_state_t **state_ptr,
-			    data_parser_type_t type, void *src,
-			    ssize_t src_bytes, buf_t *dst,
+			    data_parser_t *parser, data_parser_type_t type,
+			    void *src, ssize_t src_bytes, buf_t *dst,
 			    serializer_flags_t flags)
 {
 	return ESLURM_NOT_SUPPORTED;
@@ -71,12 +71,14 @@
 #define OPT_LONG_HELPSTATE 0x113
 #define OPT_LONG_HELPREASON 0x114
 #define OPT_LONG_EXPAND_PATTERNS 0x115
+#define OPT_LONG_STREAM    0x116
 
 #define JOB_HASH_SIZE 1000
 
 static void _help_fields_msg(void);
 static void _help_msg(void);
 static void _init_params(void);
+static void _print_job(slurmdb_job_rec_t *job);
 static void _usage(void);
 
 decl_static_data(help_txt);
@@ -370,18 +372,65 @@ static void _remove_duplicate_fed_jobs(list_t *jobs)
 	xfree(hash_job);
 }
 
-extern int get_data(void)
+static void _aggregate_job_steps(slurmdb_job_rec_t *job)
 {
-	slurmdb_job_rec_t *job = NULL;
 	slurmdb_step_rec_t *step = NULL;
-	list_itr_t *itr = NULL;
 	list_itr_t *itr_step = NULL;
+
+	if (!job->steps || !list_count(job->steps))
+		return;
+
+	itr_step = list_iterator_create(job->steps);
+	while ((step = list_next(itr_step))) {
+		/* now aggregate the aggregatable */
+
+		if (step->state < JOB_COMPLETE)
+			continue;
+		job->tot_cpu_sec += step->tot_cpu_sec;
+		job->tot_cpu_usec += step->tot_cpu_usec;
+		job->user_cpu_sec +=
+			step->user_cpu_sec;
+		job->user_cpu_usec +=
+			step->user_cpu_usec;
+		job->sys_cpu_sec +=
+			step->sys_cpu_sec;
+		job->sys_cpu_usec +=
+			step->sys_cpu_usec;
+	}
+	list_iterator_destroy(itr_step);
+}
+
+static int _for_each_aggregate_job(void *x, void *arg)
+{
+	_aggregate_job_steps(x);
+
+	return 0;
+}
+
+static int _for_each_stream_job(void *x, void *arg)
+{
+	slurmdb_job_rec_t *job = x;
+
+	_aggregate_job_steps(job);
+	_print_job(job);
+
+	return 0;
+}
+
+extern int get_data(void)
+{
 	slurmdb_job_cond_t *job_cond = params.job_cond;
-	int cnt;
 
 	if (params.opt_completion) {
 		jobs = slurmdb_jobcomp_jobs_get(job_cond);
 		return SLURM_SUCCESS;
+	} else if (params.opt_stream && !params.mimetype) {
+		/*
+		 * Print jobs as they arrive. Nothing is left in the jobs list
+		 * so do_list() has nothing to do afterwards.
+		 */
+		return slurmdb_jobs_foreach(acct_db_conn, job_cond,
+					    _for_each_stream_job, NULL);
 	} else {
 		jobs = slurmdb_jobs_get(acct_db_conn, job_cond);
 	}
@@ -402,32 +451,7 @@ extern int get_data(void)
 	else
 		list_sort(jobs, _sort_desc_submit_time);
 
-	itr = list_iterator_create(jobs);
-	while ((job = list_next(itr))) {
-
-		if (!job->steps || !(cnt = list_count(job->steps)))
-			continue;
-
-		itr_step = list_iterator_create(job->steps);
-		while ((step = list_next(itr_step))) {
-			/* now aggregate the aggregatable */
-
-			if (step->state < JOB_COMPLETE)
-				continue;
-			job->tot_cpu_sec += step->tot_cpu_sec;
-			job->tot_cpu_usec += step->tot_cpu_usec;
-			job->user_cpu_sec +=
-				step->user_cpu_sec;
-			job->user_cpu_usec +=
-				step->user_cpu_usec;
-			job->sys_cpu_sec +=
-				step->sys_cpu_sec;
-			job->sys_cpu_usec +=
-				step->sys_cpu_usec;
-		}
-		list_iterator_destroy(itr_step);
-	}
-	list_iterator_destroy(itr);
+	list_for_each(jobs, _for_each_aggregate_job, NULL);
 
 	return SLURM_SUCCESS;
 }
@@ -500,6 +524,7 @@ extern void parse_command_line(int argc, char **argv)
                 {"reason",         required_argument, 0,    'R'},
                 {"state",          required_argument, 0,    's'},
                 {"starttime",      required_argument, 0,    'S'},
+                {"stream",         no_argument,       0,    OPT_LONG_STREAM},
                 {"truncate",       no_argument,       0,    'T'},
                 {"uid",            required_argument, 0,    'u'},
 		{"use-local-uid",  no_argument,       0,    OPT_LONG_LOCAL_UID},
@@ -688,6 +713,9 @@ extern void parse_command_line(int argc, char **argv)
 			params.opt_local = true;
 			all_clusters = false;
 			break;
+		case OPT_LONG_STREAM:
+			params.opt_stream = true;
+			break;
 		case OPT_LONG_NOCONVERT:
 			params.convert_flags |= CONVERT_NUM_UNIT_NO;
 			break;
@@ -1264,6 +1292,39 @@ static void _print_env(slurmdb_job_rec_t *job)
 	printf("%s", job->env ? job->env : "NONE\n");
 }
 
+static void _print_job(slurmdb_job_rec_t *job)
+{
+	list_itr_t *itr_step = NULL;
+	slurmdb_step_rec_t *step = NULL;
+	slurmdb_job_cond_t *job_cond = params.job_cond;
+
+	if ((params.cluster_name) &&
+	    _test_local_job(job->jobid) &&
+	    xstrcmp(params.cluster_name, job->cluster))
+		return;
+
+	if (job_cond->flags & JOBCOND_FLAG_SCRIPT) {
+		_print_script(job);
+		return;
+	} else if (job_cond->flags & JOBCOND_FLAG_ENV) {
+		_print_env(job);
+		return;
+	}
+
+	if (job->show_full)
+		print_fields(JOB, job);
+
+	if (!(job_cond->flags & JOBCOND_FLAG_NO_STEP)) {
+		itr_step = list_iterator_create(job->steps);
+		while ((step = list_next(itr_step))) {
+			if (step->end == 0)
+				step->end = job->end;
+			print_fields(JOBSTEP, step);
+		}
+		list_iterator_destroy(itr_step);
+	}
+}
+
 /* do_list() -- List the assembled data
  *
  * In:	Nothing explicit.
@@ -1275,10 +1336,7 @@ static void _print_env(slurmdb_job_rec_t *job)
 extern void do_list(int argc, char **argv)
 {
 	list_itr_t *itr = NULL;
-	list_itr_t *itr_step = NULL;
 	slurmdb_job_rec_t *job = NULL;
-	slurmdb_step_rec_t *step = NULL;
-	slurmdb_job_cond_t *job_cond = params.job_cond;
 
 	if (params.mimetype) {
 		DATA_DUMP_CLI_SINGLE(OPENAPI_SLURMDBD_JOBS_RESP, jobs, argc,
@@ -1291,33 +1349,8 @@ extern void do_list(int argc, char **argv)
 		return;
 
 	itr = list_iterator_create(jobs);
-	while ((job = list_next(itr))) {
-		if ((params.cluster_name) &&
-		    _test_local_job(job->jobid) &&
-		    xstrcmp(params.cluster_name, job->cluster))
-			continue;
-
-		if (job_cond->flags & JOBCOND_FLAG_SCRIPT) {
-			_print_script(job);
-			continue;
-		} else if (job_cond->flags & JOBCOND_FLAG_ENV) {
-			_print_env(job);
-			continue;
-		}
-
-		if (job->show_full)
-			print_fields(JOB, job);
-
-		if (!(job_cond->flags & JOBCOND_FLAG_NO_STEP)) {
-			itr_step = list_iterator_create(job->steps);
-			while ((step = list_next(itr_step))) {
-				if (step->end == 0)
-					step->end = job->end;
-				print_fields(JOBSTEP, step);
-			}
-			list_iterator_destroy(itr_step);
-		}
-	}
+	while ((job = list_next(itr)))
+		_print_job(job);
 	list_iterator_destroy(itr);
 }
 
@@ -221,6 +221,7 @@ typedef struct {
 	gid_t opt_gid;		/* running persons gid */
 	bool opt_local;		/* --local */
 	int opt_noheader;	/* can only be cleared */
+	bool opt_stream;	/* --stream */
 	uid_t opt_uid;		/* running persons uid */
 	int units;		/* --units*/
 	bool use_local_uid;	/* --use-local-uid */
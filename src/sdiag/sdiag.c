@@ -235,6 +235,29 @@ static int _print_stats(void)
 		       buf->bf_exit[i]);
 	}
 
+	printf("\nJob state save statistics (microseconds):\n");
+	printf("\tTotal saves: %u\n", buf->job_state_save_counter);
+	printf("\tLast save: %u\n", buf->job_state_save_last);
+	printf("\tMax save:  %u\n", buf->job_state_save_max);
+	printf("\tLast job lock hold: %u\n", buf->job_state_save_lock_last);
+	printf("\tMax job lock hold:  %u\n", buf->job_state_save_lock_max);
+
+	if (buf->lock_type_size)
+		printf("\nLock contention statistics (microseconds):\n");
+	for (i = 0; i < buf->lock_type_size; i++) {
+		printf("\t%-12s read: count:%-10"PRIu64" waited:%-8"PRIu64
+		       " wait_time:%-12"PRIu64" max_wait:%"PRIu64"\n",
+		       buf->lock_type_name[i], buf->lock_read_cnt[i],
+		       buf->lock_read_wait_cnt[i], buf->lock_read_wait_time[i],
+		       buf->lock_read_wait_max[i]);
+		printf("\t%-12s write: count:%-10"PRIu64" waited:%-8"PRIu64
+		       " wait_time:%-12"PRIu64" max_wait:%"PRIu64"\n",
+		       "", buf->lock_write_cnt[i],
+		       buf->lock_write_wait_cnt[i],
+		       buf->lock_write_wait_time[i],
+		       buf->lock_write_wait_max[i]);
+	}
+
 	printf("\nLatency for 1000 calls to gettimeofday(): %d microseconds\n",
 	       buf->gettimeofday_latency);
 
@@ -49,6 +49,13 @@
 
 #define _DEBUG 0
 
+/*
+ * Number of slots in the job count limit cache and the number of seconds an
+ * entry may be trusted even if no usage or limit change has been seen.
+ */
+#define LIMIT_CACHE_SIZE 1024
+#define LIMIT_CACHE_MAX_AGE 5
+
 enum {
 	ACCT_POLICY_ADD_SUBMIT,
 	ACCT_POLICY_REM_SUBMIT,
@@ -98,6 +105,26 @@ typedef struct {
 	uint64_t *used_tres_run_secs;
 } foreach_part_qos_limit_usage_t;
 
+/*
+ * Cached result of a job count limit (GrpJobs, MaxJobs, MaxJobsPerAccount,
+ * MaxJobsPerUser) blocking jobs with the same association, user and QOS pair.
+ * These limits do not depend on anything else in the job, so every other job
+ * with the same key is blocked too until usage or limits change.
+ */
+typedef struct {
+	slurmdb_assoc_rec_t *assoc_ptr;
+	uint64_t generation;
+	slurmdb_qos_rec_t *qos_ptr_1;
+	slurmdb_qos_rec_t *qos_ptr_2;
+	uint32_t state_reason;
+	time_t time;
+	uint32_t user_id;
+} limit_cache_t;
+
+static limit_cache_t limit_cache[LIMIT_CACHE_SIZE];
+static uint64_t limit_cache_gen = 1;
+static pthread_mutex_t limit_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void _apply_limit_factor(uint64_t *limit, double limit_factor)
 {
 	int64_t new_val;
@@ -670,6 +697,109 @@ static bool _valid_job_assoc(job_record_t *job_ptr)
 	return true;
 }
 
+static bool _limit_cache_reason(uint32_t state_reason)
+{
+	switch (state_reason) {
+	case WAIT_ASSOC_GRP_JOB:
+	case WAIT_ASSOC_MAX_JOBS:
+	case WAIT_QOS_GRP_JOB:
+	case WAIT_QOS_MAX_JOB_PER_ACCT:
+	case WAIT_QOS_MAX_JOB_PER_USER:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Het job limit checks temporarily point usage_het at the aggregated usage of
+ * the whole het job, which must never be cached or served from the cache.
+ */
+static bool _limit_cache_usable(job_record_t *job_ptr,
+				slurmdb_qos_rec_t *qos_ptr_1,
+				slurmdb_qos_rec_t *qos_ptr_2)
+{
+	if (job_ptr->assoc_ptr->usage_het ||
+	    (qos_ptr_1 && qos_ptr_1->usage_het) ||
+	    (qos_ptr_2 && qos_ptr_2->usage_het))
+		return false;
+
+	return true;
+}
+
+static limit_cache_t *_limit_cache_slot(job_record_t *job_ptr,
+					slurmdb_qos_rec_t *qos_ptr_1,
+					slurmdb_qos_rec_t *qos_ptr_2)
+{
+	uint64_t key = (uintptr_t) job_ptr->assoc_ptr;
+
+	key = (key * 31) ^ (uintptr_t) qos_ptr_1;
+	key = (key * 31) ^ (uintptr_t) qos_ptr_2;
+	key = (key * 31) ^ job_ptr->user_id;
+	key ^= key >> 17;
+
+	return &limit_cache[key % LIMIT_CACHE_SIZE];
+}
+
+/*
+ * Look for a cached job count limit blocking this job.
+ * RET true and set job_ptr->state_reason if found, false otherwise
+ */
+static bool _limit_cache_get(job_record_t *job_ptr,
+			     slurmdb_qos_rec_t *qos_ptr_1,
+			     slurmdb_qos_rec_t *qos_ptr_2)
+{
+	limit_cache_t *entry;
+	bool found = false;
+
+	if (!_limit_cache_usable(job_ptr, qos_ptr_1, qos_ptr_2))
+		return false;
+
+	slurm_mutex_lock(&limit_cache_mutex);
+	entry = _limit_cache_slot(job_ptr, qos_ptr_1, qos_ptr_2);
+	if ((entry->generation == limit_cache_gen) &&
+	    (entry->assoc_ptr == job_ptr->assoc_ptr) &&
+	    (entry->qos_ptr_1 == qos_ptr_1) &&
+	    (entry->qos_ptr_2 == qos_ptr_2) &&
+	    (entry->user_id == job_ptr->user_id) &&
+	    ((time(NULL) - entry->time) < LIMIT_CACHE_MAX_AGE)) {
+		xfree(job_ptr->state_desc);
+		job_ptr->state_reason = entry->state_reason;
+		found = true;
+	}
+	slurm_mutex_unlock(&limit_cache_mutex);
+
+	if (found)
+		debug2("%pJ being held, assoc %u is still at its %s limit",
+		       job_ptr, job_ptr->assoc_ptr->id,
+		       job_state_reason_string(job_ptr->state_reason));
+
+	return found;
+}
+
+/* Remember the job count limit which just blocked this job, if any */
+static void _limit_cache_set(job_record_t *job_ptr,
+			     slurmdb_qos_rec_t *qos_ptr_1,
+			     slurmdb_qos_rec_t *qos_ptr_2)
+{
+	limit_cache_t *entry;
+
+	if (!_limit_cache_reason(job_ptr->state_reason) ||
+	    !_limit_cache_usable(job_ptr, qos_ptr_1, qos_ptr_2))
+		return;
+
+	slurm_mutex_lock(&limit_cache_mutex);
+	entry = _limit_cache_slot(job_ptr, qos_ptr_1, qos_ptr_2);
+	entry->assoc_ptr = job_ptr->assoc_ptr;
+	entry->generation = limit_cache_gen;
+	entry->qos_ptr_1 = qos_ptr_1;
+	entry->qos_ptr_2 = qos_ptr_2;
+	entry->state_reason = job_ptr->state_reason;
+	entry->time = time(NULL);
+	entry->user_id = job_ptr->user_id;
+	slurm_mutex_unlock(&limit_cache_mutex);
+}
+
 /* Set the job_ptr->qos_ptr to the highest priority QOS */
 static void _set_highest_prio_qos_ptr(job_record_t *job_ptr)
 {
@@ -963,6 +1093,9 @@ static void _adjust_limit_usage(int type, job_record_t *job_ptr,
 	    || !_valid_job_assoc(job_ptr))
 		return;
 
+	/* Job counts are about to change, cached limit results are stale */
+	acct_policy_invalidate_limit_cache();
+
 	if (type == ACCT_POLICY_JOB_FINI)
 		priority_g_job_end(job_ptr);
 	else if (type == ACCT_POLICY_JOB_BEGIN) {
@@ -3747,6 +3880,7 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 	bool rc = true;
 	uint32_t wall_mins;
 	bool safe_limits = false;
+	bool cached = false;
 	int parent = 0; /* flag to tell us if we are looking at the
 			 * parent or not
 			 */
@@ -3782,6 +3916,15 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 
 	acct_policy_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
+	/*
+	 * Another job with the same association, user and QOS was already
+	 * found blocked by a job count limit and nothing has changed since.
+	 */
+	if ((cached = _limit_cache_get(job_ptr, qos_ptr_1, qos_ptr_2))) {
+		rc = false;
+		goto end_it;
+	}
+
 	/* check the first QOS setting it's values in the qos_rec */
 	if (qos_ptr_1 &&
 	    !(rc = _qos_job_runnable_pre_select(job_ptr, qos_ptr_1, &qos_rec)))
@@ -3959,6 +4102,8 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 		parent = 1;
 	}
 end_it:
+	if (!rc && !cached)
+		_limit_cache_set(job_ptr, qos_ptr_1, qos_ptr_2);
 	if (!assoc_mgr_locked)
 		assoc_mgr_unlock(&locks);
 	slurmdb_free_qos_rec_members(&qos_rec);
@@ -3966,6 +4111,13 @@ end_it:
 	return rc;
 }
 
+extern void acct_policy_invalidate_limit_cache(void)
+{
+	slurm_mutex_lock(&limit_cache_mutex);
+	limit_cache_gen++;
+	slurm_mutex_unlock(&limit_cache_mutex);
+}
+
 /*
  * acct_policy_job_runnable_post_select - After nodes have been
  *	selected for the job verify the counts don't exceed aggregated limits.
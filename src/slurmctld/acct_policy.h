@@ -112,6 +112,13 @@ extern bool acct_policy_validate(job_desc_msg_t *job_desc,
 extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 						bool assoc_mgr_locked);
 
+/*
+ * acct_policy_invalidate_limit_cache - Discard the cached job count limit
+ *	results used by acct_policy_job_runnable_pre_select(). Must be called
+ *	whenever association or QOS limits change outside of this module.
+ */
+extern void acct_policy_invalidate_limit_cache(void);
+
 /*
  * acct_policy_job_runnable_post_select - After nodes have been
  *	selected for the job verify the counts don't exceed aggregated limits.
@@ -55,6 +55,13 @@
  *  communicated with up to AGENT_THREAD_COUNT. A special watchdog thread
  *  sends SIGLARM to any threads that have been active (in DSH_ACTIVE state)
  *  for more than MessageTimeout seconds.
+ *
+ *  Messages sent directly to each node without a reply (e.g. reconfigure,
+ *  shutdown and srun notifications) are instead handed to conmgr when it is
+ *  running. The main agent thread starts a non-blocking connection per node,
+ *  up to AGENT_CON_COUNT across all agents, and conmgr's connect and write
+ *  timeouts take the place of the watchdog thread. No thread is used per
+ *  node.
  *  The agent responds to slurmctld via a function call or an RPC as required.
  *  For example, informing slurmctld that some node is not responding.
  *
@@ -90,6 +97,8 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+#include "src/conmgr/conmgr.h"
+
 #include "src/interfaces/select.h"
 
 #include "src/slurmctld/agent.h"
@@ -173,6 +182,12 @@ typedef struct {
 	char *tls_cert;
 } task_info_t;
 
+typedef struct {
+	agent_info_t *agent_info_ptr;	/* agent owning this connection */
+	thd_t *thread_ptr;		/* node state in agent_info_ptr */
+	bool sent;			/* message fully written */
+} agent_con_t;
+
 typedef struct {
 	agent_arg_t* agent_arg_ptr;	/* The queued request */
 	time_t       first_attempt;	/* Time of first check for batch
@@ -191,6 +206,7 @@ typedef struct {
 	slurm_step_id_t step_id;
 } srun_no_resp_t;
 
+static void _agent_conmgr(agent_info_t *agent_info_ptr);
 static void _agent_defer(void);
 static void _agent_retry(int min_wait, bool wait_too);
 static int  _batch_launch_defer(queued_request_t *queued_req_ptr);
@@ -206,6 +222,7 @@ static void _queue_agent_retry(agent_info_t * agent_info_ptr, int count);
 static void _queue_srun_no_resp(slurm_msg_t *msg);
 static void _queue_update_node(char *node_name);
 static void _queue_update_srun(slurm_step_id_t *step_id);
+static bool _send_direct(slurm_msg_type_t msg_type);
 static int  _setup_requeue(agent_arg_t *agent_arg_ptr, thd_t *thread_ptr,
 			   int *count, int *spot);
 static void *_thread_per_group_rpc(void *args);
@@ -240,6 +257,9 @@ static pthread_mutex_t agent_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cnt_cond  = PTHREAD_COND_INITIALIZER;
 static int agent_cnt = 0;
 static int agent_thread_cnt = 0;
+static pthread_mutex_t agent_con_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t agent_con_cond = PTHREAD_COND_INITIALIZER;
+static int agent_con_cnt = 0;	/* conmgr connections across all agents */
 static int mail_thread_cnt = 0;
 static uint16_t message_timeout = NO_VAL16;
 
@@ -278,7 +298,7 @@ void *agent(void *args)
 	thd_t *thread_ptr;
 	task_info_t *task_specific_ptr;
 	time_t begin_time;
-	bool spawn_retry_agent = false;
+	bool spawn_retry_agent = false, use_conmgr;
 	int rpc_thread_cnt;
 
 	log_flag(AGENT, "%s: Agent_cnt=%d agent_thread_cnt=%d with msg_type=%s retry_list_size=%d",
@@ -288,7 +308,14 @@ void *agent(void *args)
 
 	slurm_mutex_lock(&agent_cnt_mutex);
 
-	rpc_thread_cnt = 2 + MIN(agent_arg_ptr->node_count, AGENT_THREAD_COUNT);
+	/* Connections handed to conmgr only need this thread to wait */
+	use_conmgr = (_send_direct(agent_arg_ptr->msg_type) &&
+		      conmgr_enabled());
+	if (use_conmgr)
+		rpc_thread_cnt = 1;
+	else
+		rpc_thread_cnt = 2 + MIN(agent_arg_ptr->node_count,
+					 AGENT_THREAD_COUNT);
 	while (1) {
 		if (slurmctld_config.shutdown_time ||
 		    ((agent_thread_cnt+rpc_thread_cnt) <= MAX_SERVER_THREADS)) {
@@ -312,17 +339,23 @@ void *agent(void *args)
 	agent_info_ptr = _make_agent_info(agent_arg_ptr);
 	thread_ptr = agent_info_ptr->thread_struct;
 
-	/* start the watchdog thread */
-	slurm_thread_create(NULL, &thread_wdog, _wdog, agent_info_ptr);
-
-	log_flag(AGENT, "%s: New agent thread_count:%d threads_active:%d retry:%c get_reply:%c r_uid:%u msg_type:%s protocol_version:%hu",
+	log_flag(AGENT, "%s: New agent thread_count:%d threads_active:%d retry:%c get_reply:%c r_uid:%u msg_type:%s protocol_version:%hu conmgr:%c",
 		 __func__, agent_info_ptr->thread_count,
 		 agent_info_ptr->threads_active,
 		 agent_info_ptr->retry ? 'T' : 'F',
 		 agent_info_ptr->get_reply ? 'T' : 'F',
 		 agent_info_ptr->r_uid,
 		 rpc_num2string(agent_arg_ptr->msg_type),
-		 agent_info_ptr->protocol_version);
+		 agent_info_ptr->protocol_version,
+		 use_conmgr ? 'T' : 'F');
+
+	if (use_conmgr) {
+		_agent_conmgr(agent_info_ptr);
+		goto done;
+	}
+
+	/* start the watchdog thread */
+	slurm_thread_create(NULL, &thread_wdog, _wdog, agent_info_ptr);
 
 	/* start all the other threads (up to AGENT_THREAD_COUNT active) */
 	for (i = 0; i < agent_info_ptr->thread_count; i++) {
@@ -362,6 +395,7 @@ void *agent(void *args)
 		slurm_thread_join(thread_ptr[i].thread);
 	slurm_mutex_unlock(&agent_info_ptr->thread_mutex);
 
+done:
 	log_flag(AGENT, "%s: end agent thread_count:%d threads_active:%d retry:%c get_reply:%c msg_type:%s protocol_version:%hu",
 		 __func__, agent_info_ptr->thread_count,
 		 agent_info_ptr->threads_active,
@@ -428,6 +462,35 @@ static int _valid_agent_arg(agent_arg_t *agent_arg_ptr)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Message is going to one node (for srun) or we want it to get processed ASAP
+ * (SHUTDOWN or RECONFIGURE). Send the message directly to each node.
+ * Otherwise push all message forwarding to slurmd in order to offload as much
+ * work from slurmctld as possible.
+ */
+static bool _send_direct(slurm_msg_type_t msg_type)
+{
+	switch (msg_type) {
+	case REQUEST_JOB_NOTIFY:
+	case REQUEST_REBOOT_NODES:
+	case REQUEST_RUN_POWER_ACTION:
+	case REQUEST_RECONFIGURE:
+	case REQUEST_RECONFIGURE_SACKD:
+	case REQUEST_RECONFIGURE_WITH_CONFIG:
+	case REQUEST_SHUTDOWN:
+	case SRUN_TIMEOUT:
+	case SRUN_NODE_FAIL:
+	case SRUN_REQUEST_SUSPEND:
+	case SRUN_USER_MSG:
+	case SRUN_STEP_MISSING:
+	case SRUN_STEP_SIGNAL:
+	case SRUN_JOB_COMPLETE:
+		return true;
+	default:
+		return false;
+	}
+}
+
 static agent_info_t *_make_agent_info(agent_arg_t *agent_arg_ptr)
 {
 	agent_info_t *agent_info_ptr = NULL;
@@ -457,31 +520,8 @@ static agent_info_t *_make_agent_info(agent_arg_t *agent_arg_ptr)
 	xassert(agent_arg_ptr->node_count ==
 		hostlist_count(agent_arg_ptr->hostlist));
 
-	if ((agent_arg_ptr->msg_type != REQUEST_JOB_NOTIFY)	&&
-	    (agent_arg_ptr->msg_type != REQUEST_REBOOT_NODES)	&&
-	    (agent_arg_ptr->msg_type != REQUEST_RUN_POWER_ACTION) &&
-	    (agent_arg_ptr->msg_type != REQUEST_RECONFIGURE)	&&
-	    (agent_arg_ptr->msg_type != REQUEST_RECONFIGURE_SACKD) &&
-	    (agent_arg_ptr->msg_type != REQUEST_RECONFIGURE_WITH_CONFIG) &&
-	    (agent_arg_ptr->msg_type != REQUEST_SHUTDOWN)	&&
-	    (agent_arg_ptr->msg_type != SRUN_TIMEOUT)		&&
-	    (agent_arg_ptr->msg_type != SRUN_NODE_FAIL)		&&
-	    (agent_arg_ptr->msg_type != SRUN_REQUEST_SUSPEND)	&&
-	    (agent_arg_ptr->msg_type != SRUN_USER_MSG)		&&
-	    (agent_arg_ptr->msg_type != SRUN_STEP_MISSING)	&&
-	    (agent_arg_ptr->msg_type != SRUN_STEP_SIGNAL)	&&
-	    (agent_arg_ptr->msg_type != SRUN_JOB_COMPLETE)) {
-		/* Sending message to a possibly large number of slurmd.
-		 * Push all message forwarding to slurmd in order to
-		 * offload as much work from slurmctld as possible. */
-		split = false;
+	if (!(split = _send_direct(agent_arg_ptr->msg_type)))
 		agent_info_ptr->get_reply = true;
-	} else {
-		/* Message is going to one node (for srun) or we want
-		 * it to get processed ASAP (SHUTDOWN or RECONFIGURE).
-		 * Send the message directly to each node. */
-		split = true;
-	}
 	if (agent_arg_ptr->addr || !split) {
 		thread_ptr[0].state = DSH_NEW;
 		if (agent_arg_ptr->addr) {
@@ -587,21 +627,48 @@ static void _update_wdog_state(thd_t *thread_ptr,
 }
 
 /*
- * _wdog - Watchdog thread. Send SIGUSR1 to threads which have been active
- *	for too long.
- * IN args - pointer to agent_info_t with info on threads to watch
- * Sleep between polls with exponential times (from 0.005 to 1.0 second)
+ * Tally the state of every thread of an agent
+ * NOTE: agent_ptr->thread_mutex must be locked
  */
-static void *_wdog(void *args)
+static void _wdog_scan(agent_info_t *agent_ptr, thd_complete_t *thd_comp)
 {
-	bool srun_agent = false, sack_agent = false;
-	int i;
-	agent_info_t *agent_ptr = (agent_info_t *) args;
 	thd_t *thread_ptr = agent_ptr->thread_struct;
-	unsigned long usec = 5000;
-	list_itr_t *itr;
-	thd_complete_t thd_comp;
 	ret_data_info_t *ret_data_info = NULL;
+	list_itr_t *itr;
+
+	thd_comp->work_done   = true;/* assume all threads complete */
+	thd_comp->fail_cnt    = 0;   /* assume no threads failures */
+	thd_comp->no_resp_cnt = 0;   /* assume all threads respond */
+	thd_comp->retry_cnt   = 0;   /* assume no required retries */
+	thd_comp->now         = time(NULL);
+
+	for (int i = 0; i < agent_ptr->thread_count; i++) {
+		//info("thread name %s",thread_ptr[i].node_name);
+		if (!thread_ptr[i].ret_list) {
+			_update_wdog_state(&thread_ptr[i],
+					   &thread_ptr[i].state,
+					   thd_comp);
+		} else {
+			itr = list_iterator_create(thread_ptr[i].ret_list);
+			while ((ret_data_info = list_next(itr))) {
+				_update_wdog_state(&thread_ptr[i],
+						   &ret_data_info->err,
+						   thd_comp);
+			}
+			list_iterator_destroy(itr);
+		}
+	}
+}
+
+/*
+ * Notify slurmctld of the results of a completed agent and release the
+ * per-thread results
+ * NOTE: agent_ptr->thread_mutex must be locked
+ */
+static void _agent_complete(agent_info_t *agent_ptr, thd_complete_t *thd_comp)
+{
+	bool srun_agent = false, sack_agent = false;
+	thd_t *thread_ptr = agent_ptr->thread_struct;
 
 	if ( (agent_ptr->msg_type == SRUN_JOB_COMPLETE)			||
 	     (agent_ptr->msg_type == SRUN_REQUEST_SUSPEND)		||
@@ -617,42 +684,6 @@ static void *_wdog(void *args)
 	if (agent_ptr->msg_type == REQUEST_RECONFIGURE_SACKD)
 		sack_agent = true;
 
-	thd_comp.max_delay = 0;
-
-	while (1) {
-		thd_comp.work_done   = true;/* assume all threads complete */
-		thd_comp.fail_cnt    = 0;   /* assume no threads failures */
-		thd_comp.no_resp_cnt = 0;   /* assume all threads respond */
-		thd_comp.retry_cnt   = 0;   /* assume no required retries */
-		thd_comp.now         = time(NULL);
-
-		usleep(usec);
-		usec = MIN((usec * 2), 1000000);
-
-		slurm_mutex_lock(&agent_ptr->thread_mutex);
-		for (i = 0; i < agent_ptr->thread_count; i++) {
-			//info("thread name %s",thread_ptr[i].node_name);
-			if (!thread_ptr[i].ret_list) {
-				_update_wdog_state(&thread_ptr[i],
-						   &thread_ptr[i].state,
-						   &thd_comp);
-			} else {
-				itr = list_iterator_create(
-					thread_ptr[i].ret_list);
-				while ((ret_data_info = list_next(itr))) {
-					_update_wdog_state(&thread_ptr[i],
-							   &ret_data_info->err,
-							   &thd_comp);
-				}
-				list_iterator_destroy(itr);
-			}
-		}
-		if (thd_comp.work_done)
-			break;
-
-		slurm_mutex_unlock(&agent_ptr->thread_mutex);
-	}
-
 	if (sack_agent) {
 		if (thread_ptr[0].state != DSH_DONE)
 			sackd_mgr_remove_node(thread_ptr[0].nodename);
@@ -660,18 +691,47 @@ static void *_wdog(void *args)
 		_notify_slurmctld_jobs(agent_ptr);
 	} else if (agent_ptr->msg_type != REQUEST_SHUTDOWN) {
 		_notify_slurmctld_nodes(agent_ptr,
-					thd_comp.no_resp_cnt,
-					thd_comp.retry_cnt);
+					thd_comp->no_resp_cnt,
+					thd_comp->retry_cnt);
 	}
 
-	for (i = 0; i < agent_ptr->thread_count; i++) {
+	for (int i = 0; i < agent_ptr->thread_count; i++) {
 		FREE_NULL_LIST(thread_ptr[i].ret_list);
 		xfree(thread_ptr[i].nodename);
 	}
 
-	if (thd_comp.max_delay)
+	if (thd_comp->max_delay)
 		log_flag(AGENT, "%s: agent maximum delay %d seconds",
-			 __func__, thd_comp.max_delay);
+			 __func__, thd_comp->max_delay);
+}
+
+/*
+ * _wdog - Watchdog thread. Send SIGUSR1 to threads which have been active
+ *	for too long.
+ * IN args - pointer to agent_info_t with info on threads to watch
+ * Sleep between polls with exponential times (from 0.005 to 1.0 second)
+ */
+static void *_wdog(void *args)
+{
+	agent_info_t *agent_ptr = (agent_info_t *) args;
+	unsigned long usec = 5000;
+	thd_complete_t thd_comp;
+
+	thd_comp.max_delay = 0;
+
+	while (1) {
+		usleep(usec);
+		usec = MIN((usec * 2), 1000000);
+
+		slurm_mutex_lock(&agent_ptr->thread_mutex);
+		_wdog_scan(agent_ptr, &thd_comp);
+		if (thd_comp.work_done)
+			break;
+
+		slurm_mutex_unlock(&agent_ptr->thread_mutex);
+	}
+
+	_agent_complete(agent_ptr, &thd_comp);
 
 	slurm_mutex_unlock(&agent_ptr->thread_mutex);
 	return NULL;
@@ -1348,6 +1408,232 @@ cleanup:
 	return NULL;
 }
 
+/*
+ * Record the result of one conmgr connection and release its slot
+ * IN agent_con - connection state, xfree'd here
+ * IN rc - SLURM_SUCCESS if message was sent or reason for failure
+ */
+static void _agent_con_fini(agent_con_t *agent_con, int rc)
+{
+	agent_info_t *agent_ptr = agent_con->agent_info_ptr;
+	thd_t *thread_ptr = agent_con->thread_ptr;
+	slurm_msg_type_t msg_type = agent_ptr->msg_type;
+	state_t thread_state = DSH_DONE;
+	/* Lock: Read node */
+	slurmctld_lock_t node_read_lock = {
+		.node = READ_LOCK,
+	};
+
+	if (rc && ((msg_type == SRUN_JOB_COMPLETE) ||
+		   (msg_type == SRUN_STEP_SIGNAL))) {
+		/* See _thread_per_group_rpc() use of slurm_send_msg_maybe() */
+		log_flag(NET, "%s: %s to %s failed: %s",
+			 __func__, rpc_num2string(msg_type),
+			 thread_ptr->nodename, slurm_strerror(rc));
+	} else if (rc) {
+		thread_state = DSH_NO_RESP;
+		if ((msg_type != REQUEST_RECONFIGURE_SACKD) &&
+		    strncmp(rpc_num2string(msg_type), "SRUN_", 5)) {
+			errno = rc;
+			lock_slurmctld(node_read_lock);
+			_comm_err(thread_ptr->nodename, msg_type);
+			unlock_slurmctld(node_read_lock);
+		}
+	}
+
+	slurm_mutex_lock(&agent_ptr->thread_mutex);
+	thread_ptr->state = thread_state;
+	thread_ptr->end_time = (time_t) difftime(time(NULL),
+						 thread_ptr->start_time);
+	agent_ptr->threads_active--;
+	slurm_cond_signal(&agent_ptr->thread_cond);
+	slurm_mutex_unlock(&agent_ptr->thread_mutex);
+
+	slurm_mutex_lock(&agent_con_mutex);
+	agent_con_cnt--;
+	slurm_cond_broadcast(&agent_con_cond);
+	slurm_mutex_unlock(&agent_con_mutex);
+
+	xfree(agent_con);
+}
+
+static void _agent_con_sent(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	agent_con_t *agent_con = arg;
+
+	if ((conmgr_args.status == CONMGR_WORK_STATUS_CANCELLED) ||
+	    conmgr_args.status_code)
+		return;
+
+	/* Nothing more to do with the connection once the message is out */
+	agent_con->sent = true;
+	conmgr_con_queue_close(conmgr_args.ref);
+}
+
+static void *_agent_con_on_connection(conmgr_callback_args_t conmgr_args,
+				      void *arg)
+{
+	agent_con_t *agent_con = arg;
+	agent_info_t *agent_ptr = agent_con->agent_info_ptr;
+	slurm_msg_t msg;
+	int rc;
+
+	slurm_msg_t_init(&msg);
+	if (agent_ptr->protocol_version)
+		msg.protocol_version = agent_ptr->protocol_version;
+	msg.msg_type = agent_ptr->msg_type;
+	msg.data = *agent_ptr->msg_args_pptr;
+	slurm_msg_set_r_uid(&msg, agent_ptr->r_uid);
+	msg.flags |= agent_ptr->msg_flags;
+
+	if ((rc = conmgr_con_queue_write_msg(conmgr_args.ref, &msg))) {
+		log_flag(AGENT, "%s: [%s] unable to send %s: %s",
+			 __func__, conmgr_con_get_name(conmgr_args.ref),
+			 rpc_num2string(msg.msg_type), slurm_strerror(rc));
+		/* on_finish() will not be called once NULL is returned */
+		_agent_con_fini(agent_con, rc);
+		return NULL;
+	}
+
+	conmgr_add_work_con_write_complete_fifo(conmgr_args.con,
+						_agent_con_sent, agent_con);
+	return agent_con;
+}
+
+static int _agent_con_on_msg(conmgr_callback_args_t conmgr_args,
+			     slurm_msg_t *msg, int unpack_rc, void *arg)
+{
+	/* No reply is expected to any message sent by _agent_conmgr() */
+	log_flag(AGENT, "%s: [%s] ignoring unexpected %s",
+		 __func__, conmgr_con_get_name(conmgr_args.ref),
+		 rpc_num2string(msg->msg_type));
+	slurm_free_msg(msg);
+	return SLURM_SUCCESS;
+}
+
+static void _agent_con_on_finish(conmgr_callback_args_t conmgr_args,
+				 void *arg)
+{
+	agent_con_t *agent_con = arg;
+	int rc = SLURM_SUCCESS;
+
+	if (!agent_con->sent &&
+	    !(rc = conmgr_args.status_code))
+		rc = SLURM_COMMUNICATIONS_SEND_ERROR;
+
+	_agent_con_fini(agent_con, rc);
+}
+
+static void _agent_con_on_connect_failed(conmgr_callback_args_t conmgr_args,
+					 void *arg)
+{
+	int rc = conmgr_args.status_code;
+
+	if (!rc)
+		rc = SLURM_COMMUNICATIONS_CONNECTION_ERROR;
+
+	_agent_con_fini(arg, rc);
+}
+
+/*
+ * Start sending the agent's message to one node through conmgr
+ * NOTE: _agent_con_fini() is always called for thread_ptr once done
+ */
+static void _agent_con_start(agent_info_t *agent_ptr, thd_t *thread_ptr)
+{
+	static const conmgr_events_t events = {
+		.on_connection = _agent_con_on_connection,
+		.on_msg = _agent_con_on_msg,
+		.on_finish = _agent_con_on_finish,
+		.on_connect_failed = _agent_con_on_connect_failed,
+	};
+	agent_con_t *agent_con = xmalloc(sizeof(*agent_con));
+	slurm_addr_t addr;
+	int rc;
+
+	agent_con->agent_info_ptr = agent_ptr;
+	agent_con->thread_ptr = thread_ptr;
+
+	slurm_mutex_lock(&agent_ptr->thread_mutex);
+	thread_ptr->start_time = time(NULL);
+	thread_ptr->state = DSH_ACTIVE;
+	agent_ptr->threads_active++;
+	slurm_mutex_unlock(&agent_ptr->thread_mutex);
+
+	log_flag(AGENT, "%s: sending %s to %s", __func__,
+		 rpc_num2string(agent_ptr->msg_type), thread_ptr->nodename);
+
+	if ((agent_ptr->msg_type == SRUN_PING) ||
+	    (agent_ptr->msg_type == SRUN_TIMEOUT)) {
+		slurm_msg_t msg = {
+			.msg_type = agent_ptr->msg_type,
+			.data = *agent_ptr->msg_args_pptr,
+		};
+
+		_queue_srun_no_resp(&msg);
+	}
+
+	if (thread_ptr->addr) {
+		addr = *thread_ptr->addr;
+	} else if (slurm_conf_get_addr(thread_ptr->nodename, &addr,
+				       agent_ptr->msg_flags)) {
+		error("%s: can't find address for host %s, check slurm.conf",
+		      __func__, thread_ptr->nodename);
+		/* Not a communication error so skip _comm_err() */
+		slurm_mutex_lock(&agent_ptr->thread_mutex);
+		thread_ptr->state = DSH_NO_RESP;
+		agent_ptr->threads_active--;
+		slurm_mutex_unlock(&agent_ptr->thread_mutex);
+
+		slurm_mutex_lock(&agent_con_mutex);
+		agent_con_cnt--;
+		slurm_cond_broadcast(&agent_con_cond);
+		slurm_mutex_unlock(&agent_con_mutex);
+
+		xfree(agent_con);
+		return;
+	}
+
+	if ((rc = conmgr_create_connect_socket(CON_TYPE_RPC, CON_FLAG_NONE,
+					       &addr, sizeof(addr), &events,
+					       agent_ptr->tls_cert,
+					       agent_con))) {
+		log_flag(AGENT, "%s: connect to %s failed: %s",
+			 __func__, thread_ptr->nodename, slurm_strerror(rc));
+		_agent_con_fini(agent_con, rc);
+	}
+}
+
+/*
+ * Send the agent's message directly to every node through conmgr and wait for
+ * all of them to complete. Used instead of _wdog() and _thread_per_group_rpc()
+ * for messages that do not expect a reply.
+ */
+static void _agent_conmgr(agent_info_t *agent_ptr)
+{
+	thd_complete_t thd_comp = { 0 };
+
+	for (int i = 0; i < agent_ptr->thread_count; i++) {
+		/* wait until "room" for another connection */
+		slurm_mutex_lock(&agent_con_mutex);
+		while (agent_con_cnt >= AGENT_CON_COUNT)
+			slurm_cond_wait(&agent_con_cond, &agent_con_mutex);
+		agent_con_cnt++;
+		slurm_mutex_unlock(&agent_con_mutex);
+
+		_agent_con_start(agent_ptr, &agent_ptr->thread_struct[i]);
+	}
+
+	slurm_mutex_lock(&agent_ptr->thread_mutex);
+	while (agent_ptr->threads_active)
+		slurm_cond_wait(&agent_ptr->thread_cond,
+				&agent_ptr->thread_mutex);
+
+	_wdog_scan(agent_ptr, &thd_comp);
+	_agent_complete(agent_ptr, &thd_comp);
+	slurm_mutex_unlock(&agent_ptr->thread_mutex);
+}
+
 static int _setup_requeue(agent_arg_t *agent_arg_ptr, thd_t *thread_ptr,
 			  int *count, int *spot)
 {
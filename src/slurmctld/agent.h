@@ -45,6 +45,8 @@
 #include "src/slurmctld/slurmctld.h"
 
 #define AGENT_THREAD_COUNT	10	/* maximum active threads per agent */
+#define AGENT_CON_COUNT		1024	/* maximum outstanding conmgr connections
+				 * across all agents */
 
 #define LOTS_OF_AGENTS_CNT 50
 #define LOTS_OF_AGENTS ((get_agent_count() <= LOTS_OF_AGENTS_CNT) ? 0 : 1)
@@ -764,7 +764,9 @@ int main(int argc, char **argv)
 	if (slurm_conf.slurmctld_params)
 		conmgr_set_params(slurm_conf.slurmctld_params);
 
-	conmgr_init(0, 0, SLURMCTLD_CONMGR_DEFAULT_MAX_CONNECTIONS);
+	/* Outbound agent connections must not defer accepting new RPCs */
+	conmgr_init(0, 0,
+		    (SLURMCTLD_CONMGR_DEFAULT_MAX_CONNECTIONS + AGENT_CON_COUNT));
 
 	conmgr_add_work_fifo(_register_signal_handlers, NULL);
 
@@ -2113,6 +2115,7 @@ static void _remove_assoc(slurmdb_assoc_rec_t *rec)
 {
 	int cnt = 0;
 
+	acct_policy_invalidate_limit_cache();
 	bb_g_reconfig();
 
 	cnt = job_hold_by_assoc_id(rec->id);
@@ -2181,6 +2184,8 @@ static void _remove_qos(slurmdb_qos_rec_t *rec)
 	slurmctld_lock_t part_write_lock =
 		{ NO_LOCK, NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK };
 
+	acct_policy_invalidate_limit_cache();
+
 	lock_slurmctld(part_write_lock);
 	if (part_list)
 		(void) list_for_each(part_list, _foreach_part_remove_qos, rec);
@@ -2212,6 +2217,8 @@ static void _update_assoc(slurmdb_assoc_rec_t *rec)
 	slurmctld_lock_t job_write_lock =
 		{ NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 
+	acct_policy_invalidate_limit_cache();
+
 	if (!job_list || !accounting_enforce
 	    || !(accounting_enforce & ACCOUNTING_ENFORCE_LIMITS))
 		return;
@@ -2262,6 +2269,8 @@ static void _update_qos(slurmdb_qos_rec_t *rec)
 	slurmctld_lock_t job_write_lock =
 		{ NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 
+	acct_policy_invalidate_limit_cache();
+
 	if (!job_list || !accounting_enforce
 	    || !(accounting_enforce & ACCOUNTING_ENFORCE_LIMITS))
 		return;
@@ -78,6 +78,7 @@
 #include "src/common/tres_bind.h"
 #include "src/common/tres_frequency.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/accounting_storage.h"
@@ -123,13 +124,80 @@
 #define TOP_PRIORITY 0xffff0000	/* large, but leave headroom for higher */
 #define PURGE_OLD_JOB_IN_SEC 2592000 /* 30 days in seconds */
 
-#define JOB_HASH_INX(_job_id)	(_job_id % hash_table_size)
-#define JOB_ARRAY_HASH_INX(_job_id, _task_id)		\
-	((_job_id + _task_id) % hash_table_size)
+#define JOB_HASH_MIN_SIZE 1024	/* initial slot count, must be power of 2 */
+#define JOB_HASH_MIGRATE_SLOTS 16 /* slots moved per job hash update */
 
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define JOB_STATE_VERSION     "PROTOCOL_VERSION"
 
+#define JOB_JOURNAL_FILE "job_state.journal"
+#define JOB_JOURNAL_COMPACT_PCT_DEFAULT 50
+
+typedef enum {
+	JOB_JOURNAL_INVALID = 0,
+	JOB_JOURNAL_UPDATE, /* packed job record follows */
+	JOB_JOURNAL_PURGE, /* job record was purged */
+} job_journal_op_t;
+
+typedef struct {
+	uint32_t job_id;
+	uint16_t op; /* job_journal_op_t */
+	char *data; /* packed job record, points into job_journal_t->buffer */
+	uint32_t size;
+} job_journal_rec_t;
+
+typedef struct {
+	buf_t *buffer; /* contents of JOB_JOURNAL_FILE */
+	uint16_t protocol_version;
+	uint32_t job_id_sequence; /* from last complete batch */
+	time_t bf_when_last_cycle; /* from last complete batch */
+	list_t *rec_list; /* list of job_journal_rec_t in journal order */
+	xhash_t *rec_hash; /* latest job_journal_rec_t by job_id */
+	bool replaying; /* true while loading records from rec_list */
+} job_journal_t;
+
+typedef struct {
+	uint32_t job_id;
+	uint32_t offset; /* start of packed record in state save buffer */
+	uint32_t size;
+} job_state_range_t;
+
+typedef struct {
+	buf_t *buffer;
+	bool fingerprint; /* remember fingerprints of packed records */
+	bool journal; /* only pack records changed since last written */
+	uint32_t pass; /* mark for job_record_t->state_save_pass */
+	uint32_t rec_cnt;
+	xhash_t *ranges; /* job_state_range_t by job_id, snapshot only */
+	list_t *stale; /* job_state_range_t to drop from the snapshot */
+	timespec_t lock_start; /* when the job lock was last acquired */
+	uint64_t lock_max_usec; /* longest continuous job lock hold */
+} job_state_dump_args_t;
+
+/* show_flags that change pack_job() output */
+#define JOB_PACK_CACHE_FLAGS SHOW_DETAIL
+/* Most cached pack_job() records kept per job */
+#define JOB_PACK_CACHE_MAX 4
+
+typedef struct {
+	uint16_t protocol_version;
+	uint16_t show_flags; /* masked with JOB_PACK_CACHE_FLAGS */
+	bool compact; /* packed with buf_set_compact(), without interning */
+	uint32_t gen; /* job_pack_cache_gen when packed */
+	time_t expires; /* record depends on the time, 0 if it does not */
+	char *data; /* pack_job() output, NULL if never packed */
+	uint32_t size;
+	time_t changed; /* when data last changed, for SHOW_DELTA */
+} job_pack_cache_t;
+
+/* How long purged job ids are kept for SHOW_DELTA requests */
+#define JOB_TOMBSTONE_AGE 600
+
+typedef struct {
+	uint32_t job_id;
+	time_t purged;
+} job_tombstone_t;
+
 typedef enum {
 	JOB_HASH_JOB,
 	JOB_HASH_SLUID,
@@ -137,6 +205,24 @@ typedef enum {
 	JOB_HASH_ARRAY_TASK,
 } job_hash_type_t;
 
+/*
+ * Slot of the job hash. All job_hash_type_t indexes share one open addressing
+ * (linear probing) table so a lookup only touches the slots, never the job
+ * records of colliding jobs. Slot is empty if job_ptr is NULL.
+ */
+typedef struct {
+	uint64_t key;		/* job_id, sluid or array_job_id/task_id */
+	uint32_t hash;		/* full hash of type and key */
+	uint32_t type;		/* job_hash_type_t */
+	job_record_t *job_ptr;	/* JOB_HASH_ARRAY_JOB: first array task */
+} job_hash_slot_t;
+
+typedef struct {
+	job_hash_slot_t *slots;
+	uint32_t size;		/* power of 2 */
+	uint32_t count;		/* used slots */
+} job_hash_table_t;
+
 typedef struct {
 	int resp_array_cnt;
 	int resp_array_size;
@@ -157,8 +243,18 @@ typedef struct {
 	slurmdb_user_rec_t user_rec;
 	bool privileged;
 	part_record_t **visible_parts;
+	time_t now;
+	time_t delta_time; /* only pack jobs changed since, 0 for all */
+	uint64_t fields; /* JOB_FIELD_* to pack, 0 for all */
+	bool compact; /* buffer is in compact mode */
 } _foreach_pack_job_info_t;
 
+typedef struct {
+	uint32_t after_job_id;
+	job_record_t **jobs;
+	int job_cnt;
+} _foreach_page_job_t;
+
 typedef struct {
 	bitstr_t *node_map;
 	list_t *license_list;
@@ -342,13 +438,12 @@ static int      bf_min_age_reserve = 0;
 static uint32_t delay_boot = 0;
 static uint32_t highest_prio = 0;
 static uint32_t lowest_prio  = TOP_PRIORITY;
-static int      hash_table_size = 0;
 static int      job_count = 0;		/* job's in the system */
 static uint32_t job_id_sequence = 0;	/* first job_id to assign new job */
-static struct   job_record **job_hash = NULL;
-static struct job_record **job_hash_sluid = NULL;
-static struct   job_record **job_array_hash_j = NULL;
-static struct   job_record **job_array_hash_t = NULL;
+static job_hash_table_t job_hash = { 0 };
+static job_hash_table_t job_hash_old = { 0 }; /* being moved into job_hash */
+static uint32_t job_hash_migrate = 0;	/* next job_hash_old slot to move */
+static uint32_t job_hash_migrated = 0;	/* job_hash_old slots moved */
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
@@ -356,6 +451,25 @@ static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
 static bool     validate_cfgd_licenses = true;
 
+/* job_state journal, see SlurmctldParameters=job_state_journal */
+static bool     job_journal_enabled = false;
+static bool     job_journal_compact = true;	/* next save is a snapshot */
+static uint32_t job_journal_compact_pct = JOB_JOURNAL_COMPACT_PCT_DEFAULT;
+static list_t  *job_journal_purged = NULL;	/* job ids, uses job lock */
+static uint64_t job_journal_size = 0;
+static uint64_t job_journal_snapshot_size = 0;
+static job_journal_t *job_journal_load = NULL;	/* only during recovery */
+static uint32_t job_state_save_pass = 0;
+static uint32_t job_state_save_yield = 0;	/* msec, 0 to never yield */
+
+/* REQUEST_JOB_INFO cache, see SlurmctldParameters=job_info_cache */
+static bool     job_pack_cache_enabled = false;
+static pthread_mutex_t job_pack_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t job_pack_cache_gen = 0;
+static buf_t   *job_pack_cache_buf = NULL;
+static list_t  *job_tombstones = NULL;	/* job_tombstone_t, oldest first */
+static time_t   job_tombstone_horizon = 0; /* newest tombstone dropped */
+
 /* Local functions */
 static void _signal_pending_job_array_tasks(job_record_t *job_ptr,
 					    bitstr_t **array_bitmap,
@@ -366,6 +480,9 @@ static void _signal_pending_job_array_tasks(job_record_t *job_ptr,
 static void _add_job_hash(job_record_t *job_ptr);
 static void _add_job_hash_sluid(job_record_t *job_ptr);
 static void _add_job_array_hash(job_record_t *job_ptr);
+static job_record_t *_find_first_job_array_rec(uint32_t array_job_id);
+static int  _clear_job_pack_cache(void *x, void *arg);
+static void _job_pack_cache_purge(job_record_t *job_ptr);
 static void _handle_requeue_limit(job_record_t *job_ptr, const char *caller);
 static int  _copy_job_desc_to_file(job_desc_msg_t * job_desc,
 				   uint32_t job_id);
@@ -397,6 +514,9 @@ static void _move_to_purge_jobs_list(void *job_entry);
 static time_t _get_last_job_state_write_time(void);
 static void _pack_default_job_details(job_record_t *job_ptr, buf_t *buffer,
 				      uint16_t protocol_version);
+static void _pack_job_fields(job_record_t *job_ptr, uint64_t fields,
+			     buf_t *buffer, uint16_t protocol_version);
+static void _pack_node_cnt(job_record_t *job_ptr, buf_t *buffer);
 static void _pack_pending_job_details(job_details_t *detail_ptr, buf_t *buffer,
 				      uint16_t protocol_version);
 static void _purge_missing_jobs(int node_inx, time_t now);
@@ -1042,6 +1162,613 @@ static int _get_qos_info(char *qos_req, uint32_t qos_id, list_t **qos_plist,
 
 	return rc;
 }
+
+/* FNV-1a hash of a packed job record, 0 is reserved for "not written" */
+static uint64_t _job_journal_hash(const char *data, uint32_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (uint32_t i = 0; i < size; i++) {
+		hash ^= (uint8_t) data[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash ? hash : 1;
+}
+
+static void _job_state_range_add(job_state_dump_args_t *args, uint32_t job_id,
+				 uint32_t start, uint32_t end)
+{
+	job_state_range_t *range;
+
+	/* The job id was reused, the older record is stale */
+	if ((range = xhash_pop(args->ranges, (char *) &job_id,
+			       sizeof(job_id))))
+		list_append(args->stale, range);
+
+	range = xmalloc(sizeof(*range));
+	range->job_id = job_id;
+	range->offset = start;
+	range->size = end - start;
+	xhash_add(args->ranges, range);
+}
+
+/*
+ * Pack a job record and remember its fingerprint. In journal mode the record
+ * is framed as a JOB_JOURNAL_UPDATE and discarded again if it has not
+ * changed since it was last written.
+ */
+static int _dump_job_state_rec(void *object, void *arg)
+{
+	job_record_t *job_ptr = object;
+	job_state_dump_args_t *args = arg;
+	buf_t *buffer = args->buffer;
+	uint32_t rec_offset = get_buf_offset(buffer), start, end;
+	uint64_t fingerprint;
+
+	/* Don't pack "unlinked" job. */
+	if (job_ptr->job_id == NO_VAL)
+		return 0;
+
+	job_ptr->state_save_pass = args->pass;
+
+	if (args->journal) {
+		pack32(job_ptr->job_id, buffer);
+		pack16(JOB_JOURNAL_UPDATE, buffer);
+		pack32(0, buffer); /* record size, filled in below */
+	}
+
+	start = get_buf_offset(buffer);
+	job_mgr_dump_job_state(job_ptr, buffer);
+	end = get_buf_offset(buffer);
+
+	if (args->ranges)
+		_job_state_range_add(args, job_ptr->job_id, start, end);
+
+	if (!args->fingerprint)
+		return 0;
+
+	fingerprint = _job_journal_hash(get_buf_data(buffer) + start,
+					end - start);
+
+	if (args->journal) {
+		if (fingerprint == job_ptr->state_fingerprint) {
+			set_buf_offset(buffer, rec_offset);
+			return 0;
+		}
+		set_buf_offset(buffer, (start - sizeof(uint32_t)));
+		pack32((end - start), buffer);
+		set_buf_offset(buffer, end);
+		args->rec_cnt++;
+	}
+
+	/* Only the state save thread reads or writes the fingerprint */
+	job_ptr->state_fingerprint = fingerprint;
+
+	return 0;
+}
+
+static void _job_state_range_id(void *item, const char **key,
+				uint32_t *key_len)
+{
+	job_state_range_t *range = item;
+
+	*key = (const char *) &range->job_id;
+	*key_len = sizeof(range->job_id);
+}
+
+static void _job_state_lock_held(job_state_dump_args_t *args)
+{
+	timespec_t now = { 0, 0 };
+	long usec = timer_get_duration(&args->lock_start, &now);
+
+	args->lock_max_usec = MAX(args->lock_max_usec, usec);
+}
+
+static int _job_state_id_list(void *object, void *arg)
+{
+	job_record_t *job_ptr = object;
+	uint32_t **job_id_pptr = arg;
+
+	if (job_ptr->job_id != NO_VAL)
+		*(*job_id_pptr)++ = job_ptr->job_id;
+
+	return 0;
+}
+
+/* Pack job records created while the job lock was released */
+static int _dump_job_state_sweep(void *object, void *arg)
+{
+	job_record_t *job_ptr = object, *meta_ptr;
+	job_state_dump_args_t *args = arg;
+	uint32_t chunk_pass = args->pass - 1;
+
+	if ((job_ptr->state_save_pass == chunk_pass) ||
+	    (job_ptr->state_save_pass == args->pass))
+		return 0;
+
+	(void) _dump_job_state_rec(job_ptr, args);
+
+	/*
+	 * A task split off of a job array after its meta record was packed is
+	 * still part of that packed meta record. Pack the meta record again so
+	 * the task is not recovered twice.
+	 */
+	if ((job_ptr->array_task_id != NO_VAL) &&
+	    (meta_ptr = find_job_record(job_ptr->array_job_id)) &&
+	    (meta_ptr != job_ptr) &&
+	    (meta_ptr->state_save_pass == chunk_pass))
+		(void) _dump_job_state_rec(meta_ptr, args);
+
+	return 0;
+}
+
+static void _job_state_range_check(void *item, void *arg)
+{
+	job_state_range_t *range = item;
+	job_state_dump_args_t *args = arg;
+	job_state_range_t *stale;
+
+	/* Purged while the job lock was released */
+	if (find_job_record(range->job_id))
+		return;
+
+	stale = xmalloc(sizeof(*stale));
+	*stale = *range;
+	list_append(args->stale, stale);
+}
+
+/*
+ * Pack all job records with _dump_job_state_rec(). Caller must hold
+ * job_read_lock, which is also held on return.
+ *
+ * With SlurmctldParameters=job_state_save_yield the job lock is released
+ * every job_state_save_yield msec so pending write lock RPCs can proceed.
+ * Records are tracked by job id across the yields and every record packed
+ * is marked with the pass. A final sweep under the lock packs records
+ * created in the meantime, repacks job array meta records that had tasks
+ * split off, and drops records of jobs purged in the meantime.
+ */
+static void _dump_job_state_recs(job_state_dump_args_t *args,
+				 slurmctld_lock_t job_read_lock)
+{
+	uint32_t *job_ids, *job_id_ptr, job_cnt;
+	timespec_t yield_ts = {
+		.tv_sec = job_state_save_yield / MSEC_IN_SEC,
+		.tv_nsec = (job_state_save_yield % MSEC_IN_SEC) * NSEC_IN_MSEC,
+	};
+	timespec_t deadline;
+
+	/* Passes use two marks, the second one for the final sweep */
+	job_state_save_pass += 2;
+	if (!job_state_save_pass)
+		job_state_save_pass += 2;
+	args->pass = job_state_save_pass - 1;
+
+	if (!job_state_save_yield) {
+		list_for_each_ro(job_list, _dump_job_state_rec, args);
+		return;
+	}
+
+	job_ids = xcalloc(list_count(job_list), sizeof(*job_ids));
+	job_id_ptr = job_ids;
+	list_for_each_ro(job_list, _job_state_id_list, &job_id_ptr);
+	job_cnt = job_id_ptr - job_ids;
+
+	if (!args->journal) {
+		args->ranges = xhash_init(_job_state_range_id, xfree_ptr);
+		args->stale = list_create(xfree_ptr);
+	}
+
+	deadline = timespec_add(timespec_now(), yield_ts);
+	for (uint32_t i = 0; i < job_cnt; i++) {
+		job_record_t *job_ptr = find_job_record(job_ids[i]);
+
+		if (job_ptr && (job_ptr->state_save_pass != args->pass))
+			(void) _dump_job_state_rec(job_ptr, args);
+
+		if (((i + 1) < job_cnt) &&
+		    timespec_is_after(timespec_now(), deadline)) {
+			_job_state_lock_held(args);
+			unlock_slurmctld(job_read_lock);
+			sched_yield();
+			lock_slurmctld(job_read_lock);
+			args->lock_start = timespec_now();
+			deadline = timespec_add(args->lock_start, yield_ts);
+		}
+	}
+	xfree(job_ids);
+
+	args->pass = job_state_save_pass;
+	list_for_each_ro(job_list, _dump_job_state_sweep, args);
+	if (args->ranges)
+		xhash_walk(args->ranges, _job_state_range_check, args);
+}
+
+static int _sort_job_state_range(void *x, void *y)
+{
+	job_state_range_t *range1 = *(job_state_range_t **) x;
+	job_state_range_t *range2 = *(job_state_range_t **) y;
+
+	return slurm_sort_uint32_list_asc(&range1->offset, &range2->offset);
+}
+
+/* Remove stale records found by _dump_job_state_recs() from the buffer */
+static void _drop_job_state_ranges(job_state_dump_args_t *args)
+{
+	char *data = get_buf_data(args->buffer);
+	uint32_t end = get_buf_offset(args->buffer), dst = 0, src = 0;
+	job_state_range_t *range;
+	list_itr_t *itr;
+
+	if (!args->stale || !list_count(args->stale))
+		return;
+
+	list_sort(args->stale, _sort_job_state_range);
+	itr = list_iterator_create(args->stale);
+	while ((range = list_next(itr))) {
+		if (!src) {
+			dst = range->offset;
+		} else {
+			memmove(data + dst, data + src, range->offset - src);
+			dst += range->offset - src;
+		}
+		src = range->offset + range->size;
+	}
+	list_iterator_destroy(itr);
+
+	memmove(data + dst, data + src, end - src);
+	set_buf_offset(args->buffer, (dst + (end - src)));
+
+	debug2("%s: dropped %d stale job records", __func__,
+	       list_count(args->stale));
+}
+
+static void _job_state_dump_args_free(job_state_dump_args_t *args)
+{
+	xhash_free(args->ranges);
+	FREE_NULL_LIST(args->stale);
+}
+
+static void _job_state_save_stats(job_state_dump_args_t *args, long usec)
+{
+	slurmctld_diag_stats.job_state_save_counter++;
+	slurmctld_diag_stats.job_state_save_last = usec;
+	slurmctld_diag_stats.job_state_save_max =
+		MAX(slurmctld_diag_stats.job_state_save_max, usec);
+	slurmctld_diag_stats.job_state_save_lock_last = args->lock_max_usec;
+	slurmctld_diag_stats.job_state_save_lock_max =
+		MAX(slurmctld_diag_stats.job_state_save_lock_max,
+		    args->lock_max_usec);
+}
+
+/*
+ * Start a new, empty journal for the job_state snapshot written at
+ * snapshot_time.
+ */
+static void _job_journal_reset(time_t snapshot_time, uint32_t snapshot_size)
+{
+	buf_t *buffer = init_buf(BUF_SIZE);
+
+	packstr(JOB_STATE_VERSION, buffer);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(snapshot_time, buffer);
+
+	if (save_buf_to_state(JOB_JOURNAL_FILE, buffer, NULL)) {
+		error("%s: unable to reset job state journal, next save will write a full snapshot",
+		      __func__);
+		job_journal_compact = true;
+	} else {
+		job_journal_compact = false;
+		job_journal_size = get_buf_offset(buffer);
+		job_journal_snapshot_size = snapshot_size;
+	}
+
+	FREE_NULL_BUFFER(buffer);
+}
+
+static int _job_journal_append(buf_t *buffer)
+{
+	int fd, rc = SLURM_SUCCESS;
+	char *journal_file = xstrdup_printf("%s/%s",
+					    slurm_conf.state_save_location,
+					    JOB_JOURNAL_FILE);
+
+	lock_state_files();
+	if ((fd = open(journal_file, O_WRONLY | O_APPEND | O_CLOEXEC)) < 0) {
+		rc = errno ? errno : SLURM_ERROR;
+		error("Can't save state, error opening file %s: %m",
+		      journal_file);
+		goto fini;
+	}
+
+	safe_write(fd, get_buf_data(buffer), get_buf_offset(buffer));
+
+	/* provides own logging on error */
+	if (fsync_and_close(fd, journal_file) < 0)
+		rc = SLURM_ERROR;
+	goto fini;
+
+rwfail:
+	rc = errno ? errno : SLURM_ERROR;
+	error("Can't save state, error writing file %s: %m", journal_file);
+	(void) close(fd);
+fini:
+	unlock_state_files();
+	xfree(journal_file);
+	return rc;
+}
+
+/*
+ * Append one batch of changed and purged job records to the job_state
+ * journal. A batch is framed by its size so a torn write can be detected
+ * and ignored on recovery.
+ */
+static int _dump_job_state_journal(void)
+{
+	/* Save high-water mark to avoid buffer growth with copies */
+	static uint32_t high_buffer_size = BUF_SIZE;
+	/* Locks: Read config and job */
+	slurmctld_lock_t job_read_lock =
+		{ READ_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
+	buf_t *buffer = init_buf(high_buffer_size);
+	job_state_dump_args_t args = {
+		.buffer = buffer,
+		.fingerprint = true,
+		.journal = true,
+	};
+	uint32_t cnt_offset, end, *purged_id;
+	int error_code = SLURM_SUCCESS;
+	DEF_TIMERS;
+
+	START_TIMER;
+	pack32(0, buffer); /* batch size, filled in below */
+	pack_time(time(NULL), buffer);
+
+	lock_slurmctld(job_read_lock);
+	args.lock_start = timespec_now();
+
+	pack32(job_id_sequence, buffer);
+	pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
+	cnt_offset = get_buf_offset(buffer);
+	pack32(0, buffer); /* record count, filled in below */
+
+	/* Purges go first so a record for a reused job id replays last */
+	while ((purged_id = list_pop(job_journal_purged))) {
+		if (!find_job_record(*purged_id)) {
+			pack32(*purged_id, buffer);
+			pack16(JOB_JOURNAL_PURGE, buffer);
+			pack32(0, buffer);
+			args.rec_cnt++;
+		}
+		xfree(purged_id);
+	}
+
+	_dump_job_state_recs(&args, job_read_lock);
+
+	_job_state_lock_held(&args);
+	unlock_slurmctld(job_read_lock);
+
+	if (!args.rec_cnt)
+		goto fini;
+
+	end = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	pack32((end - sizeof(uint32_t)), buffer);
+	set_buf_offset(buffer, cnt_offset);
+	pack32(args.rec_cnt, buffer);
+	set_buf_offset(buffer, end);
+
+	if ((error_code = _job_journal_append(buffer))) {
+		error("%s: unable to append to job state journal, next save will write a full snapshot",
+		      __func__);
+		job_journal_compact = true;
+	} else {
+		job_journal_size += end;
+		high_buffer_size = MAX(end, high_buffer_size);
+		debug3("%s: journaled %u job records (%u bytes)",
+		       __func__, args.rec_cnt, end);
+	}
+
+fini:
+	FREE_NULL_BUFFER(buffer);
+	END_TIMER2(__func__);
+	_job_state_save_stats(&args, TIMER_DURATION_USEC());
+	_job_state_dump_args_free(&args);
+	return error_code;
+}
+
+/* Note a purged job so that the journal records its removal */
+static void _job_journal_purge(job_record_t *job_ptr)
+{
+	uint32_t *job_id;
+
+	if (!job_journal_purged || !job_ptr->state_fingerprint ||
+	    (job_ptr->job_id == NO_VAL))
+		return;
+
+	job_id = xmalloc(sizeof(*job_id));
+	*job_id = job_ptr->job_id;
+	list_append(job_journal_purged, job_id);
+	job_ptr->state_fingerprint = 0;
+}
+
+static void _job_journal_rec_id(void *item, const char **key,
+				uint32_t *key_len)
+{
+	job_journal_rec_t *rec = item;
+
+	*key = (const char *) &rec->job_id;
+	*key_len = sizeof(rec->job_id);
+}
+
+static void _job_journal_free(job_journal_t *journal)
+{
+	if (!journal)
+		return;
+
+	xhash_free(journal->rec_hash);
+	FREE_NULL_LIST(journal->rec_list);
+	FREE_NULL_BUFFER(journal->buffer);
+	xfree(journal);
+}
+
+static int _job_journal_unpack_batch(job_journal_t *journal, buf_t *buffer)
+{
+	uint32_t batch_size, batch_end, rec_cnt, job_id_seq;
+	time_t batch_time, bf_when_last_cycle;
+	list_t *batch_list = list_create(xfree_ptr);
+	job_journal_rec_t *rec = NULL;
+
+	safe_unpack32(&batch_size, buffer);
+	if (batch_size > remaining_buf(buffer))
+		goto unpack_error;
+	batch_end = get_buf_offset(buffer) + batch_size;
+
+	safe_unpack_time(&batch_time, buffer);
+	safe_unpack32(&job_id_seq, buffer);
+	safe_unpack_time(&bf_when_last_cycle, buffer);
+	safe_unpack32(&rec_cnt, buffer);
+
+	for (uint32_t i = 0; i < rec_cnt; i++) {
+		rec = xmalloc(sizeof(*rec));
+		safe_unpack32(&rec->job_id, buffer);
+		safe_unpack16(&rec->op, buffer);
+		safe_unpack32(&rec->size, buffer);
+		if ((rec->size > remaining_buf(buffer)) ||
+		    ((rec->op != JOB_JOURNAL_UPDATE) &&
+		     (rec->op != JOB_JOURNAL_PURGE)))
+			goto unpack_error;
+		rec->data = get_buf_data(buffer) + get_buf_offset(buffer);
+		set_buf_offset(buffer, (get_buf_offset(buffer) + rec->size));
+		list_append(batch_list, rec);
+		rec = NULL;
+	}
+
+	if (get_buf_offset(buffer) != batch_end)
+		goto unpack_error;
+
+	journal->job_id_sequence = job_id_seq;
+	journal->bf_when_last_cycle = bf_when_last_cycle;
+
+	while ((rec = list_pop(batch_list))) {
+		/* Newer record replaces any older one for the same job */
+		(void) xhash_pop(journal->rec_hash, (char *) &rec->job_id,
+				 sizeof(rec->job_id));
+		xhash_add(journal->rec_hash, rec);
+		list_append(journal->rec_list, rec);
+	}
+
+	FREE_NULL_LIST(batch_list);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(rec);
+	FREE_NULL_LIST(batch_list);
+	return SLURM_ERROR;
+}
+
+/*
+ * Read the job_state journal written against the job_state snapshot saved at
+ * snapshot_time. Batches after a torn or corrupt one are ignored.
+ * RET journal or NULL if there is no journal for this snapshot
+ */
+static job_journal_t *_job_journal_read(time_t snapshot_time)
+{
+	job_journal_t *journal;
+	char *state_file = NULL, *ver_str = NULL;
+	buf_t *buffer;
+	time_t journal_time;
+	uint32_t batch_cnt = 0;
+
+	if (!(buffer = state_save_open(JOB_JOURNAL_FILE, &state_file))) {
+		debug2("No job state journal (%s) to recover", state_file);
+		xfree(state_file);
+		return NULL;
+	}
+
+	journal = xmalloc(sizeof(*journal));
+	journal->buffer = buffer;
+	journal->protocol_version = NO_VAL16;
+	journal->rec_list = list_create(xfree_ptr);
+	journal->rec_hash = xhash_init(_job_journal_rec_id, NULL);
+
+	safe_unpackstr(&ver_str, buffer);
+	if (ver_str && !xstrcmp(ver_str, JOB_STATE_VERSION))
+		safe_unpack16(&journal->protocol_version, buffer);
+	xfree(ver_str);
+
+	if (journal->protocol_version == NO_VAL16) {
+		error("Can not recover job state journal %s, incompatible version",
+		      state_file);
+		goto fail;
+	}
+
+	safe_unpack_time(&journal_time, buffer);
+	if (journal_time != snapshot_time) {
+		debug("Ignoring job state journal %s, it does not belong to the current job_state file",
+		      state_file);
+		goto fail;
+	}
+
+	while (remaining_buf(buffer) > 0) {
+		if (_job_journal_unpack_batch(journal, buffer)) {
+			error("Incomplete job state journal %s, ignoring %u bytes after batch %u",
+			      state_file, remaining_buf(buffer), batch_cnt);
+			break;
+		}
+		batch_cnt++;
+	}
+
+	debug("Read %u batches with %u job records from job state journal %s",
+	      batch_cnt, xhash_count(journal->rec_hash), state_file);
+	xfree(state_file);
+	return journal;
+
+unpack_error:
+	error("Invalid job state journal %s", state_file);
+fail:
+	xfree(ver_str);
+	xfree(state_file);
+	_job_journal_free(journal);
+	return NULL;
+}
+
+/*
+ * Load the newest record of every job in the journal that was not purged.
+ * RET count of jobs loaded or -1 on error
+ */
+static int _job_journal_replay(job_journal_t *journal)
+{
+	list_itr_t *itr = list_iterator_create(journal->rec_list);
+	job_journal_rec_t *rec;
+	int job_cnt = 0;
+
+	journal->replaying = true;
+	while ((rec = list_next(itr))) {
+		buf_t *rec_buf;
+		int rc;
+
+		if ((rec->op != JOB_JOURNAL_UPDATE) ||
+		    (xhash_get(journal->rec_hash, (char *) &rec->job_id,
+			       sizeof(rec->job_id)) != rec))
+			continue;
+
+		rec_buf = create_shadow_buf(rec->data, rec->size);
+		rc = job_mgr_load_job_state(rec_buf, journal->protocol_version);
+		FREE_NULL_BUFFER(rec_buf);
+		if (rc != SLURM_SUCCESS) {
+			job_cnt = -1;
+			break;
+		}
+		job_cnt++;
+	}
+	list_iterator_destroy(itr);
+	journal->replaying = false;
+
+	return job_cnt;
+}
+
 /*
  * dump_all_job_state - save the state of all jobs to file for checkpoint
  *	Changes here should be reflected in load_last_job_id() and
@@ -1058,13 +1785,23 @@ int dump_all_job_state(void)
 	/* Locks: Read config and job */
 	slurmctld_lock_t job_read_lock =
 		{ READ_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
-	buf_t *buffer = init_buf(high_buffer_size);
+	buf_t *buffer;
 	time_t now = time(NULL);
 	time_t last_state_file_time;
 	static time_t last_job_state_size_check = 0;
 	uint32_t jobs_start, jobs_end, jobs_count;
+	job_state_dump_args_t args = {
+		.fingerprint = job_journal_enabled,
+	};
 	DEF_TIMERS;
 
+	if (job_journal_enabled && !job_journal_compact &&
+	    (job_journal_size <= ((job_journal_snapshot_size *
+				   job_journal_compact_pct) / 100)))
+		return _dump_job_state_journal();
+
+	buffer = init_buf(high_buffer_size);
+	args.buffer = buffer;
 	START_TIMER;
 	/*
 	 * Check that last state file was written at expected time.
@@ -1102,11 +1839,15 @@ int dump_all_job_state(void)
 
 	/* write individual job records */
 	lock_slurmctld(job_read_lock);
+	args.lock_start = timespec_now();
 
 	pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
 
 	jobs_start = get_buf_offset(buffer);
-	list_for_each_ro(job_list, job_mgr_dump_job_state, buffer);
+	_dump_job_state_recs(&args, job_read_lock);
+	/* Purged jobs are already missing from the new snapshot */
+	if (job_journal_enabled)
+		list_flush(job_journal_purged);
 	jobs_end = get_buf_offset(buffer);
 	if ((difftime(now, last_job_state_size_check) > 60) &&
 	    (jobs_count = list_count(job_list))) {
@@ -1129,7 +1870,9 @@ int dump_all_job_state(void)
 			      ave_job_size);
 	}
 
+	_job_state_lock_held(&args);
 	unlock_slurmctld(job_read_lock);
+	_drop_job_state_ranges(&args);
 
 	reg_file = xstrdup_printf("%s/job_state",
 	                          slurm_conf.state_save_location);
@@ -1150,12 +1893,19 @@ int dump_all_job_state(void)
 	}
 
 	error_code = save_buf_to_state("job_state", buffer, &high_buffer_size);
-	if (!error_code)
+	if (!error_code) {
 		last_file_write_time = now;
+		if (job_journal_enabled)
+			_job_journal_reset(now, get_buf_offset(buffer));
+	} else if (job_journal_enabled) {
+		job_journal_compact = true;
+	}
 
 	xfree(reg_file);
 	FREE_NULL_BUFFER(buffer);
 	END_TIMER2(__func__);
+	_job_state_save_stats(&args, TIMER_DURATION_USEC());
+	_job_state_dump_args_free(&args);
 	return error_code;
 }
 
@@ -1299,6 +2049,7 @@ extern void set_job_tres_req_str(job_record_t *job_ptr, bool assoc_mgr_locked)
 extern void backup_slurmctld_restart(void)
 {
 	last_file_write_time = (time_t) 0;
+	job_journal_compact = true;
 }
 
 /* Return the time stamp in the current job state save file, 0 is returned on
@@ -1379,11 +2130,21 @@ extern int load_all_job_state(void)
 
 	safe_unpack_time(&buf_time, buffer);
 	safe_unpack32(&saved_job_id, buffer);
+	debug3("Job id in job_state header is %u", saved_job_id);
+
+	/* Records in the journal supersede those in the snapshot */
+	if ((job_journal_load = _job_journal_read(buf_time))) {
+		debug3("Job id in job_state journal is %u",
+		       job_journal_load->job_id_sequence);
+		saved_job_id = MAX(saved_job_id,
+				   job_journal_load->job_id_sequence);
+	}
 	if (saved_job_id <= slurm_conf.max_job_id)
 		job_id_sequence = MAX(saved_job_id, job_id_sequence);
-	debug3("Job id in job_state header is %u", saved_job_id);
 
 	safe_unpack_time(&buf_time, buffer); /* bf_when_last_cycle */
+	if (job_journal_load && job_journal_load->bf_when_last_cycle)
+		buf_time = job_journal_load->bf_when_last_cycle;
 	if (!slurmctld_diag_stats.bf_when_last_cycle)
 		slurmctld_diag_stats.bf_when_last_cycle = buf_time;
 
@@ -1402,11 +2163,26 @@ extern int load_all_job_state(void)
 	}
 	debug3("Set job_id_sequence to %u", job_id_sequence);
 
+	if (job_journal_load) {
+		int journal_cnt = _job_journal_replay(job_journal_load);
+
+		if (journal_cnt < 0) {
+			error_code = SLURM_ERROR;
+			goto unpack_error;
+		}
+		info("Recovered %d jobs from job state journal", journal_cnt);
+		job_cnt += journal_cnt;
+		_job_journal_free(job_journal_load);
+		job_journal_load = NULL;
+	}
+
 	FREE_NULL_BUFFER(buffer);
 	info("Recovered information about %d jobs", job_cnt);
 	return error_code;
 
 unpack_error:
+	_job_journal_free(job_journal_load);
+	job_journal_load = NULL;
 	if (!ignore_state_errors)
 		fatal("Incomplete job state save file, start with '-i' to ignore this. Warning: using -i will lose the data that can't be recovered.");
 	error("Incomplete job state save file");
@@ -1424,6 +2200,7 @@ extern int load_last_job_id( void )
 {
 	char *state_file = NULL;
 	buf_t *buffer;
+	job_journal_t *journal;
 	time_t buf_time;
 	char *ver_str = NULL;
 	uint16_t protocol_version = NO_VAL16;
@@ -1458,6 +2235,14 @@ extern int load_last_job_id( void )
 
 	/* Ignore the state for individual jobs stored here */
 
+	if ((journal = _job_journal_read(buf_time))) {
+		job_id_sequence = MAX(job_id_sequence,
+				      journal->job_id_sequence);
+		debug3("Job ID in job_state journal is %u",
+		       journal->job_id_sequence);
+		_job_journal_free(journal);
+	}
+
 	xfree(ver_str);
 	FREE_NULL_BUFFER(buffer);
 	return SLURM_SUCCESS;
@@ -1513,6 +2298,15 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 		goto unpack_error;
 	}
 
+	if (job_journal_load && !job_journal_load->replaying &&
+	    xhash_get(job_journal_load->rec_hash, (char *) &job_ptr->job_id,
+		      sizeof(job_ptr->job_id))) {
+		debug2("%s: %pJ superseded by job state journal",
+		       __func__, job_ptr);
+		job_record_delete(job_ptr);
+		return SLURM_SUCCESS;
+	}
+
 	if (find_job_record(job_ptr->job_id) ||
 	    find_sluid(job_ptr->step_id.sluid)) {
 		error("duplicate job state record found for %pJ", job_ptr);
@@ -1682,47 +2476,251 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 		}
 	}
 
-	/*
-	 * do this after the format string just in case for some
-	 * reason the tres_alloc_str is NULL but not the fmt_str
-	 */
-	if (job_ptr->tres_alloc_str)
-		assoc_mgr_set_tres_cnt_array(
-			&job_ptr->tres_alloc_cnt, job_ptr->tres_alloc_str,
-			0, true, false, NULL);
-	else
-		job_set_alloc_tres(job_ptr, true);
+	/*
+	 * do this after the format string just in case for some
+	 * reason the tres_alloc_str is NULL but not the fmt_str
+	 */
+	if (job_ptr->tres_alloc_str)
+		assoc_mgr_set_tres_cnt_array(
+			&job_ptr->tres_alloc_cnt, job_ptr->tres_alloc_str,
+			0, true, false, NULL);
+	else
+		job_set_alloc_tres(job_ptr, true);
+
+	if (job_ptr->tres_req_str)
+		assoc_mgr_set_tres_cnt_array(
+			&job_ptr->tres_req_cnt, job_ptr->tres_req_str, 0, true,
+			false, NULL);
+	else
+		job_set_req_tres(job_ptr, true);
+	assoc_mgr_unlock(&locks);
+
+	gres_stepmgr_job_build_details(
+		job_ptr->gres_list_alloc, job_ptr->nodes,
+		&job_ptr->gres_detail_cnt,
+		&job_ptr->gres_detail_str,
+		&job_ptr->gres_used);
+
+	on_job_state_change(job_ptr, job_ptr->job_state);
+	last_job_update = now;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("Incomplete job record");
+	rc = SLURM_ERROR;
+
+free_it:
+	if (job_ptr) {
+		if (job_ptr->job_id == 0)
+			job_ptr->job_id = NO_VAL;
+		purge_job_record(job_ptr->job_id);
+	}
+
+	return rc;
+}
+
+static uint32_t _job_hash_hash(job_hash_type_t type, uint64_t key)
+{
+	/* splitmix64 finalizer */
+	key += ((uint64_t) type + 1) * 0x9e3779b97f4a7c15ULL;
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+	key ^= key >> 31;
+
+	return (uint32_t) key;
+}
+
+static job_hash_slot_t *_job_hash_table_find(job_hash_table_t *table,
+					     uint32_t hash,
+					     job_hash_type_t type,
+					     uint64_t key)
+{
+	uint32_t mask = table->size - 1;
+
+	if (!table->count)
+		return NULL;
+
+	for (uint32_t i = (hash & mask); table->slots[i].job_ptr;
+	     i = ((i + 1) & mask)) {
+		job_hash_slot_t *slot = &table->slots[i];
+
+		if ((slot->hash == hash) && (slot->key == key) &&
+		    (slot->type == type))
+			return slot;
+	}
+
+	return NULL;
+}
+
+/* Place a slot known not to be in the table, which must have a free slot */
+static void _job_hash_table_place(job_hash_table_t *table,
+				  job_hash_slot_t *slot)
+{
+	uint32_t mask = table->size - 1, i;
+
+	for (i = (slot->hash & mask); table->slots[i].job_ptr;
+	     i = ((i + 1) & mask))
+		;
+	table->slots[i] = *slot;
+	table->count++;
+}
+
+/*
+ * Empty a slot, shifting back the following slots of its cluster so that
+ * lookups never need tombstones.
+ */
+static void _job_hash_table_del(job_hash_table_t *table, job_hash_slot_t *slot)
+{
+	uint32_t mask = table->size - 1, i = (slot - table->slots), j = i;
+
+	while (true) {
+		uint32_t home;
+
+		j = ((j + 1) & mask);
+		if (!table->slots[j].job_ptr)
+			break;
+
+		/* Leave it if its home slot is cyclically in (i, j] */
+		home = (table->slots[j].hash & mask);
+		if ((i <= j) ? ((i < home) && (home <= j)) :
+			       ((i < home) || (home <= j)))
+			continue;
+
+		table->slots[i] = table->slots[j];
+		i = j;
+	}
+
+	table->slots[i].job_ptr = NULL;
+	table->count--;
+}
+
+/*
+ * Move some slots of job_hash_old into job_hash. Always stops after an empty
+ * slot so that whole clusters are moved at once and the probe sequences of
+ * the slots left behind in job_hash_old stay intact.
+ */
+static void _job_hash_migrate(bool all)
+{
+	uint32_t mask = job_hash_old.size - 1, moved = 0;
+
+	while (job_hash_old.slots) {
+		job_hash_slot_t *slot = &job_hash_old.slots[job_hash_migrate];
+
+		if (slot->job_ptr) {
+			_job_hash_table_place(&job_hash, slot);
+			slot->job_ptr = NULL;
+			job_hash_old.count--;
+		} else if (!all && (moved >= JOB_HASH_MIGRATE_SLOTS)) {
+			break;
+		}
+
+		job_hash_migrate = ((job_hash_migrate + 1) & mask);
+		moved++;
+
+		if ((++job_hash_migrated >= job_hash_old.size) ||
+		    !job_hash_old.count) {
+			debug("%s: job hash resized to %u slots",
+			      __func__, job_hash.size);
+			xfree(job_hash_old.slots);
+			job_hash_old.size = 0;
+		}
+	}
+}
+
+/* Double the job hash. Slots are moved over by later updates. */
+static void _job_hash_grow(void)
+{
+	/* Growing again before the last resize finished is unexpected */
+	if (job_hash_old.slots)
+		_job_hash_migrate(true);
 
-	if (job_ptr->tres_req_str)
-		assoc_mgr_set_tres_cnt_array(
-			&job_ptr->tres_req_cnt, job_ptr->tres_req_str, 0, true,
-			false, NULL);
-	else
-		job_set_req_tres(job_ptr, true);
-	assoc_mgr_unlock(&locks);
+	job_hash_old = job_hash;
+	job_hash.size = (job_hash_old.size * 2);
+	job_hash.count = 0;
+	job_hash.slots = xcalloc(job_hash.size, sizeof(*job_hash.slots));
 
-	gres_stepmgr_job_build_details(
-		job_ptr->gres_list_alloc, job_ptr->nodes,
-		&job_ptr->gres_detail_cnt,
-		&job_ptr->gres_detail_str,
-		&job_ptr->gres_used);
+	/* Start moving slots after an empty slot, which must exist */
+	for (job_hash_migrate = 0;
+	     job_hash_old.slots[job_hash_migrate].job_ptr; job_hash_migrate++)
+		;
+	job_hash_migrated = 0;
+}
 
-	on_job_state_change(job_ptr, job_ptr->job_state);
-	last_job_update = now;
-	return SLURM_SUCCESS;
+static job_hash_slot_t *_job_hash_find_slot(job_hash_type_t type, uint64_t key)
+{
+	uint32_t hash = _job_hash_hash(type, key);
+	job_hash_slot_t *slot;
 
-unpack_error:
-	error("Incomplete job record");
-	rc = SLURM_ERROR;
+	if ((slot = _job_hash_table_find(&job_hash, hash, type, key)))
+		return slot;
 
-free_it:
-	if (job_ptr) {
-		if (job_ptr->job_id == 0)
-			job_ptr->job_id = NO_VAL;
-		purge_job_record(job_ptr->job_id);
+	/* Resize in progress */
+	return _job_hash_table_find(&job_hash_old, hash, type, key);
+}
+
+static job_record_t *_job_hash_find(job_hash_type_t type, uint64_t key)
+{
+	job_hash_slot_t *slot = _job_hash_find_slot(type, key);
+
+	return slot ? slot->job_ptr : NULL;
+}
+
+/* Add or replace the job record of a key in the job hash */
+static void _job_hash_set(job_hash_type_t type, uint64_t key,
+			  job_record_t *job_ptr)
+{
+	job_hash_slot_t *slot, new_slot = {
+		.key = key,
+		.hash = _job_hash_hash(type, key),
+		.type = type,
+		.job_ptr = job_ptr,
+	};
+
+	xassert(job_ptr);
+	xassert(job_hash.slots);
+
+	_job_hash_migrate(false);
+
+	if ((slot = _job_hash_find_slot(type, key))) {
+		slot->job_ptr = job_ptr;
+		return;
 	}
 
-	return rc;
+	/* Keep the load factor under 50% so clusters stay short */
+	if (((job_hash.count + 1) * 2) > job_hash.size)
+		_job_hash_grow();
+
+	_job_hash_table_place(&job_hash, &new_slot);
+}
+
+/* Remove a key from the job hash, RET false if not found */
+static bool _job_hash_del(job_hash_type_t type, uint64_t key,
+			  job_record_t *job_ptr)
+{
+	job_hash_slot_t *slot;
+
+	if (!job_hash.slots)
+		return false;
+
+	_job_hash_migrate(false);
+
+	if (!(slot = _job_hash_find_slot(type, key)) ||
+	    (slot->job_ptr != job_ptr))
+		return false;
+
+	if ((slot >= job_hash.slots) &&
+	    (slot < (job_hash.slots + job_hash.size)))
+		_job_hash_table_del(&job_hash, slot);
+	else
+		_job_hash_table_del(&job_hash_old, slot);
+
+	return true;
+}
+
+static uint64_t _job_array_task_key(uint32_t array_job_id,
+				    uint32_t array_task_id)
+{
+	return (((uint64_t) array_job_id << 32) | array_task_id);
 }
 
 /* _add_job_hash - add a job hash entry for given job record, job_id must
@@ -1732,25 +2730,59 @@ free_it:
  */
 static void _add_job_hash(job_record_t *job_ptr)
 {
-	int inx;
+	job_record_t *old_job_ptr = _job_hash_find(JOB_HASH_JOB,
+						   job_ptr->job_id);
 
-	inx = JOB_HASH_INX(job_ptr->job_id);
-	job_ptr->job_next = job_hash[inx];
-	job_hash[inx] = job_ptr;
+	if (old_job_ptr && (old_job_ptr != job_ptr))
+		error("%s: replacing hash entry of duplicate JobId=%u",
+		      __func__, job_ptr->job_id);
+
+	_job_hash_set(JOB_HASH_JOB, job_ptr->job_id, job_ptr);
 }
 
 static void _add_job_hash_sluid(job_record_t *job_ptr)
 {
-	int inx;
-
 	if (!job_ptr->step_id.sluid) {
 		debug("%s: JobId=%pJ has no SLUID?", __func__, job_ptr);
 		return;
 	}
 
-	inx = JOB_HASH_INX(job_ptr->step_id.sluid);
-	job_ptr->job_next_sluid = job_hash_sluid[inx];
-	job_hash_sluid[inx] = job_ptr;
+	_job_hash_set(JOB_HASH_SLUID, job_ptr->step_id.sluid, job_ptr);
+}
+
+/* Unlink a job from the list of records of its job array */
+static bool _remove_job_array_job(job_record_t *job_entry)
+{
+	job_record_t *head, **job_pptr;
+
+	if (!(head = _job_hash_find(JOB_HASH_ARRAY_JOB,
+				    job_entry->array_job_id)))
+		return false;
+
+	if (head == job_entry) {
+		if (job_entry->job_array_next_j)
+			_job_hash_set(JOB_HASH_ARRAY_JOB,
+				      job_entry->array_job_id,
+				      job_entry->job_array_next_j);
+		else
+			_job_hash_del(JOB_HASH_ARRAY_JOB,
+				      job_entry->array_job_id, job_entry);
+		job_entry->job_array_next_j = NULL;
+		return true;
+	}
+
+	job_pptr = &head->job_array_next_j;
+	while (*job_pptr && (*job_pptr != job_entry)) {
+		xassert((*job_pptr)->magic == JOB_MAGIC);
+		job_pptr = &(*job_pptr)->job_array_next_j;
+	}
+
+	if (!*job_pptr)
+		return false;
+
+	*job_pptr = job_entry->job_array_next_j;
+	job_entry->job_array_next_j = NULL;
+	return true;
 }
 
 /* _remove_job_hash - remove a job hash entry for given job record, job_id must
@@ -1761,7 +2793,7 @@ static void _add_job_hash_sluid(job_record_t *job_ptr)
  */
 static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 {
-	job_record_t *job_ptr, **job_pptr;
+	bool found = false;
 
 	xassert(job_entry);
 
@@ -1774,90 +2806,47 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 
 	switch (type) {
 	case JOB_HASH_JOB:
-		job_pptr = &job_hash[JOB_HASH_INX(job_entry->job_id)];
+		found = _job_hash_del(type, job_entry->job_id, job_entry);
 		break;
 	case JOB_HASH_SLUID:
-		job_pptr =
-			&job_hash_sluid[JOB_HASH_INX(job_entry->step_id.sluid)];
+		found = _job_hash_del(type, job_entry->step_id.sluid,
+				      job_entry);
 		break;
 	case JOB_HASH_ARRAY_JOB:
-		job_pptr = &job_array_hash_j[
-			JOB_HASH_INX(job_entry->array_job_id)];
+		found = _remove_job_array_job(job_entry);
 		break;
 	case JOB_HASH_ARRAY_TASK:
-		job_pptr = &job_array_hash_t[
-			JOB_ARRAY_HASH_INX(job_entry->array_job_id,
-					   job_entry->array_task_id)];
+		found = _job_hash_del(type,
+				      _job_array_task_key(
+					      job_entry->array_job_id,
+					      job_entry->array_task_id),
+				      job_entry);
 		break;
 	default:
 		fatal("%s: unknown job_hash_type_t %d", __func__, type);
 		return;
 	}
 
-	while ((job_pptr != NULL) && (*job_pptr != NULL) &&
-	       ((job_ptr = *job_pptr) != job_entry)) {
-		xassert(job_ptr->magic == JOB_MAGIC);
-		switch (type) {
-		case JOB_HASH_JOB:
-			job_pptr = &job_ptr->job_next;
-			break;
-		case JOB_HASH_SLUID:
-			job_pptr = &job_ptr->job_next_sluid;
-			break;
-		case JOB_HASH_ARRAY_JOB:
-			job_pptr = &job_ptr->job_array_next_j;
-			break;
-		case JOB_HASH_ARRAY_TASK:
-			job_pptr = &job_ptr->job_array_next_t;
-			break;
-		}
-	}
-
-	if (job_pptr == NULL || *job_pptr == NULL) {
-		if (job_entry->job_id == NO_VAL)
-			return;
-
-		switch (type) {
-		case JOB_HASH_JOB:
-			error("%s: Could not find hash entry for JobId=%u",
-			      __func__, job_entry->job_id);
-			break;
-		case JOB_HASH_SLUID:
-		{
-			error("%s: Could not find hash entry for SLUID=%"PRIu64,
-			      __func__, job_entry->step_id.sluid);
-			break;
-		case JOB_HASH_ARRAY_JOB:
-			error("%s: job array hash error %u", __func__,
-			      job_entry->array_job_id);
-			break;
-		case JOB_HASH_ARRAY_TASK:
-			error("%s: job array, task ID hash error %u_%u",
-			      __func__,
-			      job_entry->array_job_id,
-			      job_entry->array_task_id);
-			break;
-		}
-		}
+	if (found || (job_entry->job_id == NO_VAL))
 		return;
-	}
 
 	switch (type) {
 	case JOB_HASH_JOB:
-		*job_pptr = job_entry->job_next;
-		job_entry->job_next = NULL;
+		error("%s: Could not find hash entry for JobId=%u",
+		      __func__, job_entry->job_id);
 		break;
 	case JOB_HASH_SLUID:
-		*job_pptr = job_entry->job_next_sluid;
-		job_entry->job_next_sluid = NULL;
+		error("%s: Could not find hash entry for SLUID=%"PRIu64,
+		      __func__, job_entry->step_id.sluid);
 		break;
 	case JOB_HASH_ARRAY_JOB:
-		*job_pptr = job_entry->job_array_next_j;
-		job_entry->job_array_next_j = NULL;
+		error("%s: job array hash error %u", __func__,
+		      job_entry->array_job_id);
 		break;
 	case JOB_HASH_ARRAY_TASK:
-		*job_pptr = job_entry->job_array_next_t;
-		job_entry->job_array_next_t = NULL;
+		error("%s: job array, task ID hash error %u_%u",
+		      __func__, job_entry->array_job_id,
+		      job_entry->array_task_id);
 		break;
 	}
 }
@@ -1869,20 +2858,19 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
  */
 void _add_job_array_hash(job_record_t *job_ptr)
 {
-	int inx;
-
 	if (job_ptr->array_task_id == NO_VAL)
 		return;	/* Not a job array */
 
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
-	inx = JOB_HASH_INX(job_ptr->array_job_id);
-	job_ptr->job_array_next_j = job_array_hash_j[inx];
-	job_array_hash_j[inx] = job_ptr;
+	job_ptr->job_array_next_j = _job_hash_find(JOB_HASH_ARRAY_JOB,
+						   job_ptr->array_job_id);
+	_job_hash_set(JOB_HASH_ARRAY_JOB, job_ptr->array_job_id, job_ptr);
 
-	inx = JOB_ARRAY_HASH_INX(job_ptr->array_job_id,job_ptr->array_task_id);
-	job_ptr->job_array_next_t = job_array_hash_t[inx];
-	job_array_hash_t[inx] = job_ptr;
+	_job_hash_set(JOB_HASH_ARRAY_TASK,
+		      _job_array_task_key(job_ptr->array_job_id,
+					  job_ptr->array_task_id),
+		      job_ptr);
 }
 
 /* For the job array data structure, build the string representation of the
@@ -1908,8 +2896,6 @@ extern void build_array_str(job_record_t *job_ptr)
 extern bool test_job_array_complete(uint32_t array_job_id)
 {
 	job_record_t *job_ptr;
-	int inx;
-
 	job_ptr = find_job_record(array_job_id);
 	if (job_ptr) {
 		if (!IS_JOB_COMPLETE(job_ptr))
@@ -1919,8 +2905,7 @@ extern bool test_job_array_complete(uint32_t array_job_id)
 	}
 
 	/* Need to test individual job array records */
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if (job_ptr->array_job_id == array_job_id) {
 			if (!IS_JOB_COMPLETE(job_ptr))
@@ -1935,8 +2920,6 @@ extern bool test_job_array_complete(uint32_t array_job_id)
 extern bool test_job_array_completed(uint32_t array_job_id)
 {
 	job_record_t *job_ptr;
-	int inx;
-
 	job_ptr = find_job_record(array_job_id);
 	if (job_ptr) {
 		if (!IS_JOB_COMPLETED(job_ptr))
@@ -1944,8 +2927,7 @@ extern bool test_job_array_completed(uint32_t array_job_id)
 	}
 
 	/* Need to test individual job array records */
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if (job_ptr->array_job_id == array_job_id) {
 			if (!IS_JOB_COMPLETED(job_ptr))
@@ -1963,7 +2945,6 @@ extern bool test_job_array_completed(uint32_t array_job_id)
 static bool _test_job_array_purged(uint32_t array_job_id)
 {
 	job_record_t *job_ptr, *head_job_ptr;
-	int inx;
 
 	head_job_ptr = find_job_record(array_job_id);
 	if (head_job_ptr) {
@@ -1972,8 +2953,7 @@ static bool _test_job_array_purged(uint32_t array_job_id)
 	}
 
 	/* Need to test individual job array records */
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if ((job_ptr->array_job_id == array_job_id) &&
 		    (job_ptr != head_job_ptr)) {
@@ -1988,8 +2968,6 @@ static bool _test_job_array_purged(uint32_t array_job_id)
 extern bool test_job_array_finished(uint32_t array_job_id)
 {
 	job_record_t *job_ptr;
-	int inx;
-
 	job_ptr = find_job_record(array_job_id);
 	if (job_ptr) {
 		if (!IS_JOB_FINISHED(job_ptr))
@@ -1997,8 +2975,7 @@ extern bool test_job_array_finished(uint32_t array_job_id)
 	}
 
 	/* Need to test individual job array records */
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if (job_ptr->array_job_id == array_job_id) {
 			if (!IS_JOB_FINISHED(job_ptr))
@@ -2014,8 +2991,6 @@ extern bool test_job_array_finished(uint32_t array_job_id)
 extern bool test_job_array_pending(uint32_t array_job_id)
 {
 	job_record_t *job_ptr;
-	int inx;
-
 	job_ptr = find_job_record(array_job_id);
 	if (job_ptr) {
 		if (IS_JOB_PENDING(job_ptr) || IS_JOB_CONFIGURING(job_ptr))
@@ -2025,8 +3000,7 @@ extern bool test_job_array_pending(uint32_t array_job_id)
 	}
 
 	/* Need to test individual job array records */
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if (job_ptr->array_job_id == array_job_id) {
 			if (IS_JOB_PENDING(job_ptr) ||
@@ -2043,10 +3017,9 @@ extern bool test_job_array_pending(uint32_t array_job_id)
 extern int num_pending_job_array_tasks(uint32_t array_job_id)
 {
 	job_record_t *job_ptr;
-	int count = 0, inx;
+	int count = 0;
 
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
+	job_ptr = _find_first_job_array_rec(array_job_id);
 	while (job_ptr) {
 		if ((job_ptr->array_job_id == array_job_id) &&
 		    IS_JOB_PENDING(job_ptr))
@@ -2123,20 +3096,10 @@ static int _foreach_by_het_job(void *x, void *arg)
 	return _foreach_job_by_id_single(job_ptr, args);
 }
 
+/* Return the first record of the list of job array records, NULL if none */
 static job_record_t *_find_first_job_array_rec(uint32_t array_job_id)
 {
-	job_record_t *job_ptr;
-	int inx;
-
-	inx = JOB_HASH_INX(array_job_id);
-	job_ptr = job_array_hash_j[inx];
-	while (job_ptr) {
-		if (job_ptr->array_job_id == array_job_id)
-			return job_ptr;
-		job_ptr = job_ptr->job_array_next_j;
-	}
-
-	return NULL;
+	return _job_hash_find(JOB_HASH_ARRAY_JOB, array_job_id);
 }
 
 static void _foreach_job_by_id_array(for_each_by_job_id_args_t *args)
@@ -2442,6 +3405,8 @@ extern job_record_t *find_job_array_rec(uint32_t array_job_id,
 	job_record_t *job_ptr, *match_job_ptr = NULL;
 	int inx;
 
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+
 	if (array_task_id == NO_VAL)
 		return find_job_record(array_job_id);
 
@@ -2452,8 +3417,7 @@ extern job_record_t *find_job_array_rec(uint32_t array_job_id,
 		    (job_ptr->array_job_id == array_job_id))
 			return job_ptr;
 
-		inx = JOB_HASH_INX(array_job_id);
-		job_ptr = job_array_hash_j[inx];
+		job_ptr = _find_first_job_array_rec(array_job_id);
 		while (job_ptr) {
 			if (job_ptr->array_job_id == array_job_id) {
 				match_job_ptr = job_ptr;
@@ -2465,15 +3429,11 @@ extern job_record_t *find_job_array_rec(uint32_t array_job_id,
 		}
 		return match_job_ptr;
 	} else {		/* Find specific task ID */
-		inx = JOB_ARRAY_HASH_INX(array_job_id, array_task_id);
-		job_ptr = job_array_hash_t[inx];
-		while (job_ptr) {
-			if ((job_ptr->array_job_id == array_job_id) &&
-			    (job_ptr->array_task_id == array_task_id)) {
-				return job_ptr;
-			}
-			job_ptr = job_ptr->job_array_next_t;
-		}
+		if ((job_ptr = _job_hash_find(JOB_HASH_ARRAY_TASK,
+					      _job_array_task_key(
+						      array_job_id,
+						      array_task_id))))
+			return job_ptr;
 		/* Look for job record with all of the pending tasks */
 		job_ptr = find_job_record(array_job_id);
 		if (job_ptr && job_ptr->array_recs &&
@@ -2543,32 +3503,16 @@ extern job_record_t *find_het_job_record(uint32_t job_id,
  */
 extern job_record_t *find_job_record(uint32_t job_id)
 {
-	job_record_t *job_ptr;
 	xassert(verify_lock(JOB_LOCK, READ_LOCK));
 
-	job_ptr = job_hash[JOB_HASH_INX(job_id)];
-	while (job_ptr) {
-		if (job_ptr->job_id == job_id)
-			return job_ptr;
-		job_ptr = job_ptr->job_next;
-	}
-
-	return NULL;
+	return _job_hash_find(JOB_HASH_JOB, job_id);
 }
 
 extern job_record_t *find_sluid(sluid_t sluid)
 {
-	job_record_t *job_ptr;
 	xassert(verify_lock(JOB_LOCK, READ_LOCK));
 
-	job_ptr = job_hash_sluid[JOB_HASH_INX(sluid)];
-	while (job_ptr) {
-		if (job_ptr->step_id.sluid == sluid)
-			return job_ptr;
-		job_ptr = job_ptr->job_next_sluid;
-	}
-
-	return NULL;
+	return _job_hash_find(JOB_HASH_SLUID, sluid);
 }
 
 extern job_record_t *find_job(const slurm_step_id_t *step_id)
@@ -3406,6 +4350,47 @@ void dump_job_desc(job_desc_msg_t *job_desc)
 		       job_desc->container_id);
 }
 
+static void _init_job_state_conf(void)
+{
+	char *tmp_ptr;
+	bool enabled = xstrcasestr(slurm_conf.slurmctld_params,
+				   "job_state_journal");
+
+	job_journal_compact_pct = JOB_JOURNAL_COMPACT_PCT_DEFAULT;
+	if ((tmp_ptr = conf_get_opt_str(slurm_conf.slurmctld_params,
+					"job_state_journal_compact="))) {
+		int pct = atoi(tmp_ptr);
+
+		if (pct < 1)
+			error("Invalid SlurmctldParameters job_state_journal_compact=%s, using %d",
+			      tmp_ptr, JOB_JOURNAL_COMPACT_PCT_DEFAULT);
+		else
+			job_journal_compact_pct = pct;
+		xfree(tmp_ptr);
+	}
+
+	job_state_save_yield = 0;
+	if ((tmp_ptr = conf_get_opt_str(slurm_conf.slurmctld_params,
+					"job_state_save_yield="))) {
+		int msec = atoi(tmp_ptr);
+
+		if (msec < 0)
+			error("Invalid SlurmctldParameters job_state_save_yield=%s, ignored",
+			      tmp_ptr);
+		else
+			job_state_save_yield = msec;
+		xfree(tmp_ptr);
+	}
+
+	if (enabled && !job_journal_purged)
+		job_journal_purged = list_create(xfree_ptr);
+
+	/* Always start a new journal from a full snapshot */
+	if (enabled != job_journal_enabled)
+		job_journal_compact = true;
+	job_journal_enabled = enabled;
+}
+
 /*
  * init_job_conf - initialize the job configuration tables and values.
  *	this should be called after creating node information, but
@@ -3431,33 +4416,44 @@ void init_job_conf(void)
 
 	if (!purge_jobs_list)
 		purge_jobs_list = list_create(job_record_delete);
+
+	_init_job_state_conf();
+
+	if (job_pack_cache_enabled &&
+	    !xstrcasestr(slurm_conf.slurmctld_params, "job_info_cache")) {
+		/* Drop records cached before the option was removed */
+		list_for_each(job_list, _clear_job_pack_cache, NULL);
+		FREE_NULL_BUFFER(job_pack_cache_buf);
+		FREE_NULL_LIST(job_tombstones);
+	} else if (!job_pack_cache_enabled &&
+		   xstrcasestr(slurm_conf.slurmctld_params, "job_info_cache")) {
+		/* Jobs purged before now have no tombstones */
+		job_tombstones = list_create(xfree_ptr);
+		job_tombstone_horizon = time(NULL);
+	}
+	job_pack_cache_enabled = xstrcasestr(slurm_conf.slurmctld_params,
+					     "job_info_cache");
 }
 
 /*
- * rehash_jobs - Create or rebuild the job hash table.
+ * rehash_jobs - Create the job hash table.
+ * The table is sized from MaxJobCount and doubles itself incrementally as
+ * needed, so there is nothing to do when MaxJobCount changes.
  */
 extern void rehash_jobs(void)
 {
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
-	if (job_hash == NULL) {
-		hash_table_size = slurm_conf.max_job_cnt;
-		job_hash = xcalloc(hash_table_size, sizeof(job_record_t *));
-		job_hash_sluid =
-			xcalloc(hash_table_size, sizeof(job_record_t *));
-		job_array_hash_j = xcalloc(hash_table_size,
-					   sizeof(job_record_t *));
-		job_array_hash_t = xcalloc(hash_table_size,
-					   sizeof(job_record_t *));
-	} else if (hash_table_size < (slurm_conf.max_job_cnt / 2)) {
-		/* If the MaxJobCount grows by too much, the hash table will
-		 * be ineffective without rebuilding. We don't presently bother
-		 * to rebuild the hash table, but cut MaxJobCount back as
-		 * needed. */
-		error ("MaxJobCount reset too high, restart slurmctld");
-		slurm_conf.max_job_cnt = hash_table_size;
-	}
+	if (job_hash.slots)
+		return;
+
+	job_hash.size = JOB_HASH_MIN_SIZE;
+	while ((job_hash.size < slurm_conf.max_job_cnt) &&
+	       (job_hash.size < (1U << 30)))
+		job_hash.size *= 2;
+	job_hash.count = 0;
+	job_hash.slots = xcalloc(job_hash.size, sizeof(*job_hash.slots));
 }
 
 /* Create an exact copy of an existing job record for a job array.
@@ -3581,8 +4577,8 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	memcpy(job_ptr_pend->limit_set.tres, job_ptr->limit_set.tres,
 	       sizeof(uint16_t) * slurmctld_tres_cnt);
 
-	_add_job_hash(job_ptr);		/* Sets job_next */
-	_add_job_hash(job_ptr_pend);	/* Sets job_next */
+	_add_job_hash(job_ptr);
+	_add_job_hash(job_ptr_pend);
 	_add_job_hash_sluid(job_ptr);
 	_add_job_hash_sluid(job_ptr_pend);
 	_add_job_array_hash(job_ptr);
@@ -5492,12 +6488,7 @@ static job_record_t *_find_meta_job_record(uint32_t job_id)
 
 	job_ptr = find_job_record(job_id);
 	if (job_ptr == NULL) {
-		job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
-		while (job_ptr) {
-			if (job_ptr->array_job_id == job_id)
-				break;
-			job_ptr = job_ptr->job_array_next_j;
-		}
+		job_ptr = _find_first_job_array_rec(job_id);
 	}
 	if ((job_ptr == NULL) ||
 	    ((job_ptr->array_task_id == NO_VAL) &&
@@ -5774,7 +6765,7 @@ extern int job_str_signal(char *job_id_str, uint16_t signal, uint16_t flags,
 		}
 
 		/* Signal all tasks of this job array */
-		job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+		job_ptr = _find_first_job_array_rec(job_id);
 		if (!job_ptr && !job_ptr_done) {
 			info("%s(3): invalid JobId=%u", __func__, job_id);
 			return ESLURM_INVALID_JOB_ID;
@@ -10054,6 +11045,11 @@ static void _move_to_purge_jobs_list(void *job_entry)
 
 	xassert(job_ptr->magic == JOB_MAGIC);
 
+	if (job_journal_enabled)
+		_job_journal_purge(job_ptr);
+	if (job_pack_cache_enabled)
+		_job_pack_cache_purge(job_ptr);
+
 	_delete_job_common(job_ptr);
 
 	if (job_ptr->array_recs) {
@@ -10215,15 +11211,236 @@ static bool _hide_job_user_rec(job_record_t *job_ptr, slurmdb_user_rec_t *user,
 	if (!job_ptr)
 		return true;
 
-	if ((slurm_conf.private_data & PRIVATE_DATA_JOBS) &&
-	    (job_ptr->user_id != user->uid) &&
-	    (((slurm_mcs_get_privatedata() == 0) &&
-	      !assoc_mgr_is_user_acct_coord_user_rec(user, job_ptr->account)) ||
-	     ((slurm_mcs_get_privatedata() == 1) &&
-	      (mcs_g_check_mcs_label(user->uid, job_ptr->mcs_label,
-				     true) != 0))))
-		return true;
-	return false;
+	if ((slurm_conf.private_data & PRIVATE_DATA_JOBS) &&
+	    (job_ptr->user_id != user->uid) &&
+	    (((slurm_mcs_get_privatedata() == 0) &&
+	      !assoc_mgr_is_user_acct_coord_user_rec(user, job_ptr->account)) ||
+	     ((slurm_mcs_get_privatedata() == 1) &&
+	      (mcs_g_check_mcs_label(user->uid, job_ptr->mcs_label,
+				     true) != 0))))
+		return true;
+	return false;
+}
+
+static void _job_pack_cache_free(void *x)
+{
+	job_pack_cache_t *cache = x;
+
+	xfree(cache->data);
+	xfree(cache);
+}
+
+static int _find_job_pack_cache(void *x, void *key)
+{
+	job_pack_cache_t *cache = x, *cache_key = key;
+
+	return ((cache->protocol_version == cache_key->protocol_version) &&
+		(cache->show_flags == cache_key->show_flags) &&
+		(cache->compact == cache_key->compact));
+}
+
+static int _clear_job_pack_cache(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+
+	FREE_NULL_LIST(job_ptr->pack_cache);
+	return 0;
+}
+
+/*
+ * Invalidate all cached pack_job() records if any job, partition, node or
+ * the configuration changed since they were packed.
+ * Call with job_pack_cache_mutex locked.
+ */
+static void _job_pack_cache_sync(void)
+{
+	static time_t job_update = 0, part_update = 0, node_update = 0;
+	static time_t conf_update = 0;
+
+	if ((job_update == last_job_update) &&
+	    (part_update == last_part_update) &&
+	    (node_update == last_node_update) &&
+	    (conf_update == slurm_conf.last_update))
+		return;
+
+	job_update = last_job_update;
+	part_update = last_part_update;
+	node_update = last_node_update;
+	conf_update = slurm_conf.last_update;
+	job_pack_cache_gen++;
+}
+
+/*
+ * pack_job() reports the expected start time of pending jobs relative to now,
+ * return when a record packed at "now" goes stale or 0 if it does not.
+ */
+static time_t _job_pack_cache_expires(job_record_t *job_ptr, time_t now)
+{
+	if (IS_JOB_STARTED(job_ptr))
+		return 0;
+
+	if (job_ptr->start_time) {
+		if (job_ptr->start_time > now)
+			return job_ptr->start_time;
+		return now + 1;
+	}
+
+	if (job_ptr->details && (job_ptr->details->begin_time > now))
+		return job_ptr->details->begin_time;
+
+	return 0;
+}
+
+/*
+ * Append pack_job() output for job_ptr to pack_info->buffer. With
+ * SlurmctldParameters=job_info_cache the output is kept with the job record,
+ * keyed by protocol version, show_flags and encoding, and shared by all
+ * requests until _job_pack_cache_sync() invalidates it. Compact records are
+ * cached without string interning so they can be copied into any response.
+ * RET false if the job was skipped as unchanged since pack_info->delta_time
+ */
+static bool _pack_job_cached(job_record_t *job_ptr,
+			     _foreach_pack_job_info_t *pack_info)
+{
+	job_pack_cache_t key = {
+		.protocol_version = pack_info->protocol_version,
+		.show_flags = (pack_info->show_flags & JOB_PACK_CACHE_FLAGS),
+		.compact = pack_info->compact,
+	};
+	job_pack_cache_t *cache;
+	uint32_t size;
+	bool packed = true;
+
+	if (!job_pack_cache_enabled) {
+		pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
+			 pack_info->protocol_version, pack_info->uid,
+			 pack_info->has_qos_lock);
+		return true;
+	}
+
+	slurm_mutex_lock(&job_pack_cache_mutex);
+	if (!job_ptr->pack_cache)
+		job_ptr->pack_cache = list_create(_job_pack_cache_free);
+
+	if (!(cache = list_find_first(job_ptr->pack_cache,
+				      _find_job_pack_cache, &key))) {
+		if (list_count(job_ptr->pack_cache) >= JOB_PACK_CACHE_MAX) {
+			cache = list_pop(job_ptr->pack_cache);
+			xfree(cache->data);
+		} else {
+			cache = xmalloc(sizeof(*cache));
+		}
+		cache->protocol_version = key.protocol_version;
+		cache->show_flags = key.show_flags;
+		cache->compact = key.compact;
+		list_append(job_ptr->pack_cache, cache);
+	}
+
+	if (!cache->data || (cache->gen != job_pack_cache_gen) ||
+	    (cache->expires && (cache->expires <= pack_info->now))) {
+		if (!job_pack_cache_buf)
+			job_pack_cache_buf = init_buf(BUF_SIZE);
+		set_buf_offset(job_pack_cache_buf, 0);
+		if (key.compact)
+			buf_set_compact(job_pack_cache_buf, false);
+		pack_job(job_ptr, pack_info->show_flags, job_pack_cache_buf,
+			 pack_info->protocol_version, pack_info->uid,
+			 pack_info->has_qos_lock);
+		buf_clear_compact(job_pack_cache_buf);
+
+		size = get_buf_offset(job_pack_cache_buf);
+		if (!cache->data || (cache->size != size) ||
+		    memcmp(cache->data, get_buf_data(job_pack_cache_buf),
+			   size)) {
+			xfree(cache->data);
+			cache->data = xmalloc_nz(size);
+			memcpy(cache->data, get_buf_data(job_pack_cache_buf),
+			       size);
+			cache->size = size;
+			cache->changed = pack_info->now;
+		}
+		cache->gen = job_pack_cache_gen;
+		cache->expires = _job_pack_cache_expires(job_ptr,
+							 pack_info->now);
+	}
+
+	if (cache->changed >= pack_info->delta_time)
+		packmem_array(cache->data, cache->size, pack_info->buffer);
+	else
+		packed = false;
+	slurm_mutex_unlock(&job_pack_cache_mutex);
+
+	return packed;
+}
+
+/* Drop tombstones older than JOB_TOMBSTONE_AGE */
+static void _job_tombstone_trim(time_t now)
+{
+	job_tombstone_t *tombstone;
+
+	while ((tombstone = list_peek(job_tombstones)) &&
+	       (tombstone->purged < (now - JOB_TOMBSTONE_AGE))) {
+		job_tombstone_horizon = tombstone->purged;
+		xfree(tombstone);
+		(void) list_pop(job_tombstones);
+	}
+}
+
+/* Remember a purged job that job info requests may have reported */
+static void _job_pack_cache_purge(job_record_t *job_ptr)
+{
+	job_tombstone_t *tombstone;
+	time_t now = time(NULL);
+
+	if (!job_ptr->pack_cache || (job_ptr->job_id == NO_VAL))
+		return;
+
+	tombstone = xmalloc(sizeof(*tombstone));
+	tombstone->job_id = job_ptr->job_id;
+	tombstone->purged = now;
+
+	slurm_mutex_lock(&job_pack_cache_mutex);
+	_job_tombstone_trim(now);
+	list_append(job_tombstones, tombstone);
+	slurm_mutex_unlock(&job_pack_cache_mutex);
+}
+
+/*
+ * Prepare pack_info for a SHOW_DELTA request. Deltas can only be computed
+ * while tombstones for all jobs purged since last_update are still kept.
+ * RET array of job ids purged since last_update, NULL if a full response is
+ *	required
+ */
+static uint32_t *_job_pack_cache_delta(_foreach_pack_job_info_t *pack_info,
+				       time_t last_update,
+				       uint32_t *purged_cnt)
+{
+	job_tombstone_t *tombstone;
+	list_itr_t *itr;
+	uint32_t *purged = NULL;
+
+	*purged_cnt = 0;
+	if (!job_pack_cache_enabled || !last_update)
+		return NULL;
+
+	slurm_mutex_lock(&job_pack_cache_mutex);
+	_job_tombstone_trim(pack_info->now);
+	if (last_update <= job_tombstone_horizon) {
+		slurm_mutex_unlock(&job_pack_cache_mutex);
+		return NULL;
+	}
+
+	purged = xcalloc((list_count(job_tombstones) + 1), sizeof(*purged));
+	itr = list_iterator_create(job_tombstones);
+	while ((tombstone = list_next(itr))) {
+		if (tombstone->purged >= last_update)
+			purged[(*purged_cnt)++] = tombstone->job_id;
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&job_pack_cache_mutex);
+
+	pack_info->delta_time = last_update;
+	return purged;
 }
 
 static int _pack_job(void *object, void *arg)
@@ -10250,9 +11467,11 @@ static int _pack_job(void *object, void *arg)
 			return SLURM_SUCCESS;
 	}
 
-	pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
-		 pack_info->protocol_version, pack_info->uid,
-		 pack_info->has_qos_lock);
+	if (pack_info->fields)
+		_pack_job_fields(job_ptr, pack_info->fields, pack_info->buffer,
+				 pack_info->protocol_version);
+	else if (!_pack_job_cached(job_ptr, pack_info))
+		return SLURM_SUCCESS;
 
 	pack_info->jobs_packed++;
 
@@ -10295,11 +11514,14 @@ static int _foreach_pack_jobid(void *object, void *arg)
 
 /*
  * _pack_init_job_info - create buffer with header packed for a job_info_msg_t
+ * IN fields - JOB_FIELD_* packed for each job, 0 for all
+ * IN compact - pack job records with buf_set_compact()
  *
  * NOTE: change _unpack_job_info_msg() in common/slurm_protocol_pack.c
  *	whenever the data format changes
  */
-static buf_t *_pack_init_job_info(uint16_t protocol_version)
+static buf_t *_pack_init_job_info(uint64_t fields, bool compact,
+				  uint16_t protocol_version)
 {
 	buf_t *buffer = init_buf(BUF_SIZE);
 
@@ -10310,26 +11532,109 @@ static buf_t *_pack_init_job_info(uint16_t protocol_version)
 		pack_time(time(NULL), buffer);
 		pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
 	}
+	if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION)
+		pack64(fields, buffer);
+	if (compact)
+		buf_set_compact(buffer, true);
 
 	return buffer;
 }
 
+/*
+ * _pack_fini_job_info - fill in the record count of a job_info_msg_t started
+ *	with _pack_init_job_info() and pack its trailer
+ * IN delta - records were only packed for jobs changed since last_update
+ * IN purged - ids of jobs purged since last_update, if delta
+ *
+ * NOTE: change _unpack_job_info_msg() in common/slurm_protocol_pack.c
+ *	whenever the data format changes
+ */
+static void _pack_fini_job_info(buf_t *buffer, uint32_t jobs_packed,
+				bool delta, uint32_t *purged,
+				uint32_t purged_cnt, uint16_t protocol_version)
+{
+	uint32_t tmp_offset;
+
+	buf_clear_compact(buffer);
+
+	/* put the real record count in the message body header */
+	tmp_offset = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	pack32(jobs_packed, buffer);
+	set_buf_offset(buffer, tmp_offset);
+
+	if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		packbool(delta, buffer);
+		pack32_array(purged, purged_cnt, buffer);
+	}
+}
+
+static int _foreach_page_job(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	_foreach_page_job_t *page = arg;
+
+	if (job_ptr->job_id > page->after_job_id)
+		page->jobs[page->job_cnt++] = job_ptr;
+
+	return 0;
+}
+
+static int _sort_job_by_id(const void *x, const void *y)
+{
+	job_record_t *job1 = *(job_record_t **) x;
+	job_record_t *job2 = *(job_record_t **) y;
+
+	if (job1->job_id < job2->job_id)
+		return -1;
+	if (job1->job_id > job2->job_id)
+		return 1;
+	return 0;
+}
+
+/* Pack up to max_jobs jobs with a job id greater than after_job_id */
+static void _pack_job_page(_foreach_pack_job_info_t *pack_info,
+			   uint32_t after_job_id, uint32_t max_jobs)
+{
+	_foreach_page_job_t page = {
+		.after_job_id = after_job_id,
+	};
+
+	page.jobs = xcalloc((list_count(job_list) + 1), sizeof(*page.jobs));
+	list_for_each_ro(job_list, _foreach_page_job, &page);
+	qsort(page.jobs, page.job_cnt, sizeof(*page.jobs), _sort_job_by_id);
+
+	for (int i = 0; i < page.job_cnt; i++) {
+		if (max_jobs && (pack_info->jobs_packed >= max_jobs))
+			break;
+		(void) _pack_job(page.jobs[i], pack_info);
+	}
+
+	xfree(page.jobs);
+}
+
 /*
  * pack_all_jobs - dump all job information for all jobs in
  *	machine independent form (for network transmission)
  * IN show_flags - job filtering options
  * IN uid - uid of user making request (for partition filtering)
  * IN filter_uid - pack only jobs belonging to this user if not NO_VAL
+ * IN last_update - with SHOW_DELTA, pack only jobs changed since
+ * IN after_job_id - pack only jobs with a greater job id
+ * IN max_jobs - pack at most this many jobs sorted by job id, 0 for all
+ * IN fields - JOB_FIELD_* to pack for each job, 0 for all
+ * IN compact - pack job records in the compact encoding, the client set
+ *	SLURM_COMPACT_ENCODING
  * OUT buffer
  * global: job_list - global list of job records
  * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
  */
 extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
+			    time_t last_update, uint32_t after_job_id,
+			    uint32_t max_jobs, uint64_t fields, bool compact,
 			    uint16_t protocol_version)
 {
-	uint32_t tmp_offset;
 	_foreach_pack_job_info_t pack_info = {
-		.buffer = _pack_init_job_info(protocol_version),
 		.filter_uid = filter_uid,
 		.jobs_packed = 0,
 		.protocol_version = protocol_version,
@@ -10340,6 +11645,24 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 	};
 	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .user = READ_LOCK,
 				   .qos = READ_LOCK };
+	uint32_t *purged = NULL, purged_cnt = 0;
+	bool paged = (after_job_id || max_jobs);
+
+	/* Older clients can only unpack whole fixed width job records */
+	if (protocol_version < SLURM_26_05_PROTOCOL_VERSION) {
+		fields = 0;
+		compact = false;
+	}
+	pack_info.fields = fields;
+	pack_info.compact = compact;
+	pack_info.buffer = _pack_init_job_info(fields, compact,
+					       protocol_version);
+
+	/* Not before the time in the message header, see SHOW_DELTA */
+	pack_info.now = time(NULL);
+	if ((show_flags & SHOW_DELTA) && !paged && !fields)
+		purged = _job_pack_cache_delta(&pack_info, last_update,
+					       &purged_cnt);
 
 	assoc_mgr_lock(&locks);
 	assoc_mgr_fill_in_user(acct_db_conn, &pack_info.user_rec,
@@ -10347,16 +11670,23 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
 	pack_info.visible_parts = build_visible_parts(
 		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
-	list_for_each_ro(job_list, _pack_job, &pack_info);
+	if (job_pack_cache_enabled) {
+		slurm_mutex_lock(&job_pack_cache_mutex);
+		_job_pack_cache_sync();
+		slurm_mutex_unlock(&job_pack_cache_mutex);
+	}
+	if (paged)
+		_pack_job_page(&pack_info, after_job_id, max_jobs);
+	else
+		list_for_each_ro(job_list, _pack_job, &pack_info);
 	assoc_mgr_unlock(&locks);
 
-	/* put the real record count in the message body header */
-	tmp_offset = get_buf_offset(pack_info.buffer);
-	set_buf_offset(pack_info.buffer, 0);
-	pack32(pack_info.jobs_packed, pack_info.buffer);
-	set_buf_offset(pack_info.buffer, tmp_offset);
+	_pack_fini_job_info(pack_info.buffer, pack_info.jobs_packed,
+			    (purged != NULL), purged, purged_cnt,
+			    protocol_version);
 
 	xfree(pack_info.visible_parts);
+	xfree(purged);
 
 	return pack_info.buffer;
 }
@@ -10368,16 +11698,19 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
  * IN job_ids - list of job_ids to pack
  * IN uid - uid of user making request (for partition filtering)
  * IN filter_uid - pack only jobs belonging to this user if not NO_VAL
+ * IN compact - pack job records in the compact encoding, the client set
+ *	SLURM_COMPACT_ENCODING
  * OUT buffer
  * global: job_list - global list of job records
  * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
  */
 extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
-			     uint32_t filter_uid, uint16_t protocol_version)
+			     uint32_t filter_uid, bool compact,
+			     uint16_t protocol_version)
 {
-	uint32_t tmp_offset;
 	_foreach_pack_job_info_t pack_info = {
-		.buffer = _pack_init_job_info(protocol_version),
+		.compact = (compact && (protocol_version >=
+					SLURM_26_05_PROTOCOL_VERSION)),
 		.filter_uid = filter_uid,
 		.jobs_packed = 0,
 		.protocol_version = protocol_version,
@@ -10385,26 +11718,32 @@ extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
 		.uid = uid,
 		.has_qos_lock = true,
 		.user_rec.uid = uid,
+		.now = time(NULL),
 	};
 	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .user = READ_LOCK,
 				   .qos = READ_LOCK };
 
 	xassert(job_ids);
 
+	pack_info.buffer = _pack_init_job_info(0, pack_info.compact,
+					       protocol_version);
+
 	assoc_mgr_lock(&locks);
 	assoc_mgr_fill_in_user(acct_db_conn, &pack_info.user_rec,
 			       accounting_enforce, NULL, true);
 	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
 	pack_info.visible_parts = build_visible_parts(
 		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
+	if (job_pack_cache_enabled) {
+		slurm_mutex_lock(&job_pack_cache_mutex);
+		_job_pack_cache_sync();
+		slurm_mutex_unlock(&job_pack_cache_mutex);
+	}
 	list_for_each_ro(job_ids, _foreach_pack_jobid, &pack_info);
 	assoc_mgr_unlock(&locks);
 
-	/* put the real record count in the message body header */
-	tmp_offset = get_buf_offset(pack_info.buffer);
-	set_buf_offset(pack_info.buffer, 0);
-	pack32(pack_info.jobs_packed, pack_info.buffer);
-	set_buf_offset(pack_info.buffer, tmp_offset);
+	_pack_fini_job_info(pack_info.buffer, pack_info.jobs_packed, false,
+			    NULL, 0, protocol_version);
 
 	xfree(pack_info.visible_parts);
 
@@ -10423,14 +11762,14 @@ extern buf_t *pack_one_job(slurm_step_id_t *step_id, uint16_t show_flags,
 			   uid_t uid, uint16_t protocol_version)
 {
 	job_record_t *job_ptr;
-	uint32_t jobs_packed = 0, tmp_offset;
+	uint32_t jobs_packed = 0;
 	buf_t *buffer;
 	assoc_mgr_lock_t locks = { .qos = READ_LOCK, .user = READ_LOCK };
 	slurmdb_user_rec_t user_rec = { 0 };
 	bool hide_job = false;
 	bool valid_operator;
 
-	buffer = _pack_init_job_info(protocol_version);
+	buffer = _pack_init_job_info(0, false, protocol_version);
 
 	assoc_mgr_lock(&locks);
 	user_rec.uid = uid;
@@ -10489,8 +11828,8 @@ extern buf_t *pack_one_job(slurm_step_id_t *step_id, uint16_t show_flags,
 		if (step_id->sluid)
 			job_ptr = NULL;
 		else
-			job_ptr =
-				job_array_hash_j[JOB_HASH_INX(step_id->job_id)];
+			job_ptr = _find_first_job_array_rec(
+				step_id->job_id);
 
 		while (job_ptr) {
 			if ((job_ptr->job_id == step_id->job_id) &&
@@ -10523,11 +11862,8 @@ extern buf_t *pack_one_job(slurm_step_id_t *step_id, uint16_t show_flags,
 		return NULL;
 	}
 
-	/* put the real record count in the message body header */
-	tmp_offset = get_buf_offset(buffer);
-	set_buf_offset(buffer, 0);
-	pack32(jobs_packed, buffer);
-	set_buf_offset(buffer, tmp_offset);
+	_pack_fini_job_info(buffer, jobs_packed, false, NULL, 0,
+			    protocol_version);
 
 	return buffer;
 }
@@ -10545,6 +11881,256 @@ static void _pack_job_gres(job_record_t *dump_job_ptr, buf_t *buffer,
 		      dump_job_ptr->gres_detail_cnt, buffer);
 }
 
+static void _pack_job_array_str(job_record_t *job_ptr, buf_t *buffer)
+{
+	job_record_t *array_head = NULL;
+
+	if (job_ptr->array_recs) {
+		build_array_str(job_ptr);
+		packstr(job_ptr->array_recs->task_id_str, buffer);
+		pack32(job_ptr->array_recs->max_run_tasks, buffer);
+		return;
+	}
+
+	packnull(buffer);
+	if (job_ptr->array_job_id)
+		array_head = find_job_record(job_ptr->array_job_id);
+	if (array_head && array_head->array_recs)
+		pack32(array_head->array_recs->max_run_tasks, buffer);
+	else
+		pack32(0, buffer);
+}
+
+static uint32_t _job_time_limit(job_record_t *job_ptr)
+{
+	if ((job_ptr->time_limit == NO_VAL) && job_ptr->part_ptr)
+		return job_ptr->part_ptr->max_time;
+	return job_ptr->time_limit;
+}
+
+static void _job_start_end_time(job_record_t *job_ptr, uint32_t time_limit,
+				time_t *start_time, time_t *end_time)
+{
+	*start_time = 0;
+	*end_time = 0;
+
+	if (IS_JOB_STARTED(job_ptr)) {
+		/* Report actual start time, in past */
+		*start_time = job_ptr->start_time;
+		*end_time = job_ptr->end_time;
+	} else if (job_ptr->start_time != 0) {
+		/*
+		 * Report expected start time,
+		 * making sure that time is not in the past
+		 */
+		*start_time = MAX(job_ptr->start_time, time(NULL));
+		if (time_limit != NO_VAL) {
+			*end_time = MAX(job_ptr->end_time,
+					(*start_time + time_limit * 60));
+		}
+	} else if (job_ptr->details->begin_time > time(NULL)) {
+		/* earliest start time in the future */
+		*start_time = job_ptr->details->begin_time;
+		if (time_limit != NO_VAL) {
+			*end_time = MAX(job_ptr->end_time,
+					(*start_time + time_limit * 60));
+		}
+	}
+}
+
+static void _pack_job_nodes(job_record_t *job_ptr, buf_t *buffer)
+{
+	char *nodelist;
+
+	/*
+	 * Only send the allocated nodelist since we are only sending
+	 * the number of cpus and nodes that are currently allocated.
+	 */
+	if (!IS_JOB_COMPLETING(job_ptr)) {
+		packstr(job_ptr->nodes, buffer);
+	} else {
+		nodelist = bitmap2node_name(job_ptr->node_bitmap_cg);
+		packstr(nodelist, buffer);
+		xfree(nodelist);
+	}
+}
+
+static void _pack_job_partition(job_record_t *job_ptr, buf_t *buffer)
+{
+	if (!IS_JOB_PENDING(job_ptr) && job_ptr->part_ptr)
+		packstr(job_ptr->part_ptr->name, buffer);
+	else
+		packstr(job_ptr->partition, buffer);
+}
+
+/* Call with assoc_mgr QOS read lock */
+static void _pack_job_qos(job_record_t *job_ptr, buf_t *buffer)
+{
+	if (IS_JOB_PENDING(job_ptr) && job_ptr->details->qos_req)
+		packstr(job_ptr->details->qos_req, buffer);
+	else if (job_ptr->qos_ptr)
+		packstr(job_ptr->qos_ptr->name, buffer);
+	else if (assoc_mgr_qos_list)
+		packstr(slurmdb_qos_str(assoc_mgr_qos_list, job_ptr->qos_id),
+			buffer);
+	else
+		packnull(buffer);
+}
+
+/* Same CPU counts as _pack_default_job_details() */
+static void _pack_cpu_cnt(job_record_t *job_ptr, buf_t *buffer)
+{
+	job_details_t *detail_ptr = job_ptr->details;
+
+	if (!detail_ptr) {
+		if (job_ptr->total_cpus)
+			pack32(job_ptr->total_cpus, buffer);
+		else
+			pack32(job_ptr->cpu_cnt, buffer);
+		pack32((uint32_t) 0, buffer);
+	} else if (IS_JOB_COMPLETING(job_ptr) && job_ptr->cpu_cnt) {
+		pack32(job_ptr->cpu_cnt, buffer);
+		pack32((uint32_t) 0, buffer);
+	} else if (job_ptr->total_cpus && !IS_JOB_PENDING(job_ptr)) {
+		/* If job is PENDING ignore total_cpus,
+		 * which may have been set by previous run
+		 * followed by job requeue. */
+		pack32(job_ptr->total_cpus, buffer);
+		pack32((uint32_t) 0, buffer);
+	} else {
+		pack32(detail_ptr->min_cpus, buffer);
+		if (detail_ptr->max_cpus != NO_VAL)
+			pack32(detail_ptr->max_cpus, buffer);
+		else
+			pack32((uint32_t) 0, buffer);
+	}
+}
+
+/*
+ * _pack_job_fields - dump the JOB_FIELD_* members of a job's information in
+ *	machine independent form (for network transmission). Members are
+ *	packed in JOB_FIELD_* bit order with the same values as pack_job().
+ * IN job_ptr - pointer to job for which information is requested
+ * IN fields - JOB_FIELD_* to pack
+ * IN/OUT buffer - buffer in which data is placed, pointers automatically
+ *	updated
+ * NOTE: Call with assoc_mgr QOS read lock
+ * NOTE: change _unpack_job_info_fields() in common/slurm_protocol_pack.c
+ *	  whenever the data format changes
+ */
+static void _pack_job_fields(job_record_t *job_ptr, uint64_t fields,
+			     buf_t *buffer, uint16_t protocol_version)
+{
+	job_details_t *detail_ptr = job_ptr->details;
+	time_t start_time, end_time;
+	uint32_t time_limit;
+
+	xassert(verify_assoc_lock(QOS_LOCK, READ_LOCK));
+
+	if (protocol_version < SLURM_26_05_PROTOCOL_VERSION) {
+		error("%s: protocol_version %hu not supported",
+		      __func__, protocol_version);
+		return;
+	}
+
+	pack_step_id(&job_ptr->step_id, buffer, protocol_version);
+
+	if (fields & JOB_FIELD_ACCOUNT)
+		packstr(job_ptr->account, buffer);
+	if (fields & JOB_FIELD_ARRAY) {
+		pack32(job_ptr->array_job_id, buffer);
+		pack32(job_ptr->array_task_id, buffer);
+		_pack_job_array_str(job_ptr, buffer);
+	}
+	if (fields & JOB_FIELD_CLUSTER)
+		packstr(slurm_conf.cluster_name, buffer);
+	if (fields & JOB_FIELD_COMMENT) {
+		packstr(job_ptr->admin_comment, buffer);
+		packstr(job_ptr->comment, buffer);
+		packstr(job_ptr->system_comment, buffer);
+	}
+	if (fields & JOB_FIELD_CPUS)
+		_pack_cpu_cnt(job_ptr, buffer);
+	if (fields & JOB_FIELD_EXIT_CODE) {
+		pack32(job_ptr->derived_ec, buffer);
+		pack32(job_ptr->exit_code, buffer);
+	}
+	if (fields & JOB_FIELD_FLAGS)
+		pack64(job_ptr->bit_flags, buffer);
+	if (fields & JOB_FIELD_GROUP)
+		pack32(job_ptr->group_id, buffer);
+	if (fields & JOB_FIELD_HET) {
+		pack32(job_ptr->het_job_id, buffer);
+		packstr(job_ptr->het_job_id_set, buffer);
+		pack32(job_ptr->het_job_offset, buffer);
+	}
+	if (fields & JOB_FIELD_NAME)
+		packstr(job_ptr->name, buffer);
+	if (fields & JOB_FIELD_NODES) {
+		_pack_job_nodes(job_ptr, buffer);
+		packstr(job_ptr->sched_nodes, buffer);
+		if (detail_ptr) {
+			_pack_node_cnt(job_ptr, buffer);
+		} else {
+			pack32(job_ptr->node_cnt, buffer);
+			pack32((uint32_t) 0, buffer);
+		}
+	}
+	if (fields & JOB_FIELD_PARTITION)
+		_pack_job_partition(job_ptr, buffer);
+	if (fields & JOB_FIELD_PRIORITY)
+		pack32(job_ptr->priority, buffer);
+	if (fields & JOB_FIELD_QOS)
+		_pack_job_qos(job_ptr, buffer);
+	if (fields & JOB_FIELD_RESV)
+		packstr(job_ptr->resv_name, buffer);
+	if (fields & JOB_FIELD_STATE) {
+		pack32(job_ptr->job_state, buffer);
+		packstr(job_ptr->state_desc, buffer);
+		pack32(job_ptr->state_reason, buffer);
+	}
+	if (fields & JOB_FIELD_STDIO) {
+		if (detail_ptr) {
+			packstr(detail_ptr->std_err, buffer);
+			packstr(detail_ptr->std_in, buffer);
+			packstr(detail_ptr->std_out, buffer);
+		} else {
+			packnull(buffer);
+			packnull(buffer);
+			packnull(buffer);
+		}
+	}
+	if (fields & JOB_FIELD_TIME) {
+		time_limit = _job_time_limit(job_ptr);
+		_job_start_end_time(job_ptr, time_limit, &start_time,
+				    &end_time);
+		pack_time((detail_ptr ? detail_ptr->submit_time : 0), buffer);
+		pack_time((detail_ptr ? detail_ptr->begin_time : 0), buffer);
+		pack_time(start_time, buffer);
+		pack_time(end_time, buffer);
+		pack_time(job_ptr->suspend_time, buffer);
+		pack32(time_limit, buffer);
+	}
+	if (fields & JOB_FIELD_TRES) {
+		packstr(job_ptr->tres_fmt_alloc_str, buffer);
+		packstr(job_ptr->tres_fmt_req_str, buffer);
+	}
+	if (fields & JOB_FIELD_USER) {
+		pack32(job_ptr->user_id, buffer);
+		packstr(job_ptr->user_name, buffer);
+	}
+	if (fields & JOB_FIELD_WORK_DIR) {
+		if (detail_ptr && detail_ptr->argv)
+			packstr(detail_ptr->argv[0], buffer);
+		else
+			packnull(buffer);
+		if (detail_ptr)
+			packstr(detail_ptr->work_dir, buffer);
+		else
+			packnull(buffer);
+	}
+}
+
 /*
  * pack_job - dump all configuration information about a specific job in
  *	machine independent form (for network transmission)
@@ -10569,54 +12155,13 @@ void pack_job(job_record_t *dump_job_ptr, uint16_t show_flags, buf_t *buffer,
 		job_record_pack_common(dump_job_ptr, false, buffer,
 				       protocol_version);
 
-		if (dump_job_ptr->array_recs) {
-			build_array_str(dump_job_ptr);
-			packstr(dump_job_ptr->array_recs->task_id_str, buffer);
-			pack32(dump_job_ptr->array_recs->max_run_tasks, buffer);
-		} else {
-			job_record_t *array_head = NULL;
-			packnull(buffer);
-			if (dump_job_ptr->array_job_id) {
-				array_head = find_job_record(
-					dump_job_ptr->array_job_id);
-			}
-			if (array_head && array_head->array_recs) {
-				pack32(array_head->array_recs->max_run_tasks,
-				       buffer);
-			} else {
-				pack32(0, buffer);
-			}
-		}
-		if ((dump_job_ptr->time_limit == NO_VAL) &&
-		    dump_job_ptr->part_ptr)
-			time_limit = dump_job_ptr->part_ptr->max_time;
-		else
-			time_limit = dump_job_ptr->time_limit;
+		_pack_job_array_str(dump_job_ptr, buffer);
 
+		time_limit = _job_time_limit(dump_job_ptr);
 		pack32(time_limit, buffer);
 
-		if (IS_JOB_STARTED(dump_job_ptr)) {
-			/* Report actual start time, in past */
-			start_time = dump_job_ptr->start_time;
-			end_time = dump_job_ptr->end_time;
-		} else if (dump_job_ptr->start_time != 0) {
-			/*
-			 * Report expected start time,
-			 * making sure that time is not in the past
-			 */
-			start_time = MAX(dump_job_ptr->start_time, time(NULL));
-			if (time_limit != NO_VAL) {
-				end_time = MAX(dump_job_ptr->end_time,
-					       (start_time + time_limit * 60));
-			}
-		} else if (dump_job_ptr->details->begin_time > time(NULL)) {
-			/* earliest start time in the future */
-			start_time = dump_job_ptr->details->begin_time;
-			if (time_limit != NO_VAL) {
-				end_time = MAX(dump_job_ptr->end_time,
-					       (start_time + time_limit * 60));
-			}
-		}
+		_job_start_end_time(dump_job_ptr, time_limit, &start_time,
+				    &end_time);
 		pack_time(start_time, buffer);
 		pack_time(end_time, buffer);
 
@@ -10634,43 +12179,14 @@ void pack_job(job_record_t *dump_job_ptr, uint16_t show_flags, buf_t *buffer,
 
 		packstr(slurm_conf.cluster_name, buffer);
 
-		/*
-		 * Only send the allocated nodelist since we are only sending
-		 * the number of cpus and nodes that are currently allocated.
-		 */
-		if (!IS_JOB_COMPLETING(dump_job_ptr))
-			packstr(dump_job_ptr->nodes, buffer);
-		else {
-			nodelist = bitmap2node_name(
-				dump_job_ptr->node_bitmap_cg);
-			packstr(nodelist, buffer);
-			xfree(nodelist);
-		}
+		_pack_job_nodes(dump_job_ptr, buffer);
 		packstr(dump_job_ptr->sched_nodes, buffer);
 
-		if (!IS_JOB_PENDING(dump_job_ptr) && dump_job_ptr->part_ptr)
-			packstr(dump_job_ptr->part_ptr->name, buffer);
-		else
-			packstr(dump_job_ptr->partition, buffer);
+		_pack_job_partition(dump_job_ptr, buffer);
 
-		if (IS_JOB_PENDING(dump_job_ptr) &&
-		    dump_job_ptr->details->qos_req)
-			packstr(dump_job_ptr->details->qos_req, buffer);
-		else {
-			if (!has_qos_lock)
-				assoc_mgr_lock(&locks);
-			if (dump_job_ptr->qos_ptr)
-				packstr(dump_job_ptr->qos_ptr->name, buffer);
-			else {
-				if (assoc_mgr_qos_list) {
-					packstr(slurmdb_qos_str(
-							assoc_mgr_qos_list,
-							dump_job_ptr->qos_id),
-						buffer);
-				} else
-					packnull(buffer);
-			}
-		}
+		if (!has_qos_lock)
+			assoc_mgr_lock(&locks);
+		_pack_job_qos(dump_job_ptr, buffer);
 
 		if (IS_JOB_STARTED(dump_job_ptr) &&
 		    (slurm_conf.preempt_mode != PREEMPT_MODE_OFF) &&
@@ -11560,6 +13076,11 @@ extern void unlink_job_record(job_record_t *job_ptr)
 
 	xassert(job_ptr->magic == JOB_MAGIC);
 
+	if (job_journal_enabled)
+		_job_journal_purge(job_ptr);
+	if (job_pack_cache_enabled)
+		_job_pack_cache_purge(job_ptr);
+
 	_delete_job_common(job_ptr);
 
 	job_id = xmalloc(sizeof(uint32_t));
@@ -15426,7 +16947,7 @@ extern int update_job_str(slurm_msg_t *msg, uid_t uid)
 		}
 
 		/* Update all tasks of this job array */
-		job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+		job_ptr = _find_first_job_array_rec(job_id);
 		if (!job_ptr && !job_ptr_done) {
 			info("%s: invalid JobId=%u", __func__, job_id);
 			rc = ESLURM_INVALID_JOB_ID;
@@ -16279,7 +17800,7 @@ static void _sync_job_with_batch_dir(uint32_t job_id)
 
 		if (job_ptr->array_recs) { /* Update all tasks */
 			uint32_t array_job_id = job_ptr->array_job_id;
-			job_ptr = job_array_hash_j[JOB_HASH_INX(array_job_id)];
+			job_ptr = _find_first_job_array_rec(array_job_id);
 			while (job_ptr) {
 				if (job_ptr->array_job_id == array_job_id)
 					job_ptr->bit_flags |= HAS_STATE_DIR;
@@ -16802,10 +18323,13 @@ void batch_requeue_fini(job_record_t *job_ptr)
 void job_fini (void)
 {
 	FREE_NULL_LIST(job_list);
-	xfree(job_hash);
-	xfree(job_hash_sluid);
-	xfree(job_array_hash_j);
-	xfree(job_array_hash_t);
+	FREE_NULL_LIST(job_journal_purged);
+	FREE_NULL_BUFFER(job_pack_cache_buf);
+	FREE_NULL_LIST(job_tombstones);
+	xfree(job_hash.slots);
+	xfree(job_hash_old.slots);
+	memset(&job_hash, 0, sizeof(job_hash));
+	memset(&job_hash_old, 0, sizeof(job_hash_old));
 	FREE_NULL_LIST(purge_jobs_list);
 	FREE_NULL_LIST(purge_files_list);
 	FREE_NULL_BITMAP(requeue_exit);
@@ -17641,7 +19165,7 @@ extern int job_suspend2(slurm_msg_t *msg, suspend_msg_t *sus_ptr, uid_t uid,
 		}
 
 		/* Suspend all tasks of this job array */
-		job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+		job_ptr = _find_first_job_array_rec(job_id);
 		if (!job_ptr && !job_ptr_done) {
 			rc = ESLURM_INVALID_JOB_ID;
 			goto reply;
@@ -18127,7 +19651,7 @@ extern int job_requeue2(uid_t uid, requeue_msg_t *req_ptr, slurm_msg_t *msg,
 		}
 
 		/* Requeue all tasks of this job array */
-		job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+		job_ptr = _find_first_job_array_rec(job_id);
 		if (!job_ptr && !job_ptr_done) {
 			rc = ESLURM_INVALID_JOB_ID;
 			goto reply;
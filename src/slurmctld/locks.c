@@ -42,10 +42,27 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include "src/common/timers.h"
+
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
-static pthread_rwlock_t slurmctld_locks[6] = {
+/* Contention of one lock datatype, index 0 for read and 1 for write locks */
+typedef struct {
+	uint64_t count[2];
+	uint64_t wait_count[2]; /* acquisitions that had to wait */
+	uint64_t wait_usec[2];
+	uint64_t wait_max_usec[2];
+} lock_stats_t;
+
+static char *lock_names[LOCK_DATATYPE_COUNT] = {
+	"conf", "job", "node", "part", "fed", "select_node",
+};
+static bool lock_stats_enabled = false;
+static pthread_mutex_t lock_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static lock_stats_t lock_stats[LOCK_DATATYPE_COUNT];
+
+static pthread_rwlock_t slurmctld_locks[LOCK_DATATYPE_COUNT] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
@@ -107,40 +124,63 @@ extern bool verify_lock(lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+/* Acquire one lock, recording contention if lock_stats is enabled */
+static void _lock(lock_datatype_t datatype, lock_level_t level)
+{
+	pthread_rwlock_t *lock = &slurmctld_locks[datatype];
+	lock_stats_t *stats = &lock_stats[datatype];
+	int inx = (level == WRITE_LOCK) ? 1 : 0;
+	timespec_t start = { 0, 0 }, end = { 0, 0 };
+	uint64_t usec = 0;
+	bool waited = false;
+
+	if (level == NO_LOCK)
+		return;
+
+	if (!lock_stats_enabled) {
+		if (level == READ_LOCK)
+			slurm_rwlock_rdlock(lock);
+		else
+			slurm_rwlock_wrlock(lock);
+		return;
+	}
+
+	if (level == READ_LOCK)
+		waited = slurm_rwlock_tryrdlock(lock);
+	else
+		waited = slurm_rwlock_trywrlock(lock);
+
+	if (waited) {
+		start = timespec_now();
+		if (level == READ_LOCK)
+			slurm_rwlock_rdlock(lock);
+		else
+			slurm_rwlock_wrlock(lock);
+		usec = timer_get_duration(&start, &end);
+	}
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	stats->count[inx]++;
+	if (waited) {
+		stats->wait_count[inx]++;
+		stats->wait_usec[inx] += usec;
+		stats->wait_max_usec[inx] = MAX(stats->wait_max_usec[inx],
+						usec);
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
+
 /* lock_slurmctld - Issue the required lock requests in a well defined order */
 extern void lock_slurmctld(slurmctld_lock_t lock_levels)
 {
 	xassert(_store_locks(lock_levels));
 
-	if (lock_levels.conf == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[CONF_LOCK]);
-	else if (lock_levels.conf == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[CONF_LOCK]);
-
-	if (lock_levels.job == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[JOB_LOCK]);
-	else if (lock_levels.job == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[JOB_LOCK]);
-
-	if (lock_levels.node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[NODE_LOCK]);
-	else if (lock_levels.node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[NODE_LOCK]);
-
-	if (lock_levels.part == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[PART_LOCK]);
-	else if (lock_levels.part == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[PART_LOCK]);
-
-	if (lock_levels.fed == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[FED_LOCK]);
-	else if (lock_levels.fed == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[FED_LOCK]);
-
-	if (lock_levels.select_node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[SELECT_NODE_LOCK]);
-	else if (lock_levels.select_node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[SELECT_NODE_LOCK]);
+	_lock(CONF_LOCK, lock_levels.conf);
+	_lock(JOB_LOCK, lock_levels.job);
+	_lock(NODE_LOCK, lock_levels.node);
+	_lock(PART_LOCK, lock_levels.part);
+	_lock(FED_LOCK, lock_levels.fed);
+	_lock(SELECT_NODE_LOCK, lock_levels.select_node);
 }
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
@@ -210,3 +250,48 @@ int report_locks_set(void)
 	}
 	return lock_count;
 }
+
+extern void lock_stats_enable(bool enable)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	if (enable && !lock_stats_enabled)
+		memset(lock_stats, 0, sizeof(lock_stats));
+	lock_stats_enabled = enable;
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
+
+extern void lock_stats_pack(buf_t *buffer, uint16_t protocol_version)
+{
+	uint64_t stats[8][LOCK_DATATYPE_COUNT];
+	uint32_t cnt = 0;
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	if (lock_stats_enabled) {
+		cnt = LOCK_DATATYPE_COUNT;
+		for (int i = 0; i < cnt; i++) {
+			for (int j = 0; j < 2; j++) {
+				stats[(j * 4)][i] = lock_stats[i].count[j];
+				stats[(j * 4) + 1][i] =
+					lock_stats[i].wait_count[j];
+				stats[(j * 4) + 2][i] =
+					lock_stats[i].wait_usec[j];
+				stats[(j * 4) + 3][i] =
+					lock_stats[i].wait_max_usec[j];
+			}
+		}
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+
+	if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+		packstr_array(lock_names, cnt, buffer);
+		for (int i = 0; i < 8; i++)
+			pack64_array(stats[i], cnt, buffer);
+	}
+}
+
+extern void lock_stats_reset(void)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	memset(lock_stats, 0, sizeof(lock_stats));
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
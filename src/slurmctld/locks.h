@@ -86,6 +86,18 @@
  * NOTE: When using lock_slurmctld() and assoc_mgr_lock(), always call
  * lock_slurmctld() before calling assoc_mgr_lock() and then call
  * assoc_mgr_unlock() before calling unlock_slurmctld().
+ *
+ * Lock ordering, which every thread must follow to avoid deadlock:
+ *	conf -> job -> node -> part -> fed -> select_node -> assoc_mgr locks
+ *	-> any mutex private to a module (e.g. the job_info cache in
+ *	job_mgr.c, which is only taken while holding the job lock).
+ * Locks are released in the reverse order. lock_slurmctld() always acquires
+ * in this order, so the locks of a thread must all be requested by a single
+ * lock_slurmctld() call.
+ *
+ * With SlurmctldParameters=lock_stats every acquisition first tries the lock
+ * and counts how often, and for how long, callers had to wait for each lock.
+ * The statistics are reported by sdiag and reset with it.
 \*****************************************************************************/
 
 #ifndef _SLURMCTLD_LOCKS_H
@@ -93,6 +105,8 @@
 
 #include <stdbool.h>
 
+#include "src/common/pack.h"
+
 /* levels of locking required for each data structure */
 typedef enum {
 	NO_LOCK,
@@ -117,6 +131,7 @@ typedef enum {
 	PART_LOCK,
 	FED_LOCK,
 	SELECT_NODE_LOCK,
+	LOCK_DATATYPE_COUNT, /* count of lock datatypes, must be last */
 }	lock_datatype_t;
 
 #ifndef NDEBUG
@@ -132,4 +147,13 @@ extern void unlock_slurmctld (slurmctld_lock_t lock_levels);
 
 extern int report_locks_set(void);
 
+/* Enable or disable lock contention statistics (lock_stats) */
+extern void lock_stats_enable(bool enable);
+
+/* Pack lock contention statistics for a stats_info_response_msg_t */
+extern void lock_stats_pack(buf_t *buffer, uint16_t protocol_version);
+
+/* Reset lock contention statistics */
+extern void lock_stats_reset(void);
+
 #endif
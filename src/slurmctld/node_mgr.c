@@ -948,12 +948,14 @@ static bool _determine_if_node_is_hidden(
  *	in machine independent form (for network transmission)
  * IN show_flags - node filtering options
  * IN uid - uid of user making request (for partition filtering)
+ * IN compact - pack node records in the compact encoding, the client set
+ *	SLURM_COMPACT_ENCODING
  * IN protocol_version - slurm protocol version of client
  * OUT buffer
  * global: node_record_table_ptr - pointer to global node table
  * NOTE: change slurm_load_node() in api/node_info.c when data format changes
  */
-extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid,
+extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid, bool compact,
 			     uint16_t protocol_version)
 {
 	int inx;
@@ -983,6 +985,10 @@ extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid,
 		pack_bitmap_offset = get_buf_offset(buffer);
 		pack_bit_str_hex(hidden_nodes, buffer);
 
+		if (compact &&
+		    (protocol_version >= SLURM_26_05_PROTOCOL_VERSION))
+			buf_set_compact(buffer, true);
+
 		/* write node records */
 		for (inx = 0; inx < node_record_count; inx++) {
 			if (_determine_if_node_is_hidden(
@@ -999,6 +1005,7 @@ extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid,
 			}
 			nodes_packed++;
 		}
+		buf_clear_compact(buffer);
 
 		if (repack_hidden) {
 			tmp_offset = get_buf_offset(buffer);
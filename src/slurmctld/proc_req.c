@@ -1585,6 +1585,7 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 	DEF_TIMERS;
 	buf_t *buffer = NULL;
 	job_info_request_msg_t *job_info_request_msg = msg->data;
+	bool compact = (msg->flags & SLURM_COMPACT_ENCODING);
 	/* Locks: Read config job part */
 	slurmctld_lock_t job_read_lock = {
 		READ_LOCK, READ_LOCK, NO_LOCK, READ_LOCK, READ_LOCK };
@@ -1602,12 +1603,17 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 		if (job_info_request_msg->job_ids) {
 			buffer = pack_spec_jobs(job_info_request_msg->job_ids,
 						job_info_request_msg->show_flags,
-						msg->auth_uid, NO_VAL,
+						msg->auth_uid, NO_VAL, compact,
 						msg->protocol_version);
 		} else {
-			buffer = pack_all_jobs(job_info_request_msg->show_flags,
-					       msg->auth_uid, NO_VAL,
-					       msg->protocol_version);
+			buffer = pack_all_jobs(
+				job_info_request_msg->show_flags,
+				msg->auth_uid, NO_VAL,
+				job_info_request_msg->last_update,
+				job_info_request_msg->after_job_id,
+				job_info_request_msg->max_jobs,
+				job_info_request_msg->fields, compact,
+				msg->protocol_version);
 		}
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(job_read_lock);
@@ -1633,8 +1639,8 @@ static void _slurm_rpc_dump_jobs_user(slurm_msg_t *msg)
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 		lock_slurmctld(job_read_lock);
 	buffer = pack_all_jobs(job_info_request_msg->show_flags, msg->auth_uid,
-			       job_info_request_msg->user_id,
-			       msg->protocol_version);
+			       job_info_request_msg->user_id, 0, 0, 0, 0,
+			       false, msg->protocol_version);
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 		unlock_slurmctld(job_read_lock);
 	END_TIMER2(__func__);
@@ -1864,7 +1870,9 @@ static void _slurm_rpc_dump_nodes(slurm_msg_t *msg)
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
 		buffer = pack_all_nodes(node_req_msg->show_flags,
-					msg->auth_uid, msg->protocol_version);
+					msg->auth_uid,
+					(msg->flags & SLURM_COMPACT_ENCODING),
+					msg->protocol_version);
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(node_write_lock);
 		END_TIMER2(__func__);
@@ -1911,6 +1911,8 @@ extern int read_slurm_conf(int recover)
 			strtol(tmp_ptr + strlen("max_powered_nodes="),
 			       NULL, 10);
 	}
+	lock_stats_enable(xstrcasestr(slurm_conf.slurmctld_params,
+				      "lock_stats"));
 
 	slurm_conf.last_update = time(NULL);
 end_it:
@@ -221,6 +221,12 @@ typedef struct diag_stats {
 	uint32_t bf_table_size_sum;
 	time_t   bf_when_last_cycle;
 
+	uint32_t job_state_save_counter;
+	uint32_t job_state_save_last;
+	uint32_t job_state_save_max;
+	uint32_t job_state_save_lock_last;
+	uint32_t job_state_save_lock_max;
+
 	uint32_t latency;
 } diag_stats_t;
 
@@ -1369,6 +1375,12 @@ extern int dump_job_state(const uint32_t filter_jobs_count,
  * IN show_flags - job filtering options
  * IN uid - uid of user making request (for partition filtering)
  * IN filter_uid - pack only jobs belonging to this user if not NO_VAL
+ * IN last_update - with SHOW_DELTA, pack only jobs changed since
+ * IN after_job_id - pack only jobs with a greater job id
+ * IN max_jobs - pack at most this many jobs sorted by job id, 0 for all
+ * IN fields - JOB_FIELD_* to pack for each job, 0 for all
+ * IN compact - pack job records in the compact encoding, the client set
+ *	SLURM_COMPACT_ENCODING
  * IN protocol_version - slurm protocol version of client
  * OUT buffer
  * global: job_list - global list of job records
@@ -1376,6 +1388,8 @@ extern int dump_job_state(const uint32_t filter_jobs_count,
  *	whenever the data format changes
  */
 extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
+			    time_t last_update, uint32_t after_job_id,
+			    uint32_t max_jobs, uint64_t fields, bool compact,
 			    uint16_t protocol_version);
 
 /*
@@ -1385,6 +1399,7 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
  * IN job_ids - list of job_ids to pack
  * IN uid - uid of user making request (for partition filtering)
  * IN filter_uid - pack only jobs belonging to this user if not NO_VAL
+ * IN compact - pack job records in the compact encoding
  * OUT buffer
  * global: job_list - global list of job records
  * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
@@ -1392,20 +1407,23 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
  *	whenever the data format changes
  */
 extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
-			     uint32_t filter_uid, uint16_t protocol_version);
+			     uint32_t filter_uid, bool compact,
+			     uint16_t protocol_version);
 
 /*
  * pack_all_nodes - dump all configuration and node information for all nodes
  *	in machine independent form (for network transmission)
  * IN show_flags - node filtering options
  * IN uid - uid of user making request (for partition filtering)
+ * IN compact - pack node records in the compact encoding, the client set
+ *	SLURM_COMPACT_ENCODING
  * IN protocol_version - slurm protocol version of client
  * OUT buffer
  * global: node_record_table_ptr - pointer to global node table
  * NOTE: change slurm_load_node() in api/node_info.c when data format changes
  * NOTE: READ lock_slurmctld config before entry
  */
-extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid,
+extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid, bool compact,
 			     uint16_t protocol_version);
 
 /*
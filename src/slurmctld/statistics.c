@@ -139,6 +139,19 @@ extern buf_t *pack_all_stat(uint16_t protocol_version)
 		pack32(slurmctld_diag_stats.backfilled_het_jobs, buffer);
 		pack32_array(slurmctld_diag_stats.bf_exit, BF_EXIT_COUNT,
 			     buffer);
+
+		if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+			pack32(slurmctld_diag_stats.job_state_save_counter,
+			       buffer);
+			pack32(slurmctld_diag_stats.job_state_save_last,
+			       buffer);
+			pack32(slurmctld_diag_stats.job_state_save_max, buffer);
+			pack32(slurmctld_diag_stats.job_state_save_lock_last,
+			       buffer);
+			pack32(slurmctld_diag_stats.job_state_save_lock_max,
+			       buffer);
+			lock_stats_pack(buffer, protocol_version);
+		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack32(1, buffer); /* please remove on next version */
 
@@ -246,6 +259,14 @@ extern void reset_stats(int level)
 	memset(slurmctld_diag_stats.bf_exit, 0,
 	       sizeof(slurmctld_diag_stats.bf_exit));
 
+	slurmctld_diag_stats.job_state_save_counter = 0;
+	slurmctld_diag_stats.job_state_save_last = 0;
+	slurmctld_diag_stats.job_state_save_max = 0;
+	slurmctld_diag_stats.job_state_save_lock_last = 0;
+	slurmctld_diag_stats.job_state_save_lock_max = 0;
+
+	lock_stats_reset();
+
 	last_proc_req_start = time(NULL);
 }
 
@@ -59,6 +59,7 @@
 
 #include "src/interfaces/accounting_storage.h"
 #include "src/interfaces/auth.h"
+#include "src/interfaces/compress.h"
 #include "src/interfaces/conn.h"
 #include "src/interfaces/gres.h"
 #include "src/interfaces/jobacct_gather.h"
@@ -70,11 +71,15 @@
 #include "src/slurmdbd/rpc_mgr.h"
 #include "src/slurmdbd/slurmdbd.h"
 
+/* jobs per DBD_GOT_JOBS_PART message for streamed DBD_GET_JOBS_COND */
+#define DBD_JOBS_PART_CNT 1000
+
 /* Local functions */
 static bool _validate_slurm_user(slurmdbd_conn_t *dbd_conn);
 static bool _validate_super_user(slurmdbd_conn_t *dbd_conn);
 static bool _validate_operator(slurmdbd_conn_t *dbd_conn);
 static int   _find_rpc_obj_in_list(void *x, void *key);
+static void _compress_out_buffer(buf_t **out_buffer);
 static void _process_job_start(slurmdbd_conn_t *slurmdbd_conn,
 			       dbd_job_start_msg_t *job_start_msg,
 			       dbd_id_rc_msg_t *id_rc_msg);
@@ -313,6 +318,10 @@ static int _unpack_persist_init(slurmdbd_conn_t *slurmdbd_conn,
 
 	if (rc != SLURM_SUCCESS)
 		comment = slurm_strerror(rc);
+	else if ((smsg->flags & SLURM_COMPRESS_LZ4) &&
+		 (req_msg->version >= SLURM_26_05_PROTOCOL_VERSION) &&
+		 compress_g_available(COMPRESS_PLUGIN_LZ4))
+		slurmdbd_conn->pcon->flags |= PERSIST_FLAG_COMPRESS;
 
 	*out_buffer = slurm_persist_make_rc_msg_flags(
 		slurmdbd_conn->pcon, rc, comment,
@@ -1104,6 +1113,45 @@ static int _get_instances(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 	return rc;
 }
 
+/*
+ * Send all but the last DBD_JOBS_PART_CNT jobs of job_list as
+ * DBD_GOT_JOBS_PART messages, freeing each job once packed.
+ * RET SLURM_SUCCESS or error
+ */
+static int _send_jobs_parts(slurmdbd_conn_t *slurmdbd_conn, list_t *job_list)
+{
+	int rc = SLURM_SUCCESS;
+
+	while (list_count(job_list) > DBD_JOBS_PART_CNT) {
+		dbd_list_msg_t list_msg = {
+			.my_list = list_create(slurmdb_destroy_job_rec),
+		};
+		buf_t *buffer;
+
+		for (int i = 0; i < DBD_JOBS_PART_CNT; i++)
+			list_append(list_msg.my_list, list_pop(job_list));
+
+		buffer = init_buf(1024);
+		pack16((uint16_t) DBD_GOT_JOBS_PART, buffer);
+		slurmdbd_pack_list_msg(&list_msg, slurmdbd_conn->pcon->version,
+				       DBD_GOT_JOBS_PART, buffer);
+		FREE_NULL_LIST(list_msg.my_list);
+
+		if (slurmdbd_conn->pcon->flags & PERSIST_FLAG_COMPRESS)
+			_compress_out_buffer(&buffer);
+
+		rc = slurm_persist_send_msg(slurmdbd_conn->pcon, buffer);
+		FREE_NULL_BUFFER(buffer);
+		if (rc != SLURM_SUCCESS) {
+			error("%s: unable to send DBD_GOT_JOBS_PART: %s",
+			      __func__, slurm_strerror(rc));
+			break;
+		}
+	}
+
+	return rc;
+}
+
 static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			  buf_t **out_buffer)
 {
@@ -1151,6 +1199,15 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 		slurmdbd_conn->db_conn, slurmdbd_conn->pcon->auth_uid,
 		job_cond);
 
+	if (!errno && list_msg.my_list &&
+	    (job_cond->flags & JOBCOND_FLAG_STREAM) &&
+	    (slurmdbd_conn->pcon->version >= SLURM_26_05_PROTOCOL_VERSION) &&
+	    (rc = _send_jobs_parts(slurmdbd_conn, list_msg.my_list))) {
+		/* Connection is unusable, nothing more can be sent */
+		FREE_NULL_LIST(list_msg.my_list);
+		return rc;
+	}
+
 	if (!errno) {
 		if (!list_msg.my_list)
 			list_msg.my_list = list_create(NULL);
@@ -2845,6 +2902,12 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 	}
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
+	/*
+	 * Process all the messages in one transaction. proc_req() commits
+	 * after DBD_SEND_MULT_MSG instead of after each message, which lets
+	 * the storage plugin batch their writes together.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
 	/* START_TIMER; */
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
@@ -2869,6 +2932,7 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			break;
 	}
 	list_iterator_destroy(itr);
+	slurmdbd_conn->in_mult_msg = false;
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -3140,6 +3204,28 @@ static int _shutdown(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
  * buffer OUT - outgoing response, must be freed by caller
  * uid IN/OUT - user ID who initiated the RPC
  * RET SLURM_SUCCESS or error code */
+/*
+ * Replace a large response with a DBD_COMPRESSED one when the client asked
+ * for it at REQUEST_PERSIST_INIT time
+ */
+static void _compress_out_buffer(buf_t **out_buffer)
+{
+	uint32_t threshold = slurm_get_compress_threshold();
+	buf_t *in = *out_buffer, *buffer;
+
+	if (!in || !threshold || (get_buf_offset(in) < threshold))
+		return;
+
+	buffer = init_buf(get_buf_offset(in));
+	pack16((uint16_t) DBD_COMPRESSED, buffer);
+	if (compress_g_pack_buf(COMPRESS_PLUGIN_LZ4, in, threshold, buffer)) {
+		FREE_NULL_BUFFER(in);
+		*out_buffer = buffer;
+	} else {
+		FREE_NULL_BUFFER(buffer);
+	}
+}
+
 extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 {
 	slurmdbd_conn_t *slurmdbd_conn = conn;
@@ -3414,16 +3500,23 @@ extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 		break;
 	}
 
+	if ((slurmdbd_conn->pcon->flags & PERSIST_FLAG_COMPRESS) &&
+	    (msg->msg_type != REQUEST_PERSIST_INIT))
+		_compress_out_buffer(out_buffer);
+
 	if (rc == ESLURM_ACCESS_DENIED)
 		error("CONN:%d Security violation, %s",
 		      fd, slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->pcon->rem_port &&
-		 (!slurmdbd_conf->commit_delay ||
-		  (msg->msg_type == DBD_REGISTER_CTLD))) {
+		 ((msg->msg_type == DBD_REGISTER_CTLD) ||
+		  (!slurmdbd_conf->commit_delay &&
+		   !slurmdbd_conn->in_mult_msg))) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
+		   Messages inside of a DBD_SEND_MULT_MSG are committed
+		   together once it is done.
 		*/
 		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
 	}
@@ -48,6 +48,7 @@ typedef struct {
 	persist_conn_t *pcon_send;
 	pthread_mutex_t pcon_send_lock;
 	void *db_conn; /* database connection */
+	bool in_mult_msg; /* commit once DBD_SEND_MULT_MSG is done */
 	char *tres_str;
 } slurmdbd_conn_t;
 
@@ -425,6 +425,7 @@ extern int operations_router(on_http_request_args_t *args, http_con_t *hcon,
 	int callback_tag;
 	const char *read_mime = NULL, *write_mime = NULL;
 	data_parser_t *parser = NULL;
+	data_arena_t *arena = NULL, *prior_arena = NULL;
 
 	info("%s: [%s] %s %s",
 	     __func__, name, get_http_method_string(args->method), args->path);
@@ -436,6 +437,13 @@ extern int operations_router(on_http_request_args_t *args, http_con_t *hcon,
 		return rc;
 	}
 
+	/*
+	 * All data_t trees for this request are released before returning
+	 * which allows allocating all of them from a single arena.
+	 */
+	arena = data_arena_new();
+	prior_arena = data_arena_set(arena);
+
 	params = data_set_dict(data_new());
 	if ((rc = _resolve_path(args, &path_tag, params)))
 		goto cleanup;
@@ -473,6 +481,8 @@ extern int operations_router(on_http_request_args_t *args, http_con_t *hcon,
 cleanup:
 	FREE_NULL_DATA(query);
 	FREE_NULL_DATA(params);
+	(void) data_arena_set(prior_arena);
+	FREE_NULL_DATA_ARENA(arena);
 
 	/* always clear the auth context */
 	http_context_free_null_auth(args->context);
@@ -75,6 +75,111 @@ static const slurm_err_t nonfatal_errors[] = {
 	ESLURM_PORTS_BUSY,
 };
 
+typedef struct {
+	const char *key;
+	uint64_t field;
+} job_field_key_t;
+
+/* Job fields that can be loaded individually from slurmctld */
+static const job_field_key_t job_field_keys[] = {
+	{ "account", JOB_FIELD_ACCOUNT },
+	{ "admin_comment", JOB_FIELD_COMMENT },
+	{ "array_job_id", JOB_FIELD_ARRAY },
+	{ "array_max_tasks", JOB_FIELD_ARRAY },
+	{ "array_task_id", JOB_FIELD_ARRAY },
+	{ "array_task_string", JOB_FIELD_ARRAY },
+	{ "cluster", JOB_FIELD_CLUSTER },
+	{ "command", JOB_FIELD_WORK_DIR },
+	{ "comment", JOB_FIELD_COMMENT },
+	{ "cpus", JOB_FIELD_CPUS },
+	{ "current_working_directory", JOB_FIELD_WORK_DIR },
+	{ "derived_exit_code", JOB_FIELD_EXIT_CODE },
+	{ "eligible_time", JOB_FIELD_TIME },
+	{ "end_time", JOB_FIELD_TIME },
+	{ "exit_code", JOB_FIELD_EXIT_CODE },
+	{ "flags", JOB_FIELD_FLAGS },
+	{ "group_id", JOB_FIELD_GROUP },
+	{ "group_name", JOB_FIELD_GROUP },
+	{ "het_job_id", JOB_FIELD_HET },
+	{ "het_job_id_set", JOB_FIELD_HET },
+	{ "het_job_offset", JOB_FIELD_HET },
+	{ "hold", JOB_FIELD_PRIORITY },
+	{ "job_id", JOB_FIELD_STEP_ID },
+	{ "job_state", JOB_FIELD_STATE },
+	{ "max_cpus", JOB_FIELD_CPUS },
+	{ "max_nodes", JOB_FIELD_NODES },
+	{ "name", JOB_FIELD_NAME },
+	{ "node_count", JOB_FIELD_NODES },
+	{ "nodes", JOB_FIELD_NODES },
+	{ "partition", JOB_FIELD_PARTITION },
+	{ "priority", JOB_FIELD_PRIORITY },
+	{ "qos", JOB_FIELD_QOS },
+	{ "resv_name", JOB_FIELD_RESV },
+	{ "scheduled_nodes", JOB_FIELD_NODES },
+	{ "standard_error", JOB_FIELD_STDIO },
+	{ "standard_input", JOB_FIELD_STDIO },
+	{ "standard_output", JOB_FIELD_STDIO },
+	{ "start_time", JOB_FIELD_TIME },
+	{ "state_description", JOB_FIELD_STATE },
+	{ "state_reason", JOB_FIELD_STATE },
+	{ "step_id", JOB_FIELD_STEP_ID },
+	{ "submit_time", JOB_FIELD_TIME },
+	{ "suspend_time", JOB_FIELD_TIME },
+	{ "system_comment", JOB_FIELD_COMMENT },
+	{ "time_limit", JOB_FIELD_TIME },
+	{ "tres_alloc_str", JOB_FIELD_TRES },
+	{ "tres_req_str", JOB_FIELD_TRES },
+	{ "user_id", JOB_FIELD_USER },
+	{ "user_name", JOB_FIELD_USER },
+};
+
+static int _foreach_job_field(void *x, void *arg)
+{
+	const char *key = x;
+	uint64_t *fields = arg;
+
+	for (int i = 0; i < ARRAY_SIZE(job_field_keys); i++) {
+		if (!xstrcmp(job_field_keys[i].key, key)) {
+			*fields |= job_field_keys[i].field;
+			return 0;
+		}
+	}
+
+	/* Field can not be loaded individually */
+	return -1;
+}
+
+/* RET JOB_FIELD_* to load for requested field keys or 0 to load all */
+static uint64_t _job_fields(list_t *keys)
+{
+	uint64_t fields = 0;
+
+	if (!keys || !list_count(keys))
+		return 0;
+
+	if (list_for_each_ro(keys, _foreach_job_field, &fields) < 0)
+		return 0;
+
+	return fields;
+}
+
+/* Only dump the requested fields of each job, consumes query->fields */
+static void _dump_job_fields(ctxt_t *ctxt, openapi_job_info_query_t *query)
+{
+	if (!query->fields)
+		return;
+
+	if (data_parser_g_assign(ctxt->parser, DATA_PARSER_ATTR_FIELDS,
+				 query->fields)) {
+		resp_warn(ctxt, __func__,
+			  "Job field selection is not supported by %s. Dumping all fields instead.",
+			  data_parser_get_plugin(ctxt->parser));
+		FREE_NULL_LIST(query->fields);
+	}
+
+	query->fields = NULL;
+}
+
 static int _signal_jobs(openapi_ctxt_t *ctxt)
 {
 	int rc;
@@ -121,6 +226,7 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 
 	if (DATA_PARSE(ctxt->parser, OPENAPI_JOB_INFO_QUERY, query, ctxt->query,
 		       ctxt->parent_path)) {
+		FREE_NULL_LIST(query.fields);
 		return resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
 				  "Rejecting request. Failure parsing query.");
 	}
@@ -128,8 +234,9 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 	if (!query.show_flags)
 		query.show_flags = SHOW_ALL | SHOW_DETAIL;
 
-	rc = slurm_load_jobs(query.update_time, &job_info_ptr,
-			     query.show_flags);
+	rc = slurm_load_jobs_page(query.update_time, &job_info_ptr,
+				  query.show_flags, query.cursor, query.limit,
+				  _job_fields(query.fields));
 
 	if (rc == SLURM_NO_CHANGE_IN_DATA) {
 		char ts[32] = {0};
@@ -149,6 +256,7 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 		resp.jobs = job_info_ptr;
 	}
 
+	_dump_job_fields(ctxt, &query);
 	DATA_DUMP(ctxt->parser, OPENAPI_JOB_INFO_RESP, resp, ctxt->resp);
 
 	slurm_free_job_info_msg(job_info_ptr);
@@ -165,6 +273,7 @@ static void _handle_job_get(ctxt_t *ctxt, slurm_selected_step_t *job_id)
 
 	if (DATA_PARSE(ctxt->parser, OPENAPI_JOB_INFO_QUERY, query, ctxt->query,
 		       ctxt->parent_path)) {
+		FREE_NULL_LIST(query.fields);
 		resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
 			   "Rejecting request. Failure parsing query.");
 		return;
@@ -200,6 +309,7 @@ static void _handle_job_get(ctxt_t *ctxt, slurm_selected_step_t *job_id)
 		resp.jobs = job_info_ptr;
 	}
 
+	_dump_job_fields(ctxt, &query);
 	DATA_DUMP(ctxt->parser, OPENAPI_JOB_INFO_RESP, resp, ctxt->resp);
 
 	slurm_free_job_info_msg(job_info_ptr);
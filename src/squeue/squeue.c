@@ -331,11 +331,15 @@ static int _print_job(bool clear_old, bool log_cluster_name, int argc,
 		} else {
 			if (params.clusters)
 				show_flags |= SHOW_LOCAL;
+			/* Only fetch jobs changed since the last iteration */
 			error_code = slurm_load_jobs(
 				old_job_ptr->last_update,
-				&new_job_ptr, show_flags);
+				&new_job_ptr, (show_flags | SHOW_DELTA));
 		}
-		if (error_code ==  SLURM_SUCCESS)
+		if ((error_code == SLURM_SUCCESS) && new_job_ptr->delta) {
+			slurm_merge_job_info_msg(old_job_ptr, new_job_ptr);
+			new_job_ptr = old_job_ptr;
+		} else if (error_code ==  SLURM_SUCCESS)
 			slurm_free_job_info_msg( old_job_ptr );
 		else if (errno == SLURM_NO_CHANGE_IN_DATA) {
 			error_code = SLURM_SUCCESS;
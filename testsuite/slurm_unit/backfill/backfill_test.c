@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
 #include "backfill.h"
 #include "slurm/slurm.h"
@@ -79,6 +81,15 @@ pthread_cond_t check_bf_running_cond = PTHREAD_COND_INITIALIZER;
 typedef struct {
 	char *testcases;
 	char *configdir;
+	/* benchmark mode */
+	uint32_t bench_cycles;
+	uint32_t bench_jobs;
+	uint32_t bench_nodes;
+	uint32_t bench_parts;
+	uint64_t bench_seed;
+	char *bench_tmpdir;
+	char *sched_params;
+	char *topology;
 } backfilltest_opts_t;
 
 static backfilltest_opts_t params;
@@ -98,14 +109,35 @@ static int _set_options(int argc, char **argv)
 
 	_init_opts();
 
-	while ((c = getopt(argc, argv, "c:t:U")) != EOF) {
+	while ((c = getopt(argc, argv, "c:j:n:p:P:r:s:t:T:U")) != EOF) {
 		switch (c) {
 		case 'c':
 			params.configdir = xstrdup(optarg);
 			break;
+		case 'j':
+			params.bench_jobs = strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			params.bench_nodes = strtoul(optarg, NULL, 10);
+			break;
+		case 'p':
+			params.sched_params = xstrdup(optarg);
+			break;
+		case 'P':
+			params.bench_parts = strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			params.bench_cycles = strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			params.bench_seed = strtoull(optarg, NULL, 10);
+			break;
 		case 't':
 			params.testcases = xstrdup(optarg);
 			break;
+		case 'T':
+			params.topology = xstrdup(optarg);
+			break;
 		case 'U':
 			_help_msg();
 			exit(1);
@@ -147,9 +179,17 @@ Usage backfill-test [<OPTION>]\n"
 "Valid <OPTION> values are:\n"
 " -c     Path to a directory with slurm config files.\n"
 " -t     Path to a file containing test cases.\n"
+" -n     Benchmark: generate a cluster with this many nodes.\n"
+" -j     Benchmark: generate this many pending jobs.\n"
+" -P     Benchmark: split the nodes into this many partitions.\n"
+" -r     Benchmark: number of backfill cycles to run (default 1).\n"
+" -s     Benchmark: random seed of the generated jobs (default 1).\n"
+" -T     Benchmark: topology, block (default), tree or flat.\n"
+" -p     SchedulerParameters to use with a generated cluster.\n"
 " -U     Display brief usage message\n"
-"backfill-test can run in two modes:pre-set libcheck tests or\n"
-"as a backfill emulator when the '-t' option is used.\n");
+"backfill-test can run in three modes:pre-set libcheck tests,\n"
+"as a backfill emulator when the '-t' option is used or as a\n"
+"benchmark when the '-n' or '-j' option is used.\n");
 }
 
 /* _free_options()
@@ -158,6 +198,9 @@ static void _free_options(void)
 {
 	xfree(params.testcases);
 	xfree(params.configdir);
+	xfree(params.bench_tmpdir);
+	xfree(params.sched_params);
+	xfree(params.topology);
 }
 
 /* this will leak memory, but we don't care really */
@@ -283,6 +326,286 @@ void load_test()
 	fclose(f);
 }
 
+/*
+ * Benchmark mode
+ *
+ * Generate a synthetic cluster and job mix from a seed and report the time
+ * and memory used by each phase, so scheduler parameters and releases can
+ * be compared offline.
+ */
+#define BENCH_BLOCK_NODES 16
+#define BENCH_LEAF_NODES 32
+
+static uint64_t _bench_rand(void)
+{
+	static uint64_t state = 0;
+	uint64_t z;
+
+	if (!state)
+		state = params.bench_seed ? params.bench_seed : 1;
+
+	/* splitmix64, reproducible across libc implementations */
+	z = (state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static char *_bench_path(const char *file)
+{
+	return xstrdup_printf("%s/%s", params.bench_tmpdir, file);
+}
+
+/*
+ * Write slurm.conf and topology.conf of a cluster with params.bench_nodes
+ * nodes of two different sizes into a temporary directory. Everything but
+ * the nodes, licenses, topology and SchedulerParameters is copied from the
+ * slurm.conf of the configuration directory.
+ */
+static int _bench_write_config(void)
+{
+	char *src_dir = getenv("srcdir");
+	char tmpdir[] = "/tmp/backfill-test.XXXXXX";
+	char *path, line[1024];
+	FILE *in, *out;
+	uint32_t nodes, half, i;
+	bool tree = !xstrcasecmp(params.topology, "tree");
+
+	if (params.topology && !tree && xstrcasecmp(params.topology, "block")) {
+		error("Invalid topology %s", params.topology);
+		return -1;
+	}
+
+	/* Whole blocks and leaf switches */
+	nodes = ROUNDUP(params.bench_nodes, BENCH_LEAF_NODES);
+	nodes *= BENCH_LEAF_NODES;
+	half = nodes / 2;
+
+	if (params.configdir)
+		path = xstrdup_printf("%s/slurm.conf", params.configdir);
+	else if (src_dir)
+		path = xstrdup_printf("%s/slurm.conf", src_dir);
+	else
+		path = xstrdup("slurm.conf");
+	if (!(in = fopen(path, "r"))) {
+		error("Unable to open %s: %m", path);
+		xfree(path);
+		return -1;
+	}
+	xfree(path);
+
+	if (!mkdtemp(tmpdir)) {
+		error("Unable to create temporary directory: %m");
+		fclose(in);
+		return -1;
+	}
+	params.bench_tmpdir = xstrdup(tmpdir);
+
+	path = _bench_path("slurm.conf");
+	out = fopen(path, "w");
+	xfree(path);
+	if (!out) {
+		error("Unable to create slurm.conf: %m");
+		fclose(in);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), in)) {
+		if (!xstrncasecmp(line, "NodeName=", 9) ||
+		    !xstrncasecmp(line, "Licenses=", 9) ||
+		    !xstrncasecmp(line, "SchedulerParameters=", 20) ||
+		    !xstrncasecmp(line, "TopologyPlugin=", 15))
+			continue;
+		fputs(line, out);
+	}
+	fclose(in);
+
+	fprintf(out, "Licenses=benchlic:%u\n", MAX(nodes / 50, 1));
+	fprintf(out, "SchedulerParameters=%s\n",
+		params.sched_params ? params.sched_params : "bf_licenses");
+	fprintf(out, "TopologyPlugin=topology/%s\n", tree ? "tree" : "block");
+	fprintf(out, "NodeName=bn[%06u-%06u] NodeAddr=localhost RealMemory=2000 CoresPerSocket=4\n",
+		0, half - 1);
+	fprintf(out, "NodeName=bn[%06u-%06u] NodeAddr=localhost RealMemory=8000 Sockets=2 CoresPerSocket=16\n",
+		half, nodes - 1);
+	fclose(out);
+
+	path = _bench_path("topology.conf");
+	out = fopen(path, "w");
+	xfree(path);
+	if (!out) {
+		error("Unable to create topology.conf: %m");
+		return -1;
+	}
+	if (tree) {
+		for (i = 0; i < nodes; i += BENCH_LEAF_NODES)
+			fprintf(out, "SwitchName=leaf%u Nodes=bn[%06u-%06u]\n",
+				i / BENCH_LEAF_NODES, i,
+				i + BENCH_LEAF_NODES - 1);
+		fprintf(out, "SwitchName=spine Switches=leaf[0-%u]\n",
+			(nodes / BENCH_LEAF_NODES) - 1);
+	} else {
+		for (i = 0; i < nodes; i += BENCH_BLOCK_NODES)
+			fprintf(out, "BlockName=bb%u Nodes=bn[%06u-%06u]\n",
+				i / BENCH_BLOCK_NODES, i,
+				i + BENCH_BLOCK_NODES - 1);
+	}
+	fclose(out);
+
+	xfree(params.configdir);
+	params.configdir = xstrdup(params.bench_tmpdir);
+
+	return 0;
+}
+
+static void _bench_remove_config(void)
+{
+	char *path;
+
+	if (!params.bench_tmpdir)
+		return;
+
+	path = _bench_path("slurm.conf");
+	(void) unlink(path);
+	xfree(path);
+	path = _bench_path("topology.conf");
+	(void) unlink(path);
+	xfree(path);
+	(void) rmdir(params.bench_tmpdir);
+}
+
+/* Split the nodes of the "test" partition into params.bench_parts ones */
+static void _bench_add_parts(part_record_t *test_part_ptr)
+{
+	uint32_t parts = MAX(params.bench_parts, 1);
+
+	for (uint32_t p = 0; p < parts; p++) {
+		part_record_t *part_ptr = test_part_ptr;
+		uint32_t first = ((uint64_t) node_record_count * p) / parts;
+		uint32_t last = ((uint64_t) node_record_count * (p + 1)) /
+				parts - 1;
+
+		if (p) {
+			part_ptr = part_record_create();
+			part_ptr->name = xstrdup_printf("test%u", p);
+			part_ptr->node_bitmap = bit_alloc(node_record_count);
+			list_append(part_list, part_ptr);
+		}
+		/* Share nodes between jobs, down to the core */
+		part_ptr->max_share = 1;
+		bit_clear_all(part_ptr->node_bitmap);
+		bit_nset(part_ptr->node_bitmap, first, last);
+	}
+}
+
+/*
+ * Add params.bench_jobs pending jobs: mostly small and short ones, with
+ * a tail of large and long ones, some of them exclusive or using licenses.
+ */
+static void _bench_add_jobs(void)
+{
+	uint32_t parts = MAX(params.bench_parts, 1);
+
+	for (uint32_t i = 0; i < params.bench_jobs; i++) {
+		job_record_t *job_ptr;
+		part_record_t *part_ptr = NULL;
+		uint32_t p = _bench_rand() % parts;
+		uint32_t r = _bench_rand() % 100, max_size, size, time_limit;
+		char *licenses = NULL;
+
+		if (p) {
+			char *name = xstrdup_printf("test%u", p);
+			part_ptr = find_part_record(name);
+			xfree(name);
+		} else {
+			part_ptr = find_part_record("test");
+		}
+		max_size = bit_set_count(part_ptr->node_bitmap);
+
+		if (r < 60)
+			size = 4;
+		else if (r < 85)
+			size = max_size / 64;
+		else if (r < 95)
+			size = max_size / 16;
+		else
+			size = max_size / 4;
+		size = 1 + (_bench_rand() % MAX(size, 1));
+		size = MIN(size, max_size);
+
+		if (_bench_rand() % 4)
+			time_limit = 1 + (_bench_rand() % 120);
+		else
+			time_limit = 1 + (_bench_rand() % 1440);
+
+		if (!(_bench_rand() % 10))
+			licenses = "benchlic:1";
+
+		/* job_id, priority, nodes, num_tasks, segment_size, time_limit, licenses */
+		job_ptr = __add_job(0, 1 + (_bench_rand() % 10000), size,
+				    size * (1 + (_bench_rand() % 4)), 0,
+				    time_limit, licenses);
+		if (!(_bench_rand() % 10))
+			job_ptr->details->whole_node = WHOLE_NODE_REQUIRED;
+		if (p) {
+			xfree(job_ptr->partition);
+			job_ptr->partition = xstrdup(part_ptr->name);
+			job_ptr->part_ptr = part_ptr;
+		}
+	}
+}
+
+static int _bench_count_running(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	uint32_t *running = arg;
+
+	if (IS_JOB_RUNNING(job_ptr))
+		(*running)++;
+
+	return 0;
+}
+
+static void _bench_run(long setup_usec)
+{
+	uint32_t cycles = MAX(params.bench_cycles, 1);
+	struct rusage ru;
+	long usec;
+	DEF_TIMERS;
+
+	printf("nodes:%d partitions:%u jobs:%u seed:%"PRIu64" SchedulerParameters:%s\n",
+	       node_record_count, MAX(params.bench_parts, 1),
+	       params.bench_jobs, params.bench_seed ? params.bench_seed : 1,
+	       slurm_conf.sched_params);
+	printf("setup: %ld usec\n", setup_usec);
+
+	START_TIMER;
+	_bench_add_jobs();
+	END_TIMER;
+	printf("add jobs: %ld usec\n", TIMER_DURATION_USEC());
+
+	for (uint32_t c = 1; c <= cycles; c++) {
+		uint32_t running = 0;
+
+		START_TIMER;
+		__attempt_backfill();
+		END_TIMER;
+		usec = TIMER_DURATION_USEC();
+		list_for_each(job_list, _bench_count_running, &running);
+
+		printf("cycle %u: %ld usec (%u usec without yields), depth:%u tested:%u (%.0f/sec) running:%u table_size:%u\n",
+		       c, usec, slurmctld_diag_stats.bf_cycle_last,
+		       slurmctld_diag_stats.bf_last_depth,
+		       slurmctld_diag_stats.bf_last_depth_try,
+		       slurmctld_diag_stats.bf_last_depth_try * 1000000.0 /
+		       MAX(slurmctld_diag_stats.bf_cycle_last, 1),
+		       running, slurmctld_diag_stats.bf_table_size);
+	}
+
+	getrusage(RUSAGE_SELF, &ru);
+	printf("peak memory: %ld KB\n", ru.ru_maxrss);
+	fflush(stdout);
+}
+
 /*
  * Test simple backfill situation
  *
@@ -456,12 +779,27 @@ int main(int argc, char *argv[])
 	int number_failed = 0;
 #ifndef HAVE_FRONT_END
 	part_record_t *part_ptr = part_record_create();
+	bool bench;
+	DEF_TIMERS;
 
 	log_options_t log_opts = LOG_OPTS_INITIALIZER;
 	log_opts.stderr_level = LOG_LEVEL_VERBOSE;
+
 	log_init("backfill-test", log_opts, 0, NULL);
 
+	START_TIMER;
 	_set_options(argc, argv);
+	bench = (params.bench_nodes || params.bench_jobs);
+	if (bench) {
+		log_opts.stderr_level = LOG_LEVEL_ERROR;
+		log_alter(log_opts, 0, NULL);
+	}
+
+	if (params.bench_nodes && _bench_write_config()) {
+		_bench_remove_config();
+		_free_options();
+		return EXIT_FAILURE;
+	}
 
 	_check_params();
 	slurm_init(NULL);
@@ -480,6 +818,8 @@ int main(int argc, char *argv[])
 	part_ptr->node_bitmap = bit_copy(avail_node_bitmap);
 	part_ptr->max_share = 0;
 	list_append(part_list, part_ptr);
+	if (bench)
+		_bench_add_parts(part_ptr);
 
 	select_g_node_init();
 	node_features_g_init();
@@ -506,8 +846,11 @@ int main(int argc, char *argv[])
 	license_init(slurm_conf.licenses);
 
 	select_g_reconfigure();
+	END_TIMER;
 
-	if (!params.testcases) {
+	if (bench) {
+		_bench_run(TIMER_DURATION_USEC());
+	} else if (!params.testcases) {
 		Suite *s = suite_create("backfill");
 		SRunner *sr = srunner_create(s);
 		TCase *tc = tcase_create("backfill");
@@ -534,6 +877,7 @@ int main(int argc, char *argv[])
 		list_for_each(job_list, _print_job, &now);
 	}
 
+	_bench_remove_config();
 	_free_options();
 #endif
 	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -1,5 +1,7 @@
 /* Test of src/bitstring.c
  */
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <src/common/log.h>
 #include <src/common/bitstring.h>
@@ -254,6 +256,9 @@ START_TEST(test_bit_overlap)
 	bit_set(bs2,999);
 	ck_assert_msg(bit_overlap(bs, bs2) == 3, "bitstring");
 	ck_assert_msg(bit_overlap_any(bs, bs2) == 1, "bitstring any");
+	ck_assert_msg(bit_and_not_count(bs, bs2) == 2, "bitstring and_not");
+	ck_assert_msg(bit_and_not_count(bs2, bs) == (bit_set_count(bs2) - 3),
+		      "bitstring and_not");
 
 	bit_free(bs);
 	bit_free(bs2);
@@ -307,6 +312,102 @@ START_TEST(test_bit_ffs_from_bit)
 }
 END_TEST
 
+/*
+ * Microbenchmark of the word kernels against the portable word loops they
+ * replaced. Bitstrings are two header words followed by the bit words.
+ */
+#define BENCH_HDR 2
+
+static int64_t _bench_usec(struct timeval *start)
+{
+	struct timeval end;
+
+	gettimeofday(&end, NULL);
+	return ((end.tv_sec - start->tv_sec) * 1000000) +
+		(end.tv_usec - start->tv_usec);
+}
+
+__attribute__((noinline))
+static int32_t _ref_overlap(bitstr_t *b1, bitstr_t *b2, int64_t words)
+{
+	int32_t count = 0;
+
+	for (int64_t i = BENCH_HDR; i < (words + BENCH_HDR); i++)
+		count += __builtin_popcountll(b1[i] & b2[i]);
+	return count;
+}
+
+__attribute__((noinline))
+static int32_t _ref_set_count(bitstr_t *b, int64_t words)
+{
+	int32_t count = 0;
+
+	for (int64_t i = BENCH_HDR; i < (words + BENCH_HDR); i++)
+		count += __builtin_popcountll(b[i]);
+	return count;
+}
+
+__attribute__((noinline))
+static int _ref_super_set(bitstr_t *b1, bitstr_t *b2, int64_t words)
+{
+	for (int64_t i = BENCH_HDR; i < (words + BENCH_HDR); i++)
+		if (b1[i] & ~b2[i])
+			return 0;
+	return 1;
+}
+
+START_TEST(test_bit_kernels_bench)
+{
+	int sizes[] = { 1024, 16384, 262144 };
+
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		int nbits = sizes[s], words = nbits / 64;
+		int iters = (1 << 24) / nbits;
+		bitstr_t *b1 = bit_alloc(nbits), *b2 = bit_alloc(nbits);
+		int64_t sum_ref = 0, sum_new = 0, t_ref, t_new;
+		struct timeval start;
+
+		for (int i = 0; i < nbits; i++) {
+			if (random() & 1)
+				bit_set(b1, i);
+			if (random() & 1)
+				bit_set(b2, i);
+		}
+		ck_assert_int_eq(bit_overlap(b1, b2),
+				 _ref_overlap(b1, b2, words));
+		ck_assert_int_eq(bit_set_count(b1), _ref_set_count(b1, words));
+		bit_or(b2, b1);
+		ck_assert_int_eq(bit_super_set(b1, b2),
+				 _ref_super_set(b1, b2, words));
+
+		gettimeofday(&start, NULL);
+		for (int i = 0; i < iters; i++) {
+			/* Keep the compiler from hoisting the calls */
+			__asm__ __volatile__("" ::: "memory");
+			sum_ref += _ref_overlap(b1, b2, words) +
+				   _ref_set_count(b1, words) +
+				   _ref_super_set(b1, b2, words);
+		}
+		t_ref = _bench_usec(&start);
+
+		gettimeofday(&start, NULL);
+		for (int i = 0; i < iters; i++) {
+			__asm__ __volatile__("" ::: "memory");
+			sum_new += bit_overlap(b1, b2) + bit_set_count(b1) +
+				   bit_super_set(b1, b2);
+		}
+		t_new = _bench_usec(&start);
+
+		ck_assert(sum_ref == sum_new);
+		printf("%7d bits x %5d: overlap+set_count+super_set portable %6"PRId64" usec, kernels %6"PRId64" usec\n",
+		       nbits, iters, t_ref, t_new);
+
+		bit_free(b1);
+		bit_free(b2);
+	}
+}
+END_TEST
+
 int main(void)
 {
 	int number_failed;
@@ -328,6 +429,7 @@ int main(void)
 	tcase_add_test(tc_core, test_bit_overlap);
 	tcase_add_test(tc_core, test_bit_set_count_range);
 	tcase_add_test(tc_core, test_bit_ffs_from_bit);
+	tcase_add_test(tc_core, test_bit_kernels_bench);
 
 	suite_add_tcase(s, tc_core);
 
@@ -182,6 +182,22 @@ START_TEST(test_list_iteration)
 }
 END_TEST
 
+static data_for_each_cmd_t _check_dict_order(const char *key, data_t *data,
+					     void *arg)
+{
+	int64_t *next = arg;
+
+	if (data_get_int(data) != *next)
+		return DATA_FOR_EACH_FAIL;
+
+	/* Delete every 4th key while iterating */
+	*next += 2;
+	if (!(data_get_int(data) % 4))
+		return DATA_FOR_EACH_DELETE;
+
+	return DATA_FOR_EACH_CONT;
+}
+
 START_TEST(test_dict_iteration)
 {
 	int max;
@@ -237,6 +253,122 @@ START_TEST(test_dict_iteration)
 }
 END_TEST
 
+START_TEST(test_dict_large)
+{
+	const int count = 5000;
+	int64_t next = 0;
+	data_t *d = data_set_dict(data_new());
+
+	/* Enough keys to be indexed */
+	for (int i = 0; i < count; i++)
+		data_set_int(data_key_set_int(d, i), i);
+	ck_assert_msg(data_get_dict_length(d) == count, "dict cardinality");
+
+	/* Existing key is not duplicated */
+	data_set_int(data_key_set_int(d, 42), 42);
+	ck_assert_msg(data_get_dict_length(d) == count, "dict cardinality");
+
+	for (int i = 0; i < count; i++) {
+		data_t *v = data_key_get_int(d, i);
+
+		ck_assert_msg(v && (data_get_int(v) == i), "key lookup");
+	}
+	ck_assert_msg(!data_key_get(d, "missing"), "missing key");
+
+	/* Remove odd keys */
+	for (int i = 1; i < count; i += 2) {
+		char key[32];
+
+		snprintf(key, sizeof(key), "%d", i);
+		ck_assert_msg(data_key_unset(d, key), "unset key");
+		ck_assert_msg(!data_key_unset(d, key), "unset removed key");
+	}
+	ck_assert_msg(data_get_dict_length(d) == (count / 2),
+		      "dict cardinality");
+
+	for (int i = 0; i < count; i++) {
+		data_t *v = data_key_get_int(d, i);
+
+		if (i % 2)
+			ck_assert_msg(!v, "removed key lookup");
+		else
+			ck_assert_msg(v && (data_get_int(v) == i),
+				      "kept key lookup");
+	}
+
+	/* Insertion order is kept */
+	ck_assert_msg(data_dict_for_each(d, _check_dict_order, &next) ==
+		      (count / 2), "dict order");
+
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
+START_TEST(test_arena)
+{
+	const int count = 5000;
+	int64_t next = 0;
+	char *big = xmalloc(100000);
+	data_arena_t *arena = data_arena_new();
+	data_arena_t *prior = data_arena_set(arena);
+	data_t *d = data_set_dict(data_new());
+	data_t *l = data_set_list(data_key_set(d, "list"));
+	data_t *heap, *moved;
+
+	ck_assert_msg(!prior, "no prior arena");
+
+	/* Children follow the arena of their parent */
+	ck_assert_msg(data_arena_set(prior) == arena, "restore arena");
+
+	for (int i = 0; i < count; i++) {
+		char *str = xstrdup_printf("long string value %d", i);
+
+		data_set_string_own(data_list_append(l), str);
+		data_set_int(data_key_set_int(d, (i * 2)), (i * 2));
+	}
+
+	memset(big, 'x', 99999);
+	data_set_string(data_key_set(d, "big"), big);
+	ck_assert_msg(!xstrcmp(data_get_string(data_key_get(d, "big")), big),
+		      "large string");
+	xfree(big);
+
+	ck_assert_msg(data_get_list_length(l) == count, "list cardinality");
+	ck_assert_msg(data_get_dict_length(d) == (count + 2),
+		      "dict cardinality");
+	ck_assert_msg(data_key_unset(d, "big"), "unset key");
+	data_free(data_list_dequeue(l));
+
+	for (int i = 0; i < count; i++) {
+		data_t *v = data_key_get_int(d, (i * 2));
+
+		ck_assert_msg(v && (data_get_int(v) == (i * 2)), "key lookup");
+		ck_assert_msg(!data_key_get_int(d, ((i * 2) + 1)),
+			      "missing key");
+	}
+	ck_assert_msg(!xstrcmp(data_get_string(data_get_list_last(l)),
+			       "long string value 4999"), "list string");
+
+	/* Moving between heap and arena keeps both trees intact */
+	heap = data_new();
+	data_move(heap, l);
+	ck_assert_msg(data_get_type(l) == DATA_TYPE_NULL, "moved from");
+	ck_assert_msg(data_get_list_length(heap) == (count - 1),
+		      "moved list cardinality");
+	moved = data_move(data_key_set(d, "list"), heap);
+	ck_assert_msg(data_get_list_length(moved) == (count - 1),
+		      "moved back list cardinality");
+	FREE_NULL_DATA(heap);
+
+	ck_assert_msg(data_key_unset(d, "list"), "unset key");
+	ck_assert_msg(data_dict_for_each(d, _check_dict_order, &next) ==
+		      count, "dict order");
+
+	FREE_NULL_DATA(d);
+	FREE_NULL_DATA_ARENA(arena);
+}
+END_TEST
+
 START_TEST(test_dict_typeset)
 {
 	data_t *d = data_new();
@@ -423,6 +555,8 @@ Suite *suite_data(void)
 	tcase_add_test(tc_core, test_detection);
 	tcase_add_test(tc_core, test_dict_typeset);
 	tcase_add_test(tc_core, test_dict_iteration);
+	tcase_add_test(tc_core, test_dict_large);
+	tcase_add_test(tc_core, test_arena);
 	tcase_add_test(tc_core, test_list_iteration);
 	tcase_add_test(tc_core, test_convert_list_dict);
 
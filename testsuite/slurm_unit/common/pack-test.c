@@ -81,6 +81,92 @@ START_TEST(test_pack)
 }
 END_TEST
 
+START_TEST(test_pack_compact)
+{
+	buf_t *buffer = init_buf(0);
+	uint16_t out16;
+	uint32_t out32, size;
+	uint64_t out64;
+	time_t out_time;
+	char *outstr = NULL, *outptr = NULL;
+	char *names[] = { "debug", "batch", "debug", NULL, "", "batch" };
+	uint32_t fixed_size;
+
+	pack32(0, buffer);
+	buf_set_compact(buffer, true);
+	pack16(NO_VAL16, buffer);
+	pack16(1234, buffer);
+	pack32(NO_VAL, buffer);
+	pack32(INFINITE, buffer);
+	pack32(0, buffer);
+	pack32(0xfffffffd, buffer);
+	pack64(NO_VAL64, buffer);
+	pack64(1ULL << 40, buffer);
+	pack_time(0, buffer);
+	pack_time(-1, buffer);
+	pack_time(1700000000, buffer);
+	for (int i = 0; i < ARRAY_SIZE(names); i++)
+		packstr(names[i], buffer);
+	buf_clear_compact(buffer);
+	pack32(5678, buffer);
+
+	/* 4 + 1+2 + 1+1+1+5 + 1+6 + 1+1+5 + 7+7+1+1+2+1 + 4 */
+	ck_assert_int_eq(get_buf_offset(buffer), 52);
+
+	fixed_size = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, 0);
+	buf_set_compact(buffer, true);
+	ck_assert(!unpack16(&out16, buffer));
+	ck_assert_uint_eq(out16, NO_VAL16);
+	ck_assert(!unpack16(&out16, buffer));
+	ck_assert_uint_eq(out16, 1234);
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, NO_VAL);
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, INFINITE);
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, 0);
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, 0xfffffffd);
+	ck_assert(!unpack64(&out64, buffer));
+	ck_assert(out64 == NO_VAL64);
+	ck_assert(!unpack64(&out64, buffer));
+	ck_assert(out64 == (1ULL << 40));
+	ck_assert(!unpack_time(&out_time, buffer));
+	ck_assert_int_eq(out_time, 0);
+	ck_assert(!unpack_time(&out_time, buffer));
+	ck_assert_int_eq(out_time, -1);
+	ck_assert(!unpack_time(&out_time, buffer));
+	ck_assert_int_eq(out_time, 1700000000);
+	for (int i = 0; i < (ARRAY_SIZE(names) - 1); i++) {
+		ck_assert(!unpackstr_xmalloc(&outstr, &size, buffer));
+		ck_assert_str_eq((names[i] ? names[i] : "(null)"),
+				 (outstr ? outstr : "(null)"));
+		xfree(outstr);
+	}
+	/* references resolve to the first copy */
+	ck_assert(!unpackmem_ptr(&outptr, &size, buffer));
+	ck_assert_str_eq(outptr, "batch");
+	ck_assert_uint_eq(size, 6);
+	buf_clear_compact(buffer);
+	ck_assert(!unpack32(&out32, buffer));
+	ck_assert_uint_eq(out32, 5678);
+	ck_assert_uint_eq(get_buf_offset(buffer), fixed_size);
+
+	/* references need the string table */
+	set_buf_offset(buffer, (4 + 3 + 8 + 7 + 7 + 7 + 7));
+	buf_set_compact(buffer, false);
+	ck_assert(unpackstr_xmalloc(&outstr, &size, buffer));
+	ck_assert(!outstr);
+	buf_clear_compact(buffer);
+
+	free_buf(buffer);
+}
+END_TEST
+
 int main(void)
 {
 	int number_failed;
@@ -93,6 +179,7 @@ int main(void)
 	TCase *tc_core = tcase_create("pack");
 
 	tcase_add_test(tc_core, test_pack);
+	tcase_add_test(tc_core, test_pack_compact);
 
 	suite_add_tcase(s, tc_core);
 